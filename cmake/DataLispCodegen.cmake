@@ -0,0 +1,51 @@
+# Generates a header with typed views of all groups described by a DataLisp schema
+# and adds it to the sources of the given target.
+#
+#   DL_GENERATE_VIEWS(<target> <schema>
+#                     [NAMESPACE <namespace>]
+#                     [OUTPUT <header>]
+#                     [INCLUDE_PREFIX <prefix>])
+#
+# The header is named after the schema, e.g. scene.h for scene.dl, and written to the current binary directory
+# if no OUTPUT is given. Its directory is added to the include directories of the target.
+# INCLUDE_PREFIX is prepended to the included DataLisp headers, use DL/ for an installed library.
+# The generator is dl_codegen of this project, or the executable given by DL_CODEGEN_EXECUTABLE.
+# The header is only rewritten if its content changed, a stamp file next to it tracks the schema. Requires CMake 3.2.
+include(CMakeParseArguments)
+
+FUNCTION(DL_GENERATE_VIEWS target schema)
+  cmake_parse_arguments(VIEWS "" "NAMESPACE;OUTPUT;INCLUDE_PREFIX" "" ${ARGN})
+
+  get_filename_component(schema_path ${schema} ABSOLUTE)
+  IF(NOT VIEWS_OUTPUT)
+    get_filename_component(schema_name ${schema} NAME_WE)
+    SET(VIEWS_OUTPUT ${schema_name}.h)
+  ENDIF()
+  get_filename_component(output_path ${VIEWS_OUTPUT} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_BINARY_DIR})
+  get_filename_component(output_dir ${output_path} DIRECTORY)
+
+  SET(generator dl_codegen)
+  IF(DL_CODEGEN_EXECUTABLE)
+    SET(generator ${DL_CODEGEN_EXECUTABLE})
+  ENDIF()
+
+  SET(arguments)
+  IF(VIEWS_NAMESPACE)
+    list(APPEND arguments --namespace ${VIEWS_NAMESPACE})
+  ENDIF()
+  IF(VIEWS_INCLUDE_PREFIX)
+    list(APPEND arguments --include-prefix ${VIEWS_INCLUDE_PREFIX})
+  ENDIF()
+
+  # The generator keeps an unchanged header untouched, the stamp records the last run instead
+  SET(stamp_path ${output_path}.stamp)
+  add_custom_command(OUTPUT ${stamp_path}
+    BYPRODUCTS ${output_path}
+    COMMAND ${generator} ${arguments} ${schema_path} ${output_path}
+    COMMAND ${CMAKE_COMMAND} -E touch ${stamp_path}
+    DEPENDS ${schema_path} ${generator}
+    COMMENT "Generating views of ${schema}" VERBATIM)
+
+  target_sources(${target} PRIVATE ${stamp_path} ${output_path})
+  target_include_directories(${target} PRIVATE ${output_dir})
+ENDFUNCTION(DL_GENERATE_VIEWS)
@@ -0,0 +1,697 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Binary.h"
+#include "DataContainer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_set>
+
+#if defined(DL_OS_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace DL {
+constexpr char BINARY_MAGIC[4]	= { 'D', 'L', 'B', '\0' };
+constexpr uint32 BINARY_VERSION = 1;
+constexpr uint32 BINARY_ENDIAN	= 0x01020304;
+
+struct DL_INTERNAL_LIB BinaryHeader {
+	char Magic[4];
+	uint32 Version;
+	uint32 Endian;
+	uint32 TopGroupCount;
+	uint64 StringTableOffset;
+	uint64 StringTableSize;
+	uint64 TopGroupsOffset; // Array of absolute group offsets
+	uint64 FileSize;
+};
+
+struct DL_INTERNAL_LIB BinaryValueRecord {
+	uint8 Type;
+	uint8 Reserved[3];
+	uint32 Key; // Relative to the string table
+	union {
+		Integer IntValue;
+		Float FloatValue;
+		uint8 BoolValue;
+		uint64 Offset; // Relative to the string table for strings, absolute for groups
+	};
+};
+
+// Followed by the anonymous values, the named values and the sorted key index
+struct DL_INTERNAL_LIB BinaryGroupRecord {
+	uint32 ID;
+	uint32 AnonymousCount;
+	uint32 NamedCount;
+	uint32 Reserved;
+};
+
+static_assert(sizeof(BinaryHeader) == 48, "Invalid header layout");
+static_assert(sizeof(BinaryValueRecord) == 16, "Invalid value layout");
+static_assert(sizeof(BinaryGroupRecord) == 16, "Invalid group layout");
+
+static inline size_t align8(size_t s) { return (s + 7) & ~size_t(7); }
+
+static inline const BinaryHeader* header(const char* base)
+{
+	return reinterpret_cast<const BinaryHeader*>(base);
+}
+
+static inline BinaryString stringAt(const char* base, uint64 offset)
+{
+	const char* ptr = base + header(base)->StringTableOffset + offset;
+	uint32 length;
+	std::memcpy(&length, ptr, sizeof(length));
+	return BinaryString{ ptr + sizeof(uint32), length };
+}
+
+static inline const BinaryValueRecord* values(const BinaryGroupRecord* grp)
+{
+	return reinterpret_cast<const BinaryValueRecord*>(grp + 1);
+}
+
+static inline const uint32* keyIndex(const BinaryGroupRecord* grp)
+{
+	return reinterpret_cast<const uint32*>(values(grp) + grp->AnonymousCount + grp->NamedCount);
+}
+
+static inline uint64 groupSize(uint64 anonymousCount, uint64 namedCount)
+{
+	return (sizeof(BinaryGroupRecord) + (anonymousCount + namedCount) * sizeof(BinaryValueRecord) + namedCount * sizeof(uint32) + 7) & ~uint64(7);
+}
+
+// Byte-wise order used for the key index
+static inline int compareKeys(const char* a, size_t aLength, const char* b, size_t bLength)
+{
+	const int r = std::memcmp(a, b, std::min(aLength, bLength));
+	if (r != 0)
+		return r;
+	return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+}
+
+//---------------------------------------------------
+class DL_INTERNAL_LIB BinaryWriter {
+public:
+	bool write(const DataContainer& container, std::ostream& stream)
+	{
+		addString(string_t());
+		for (const DataGroup& grp : container.getTopGroups())
+			collect(grp);
+
+		mOut.assign(sizeof(BinaryHeader), '\0');
+		mOut += mTable;
+		mOut.resize(align8(mOut.size()), '\0');
+
+		vector_t<uint64> topGroups;
+		topGroups.reserve(container.getTopGroups().size());
+		for (const DataGroup& grp : container.getTopGroups())
+			topGroups.push_back(writeGroup(grp));
+
+		const uint64 topGroupsOffset = mOut.size();
+		mOut.append(reinterpret_cast<const char*>(topGroups.data()), topGroups.size() * sizeof(uint64));
+
+		BinaryHeader hdr;
+		std::memcpy(hdr.Magic, BINARY_MAGIC, sizeof(hdr.Magic));
+		hdr.Version			  = BINARY_VERSION;
+		hdr.Endian			  = BINARY_ENDIAN;
+		hdr.TopGroupCount	  = static_cast<uint32>(topGroups.size());
+		hdr.StringTableOffset = sizeof(BinaryHeader);
+		hdr.StringTableSize	  = mTable.size();
+		hdr.TopGroupsOffset	  = topGroupsOffset;
+		hdr.FileSize		  = mOut.size();
+		std::memcpy(&mOut[0], &hdr, sizeof(hdr));
+
+		stream.write(mOut.data(), mOut.size());
+		return stream.good();
+	}
+
+private:
+	uint32 addString(const string_t& str)
+	{
+		auto it = mStrings.find(str);
+		if (it != mStrings.end())
+			return it->second;
+
+		const uint32 offset = static_cast<uint32>(mTable.size());
+		const uint32 length = static_cast<uint32>(str.size());
+		mTable.append(reinterpret_cast<const char*>(&length), sizeof(length));
+		mTable += str;
+		mTable.push_back('\0');
+		mTable.resize((mTable.size() + 3) & ~size_t(3), '\0');
+
+		mStrings[str] = offset;
+		return offset;
+	}
+
+	void collect(const DataGroup& grp)
+	{
+		addString(grp.id());
+		for (const Data& d : grp.getAnonymousEntries())
+			collect(d);
+		for (const Data& d : grp.getNamedEntries())
+			collect(d);
+	}
+
+	void collect(const Data& d)
+	{
+		addString(d.key());
+		if (d.type() == DT_String)
+			addString(d.getString());
+		else if (d.type() == DT_Group)
+			collect(d.getGroup());
+	}
+
+	BinaryValueRecord makeValue(const Data& d, uint64 groupOffset)
+	{
+		BinaryValueRecord r;
+		std::memset(&r, 0, sizeof(r));
+		r.Type = static_cast<uint8>(d.type());
+		r.Key  = mStrings.at(d.key());
+
+		switch (d.type()) {
+		case DT_Group:
+			r.Offset = groupOffset;
+			break;
+		case DT_Integer:
+			r.IntValue = d.getInt();
+			break;
+		case DT_Float:
+			r.FloatValue = d.getFloat();
+			break;
+		case DT_Bool:
+			r.BoolValue = d.getBool() ? 1 : 0;
+			break;
+		case DT_String:
+			r.Offset = mStrings.at(d.getString());
+			break;
+		case DT_None:
+			break;
+		}
+		return r;
+	}
+
+	// Children are written first, so every group only refers to previous offsets
+	uint64 writeGroup(const DataGroup& grp)
+	{
+		const vector_t<Data>& anonymous = grp.getAnonymousEntries();
+		const vector_t<Data>& named		= grp.getNamedEntries();
+
+		vector_t<BinaryValueRecord> records;
+		records.reserve(anonymous.size() + named.size());
+		for (const Data& d : anonymous)
+			records.push_back(makeValue(d, d.type() == DT_Group ? writeGroup(d.getGroup()) : 0));
+		for (const Data& d : named)
+			records.push_back(makeValue(d, d.type() == DT_Group ? writeGroup(d.getGroup()) : 0));
+
+		vector_t<uint32> index(named.size());
+		for (size_t i = 0; i < index.size(); ++i)
+			index[i] = static_cast<uint32>(i);
+		std::stable_sort(index.begin(), index.end(), [&](uint32 a, uint32 b) {
+			const string_t& ka = named[a].key();
+			const string_t& kb = named[b].key();
+			return compareKeys(ka.data(), ka.size(), kb.data(), kb.size()) < 0;
+		});
+
+		BinaryGroupRecord r;
+		r.ID			 = mStrings.at(grp.id());
+		r.AnonymousCount = static_cast<uint32>(anonymous.size());
+		r.NamedCount	 = static_cast<uint32>(named.size());
+		r.Reserved		 = 0;
+
+		const uint64 offset = mOut.size();
+		mOut.append(reinterpret_cast<const char*>(&r), sizeof(r));
+		mOut.append(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BinaryValueRecord));
+		mOut.append(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(uint32));
+		mOut.resize(align8(mOut.size()), '\0');
+
+		return offset;
+	}
+
+	map_t<string_t, uint32> mStrings;
+	string_t mTable;
+	string_t mOut;
+};
+
+//---------------------------------------------------
+BinaryData::BinaryData()
+	: mBase(nullptr)
+	, mRecord(nullptr)
+{
+}
+
+BinaryData::BinaryData(const char* base, const void* record)
+	: mBase(base)
+	, mRecord(reinterpret_cast<const BinaryValueRecord*>(record))
+{
+}
+
+BinaryString BinaryData::key() const
+{
+	DL_ASSERT(mRecord);
+	return stringAt(mBase, mRecord->Key);
+}
+
+DataType BinaryData::type() const
+{
+	return mRecord ? static_cast<DataType>(mRecord->Type) : DT_None;
+}
+
+Integer BinaryData::getInt() const
+{
+	DL_ASSERT(type() == DT_Integer);
+	return mRecord->IntValue;
+}
+
+Float BinaryData::getFloat() const
+{
+	DL_ASSERT(type() == DT_Float);
+	return mRecord->FloatValue;
+}
+
+Float BinaryData::getNumber() const
+{
+	DL_ASSERT(isNumber());
+	return type() == DT_Float ? mRecord->FloatValue : static_cast<Float>(mRecord->IntValue);
+}
+
+bool BinaryData::getBool() const
+{
+	DL_ASSERT(type() == DT_Bool);
+	return mRecord->BoolValue != 0;
+}
+
+BinaryString BinaryData::getString() const
+{
+	DL_ASSERT(type() == DT_String);
+	return stringAt(mBase, mRecord->Offset);
+}
+
+BinaryGroup BinaryData::getGroup() const
+{
+	DL_ASSERT(type() == DT_Group);
+	return BinaryGroup(mBase, mBase + mRecord->Offset);
+}
+
+Data BinaryData::toData() const
+{
+	if (!mRecord)
+		return Data();
+
+	const string_t k = key().str();
+	switch (type()) {
+	case DT_Group:
+		return Data(k, getGroup().toGroup());
+	case DT_Integer:
+		return Data(k, getInt());
+	case DT_Float:
+		return Data(k, getFloat());
+	case DT_Bool:
+		return Data(k, getBool());
+	case DT_String:
+		return Data(k, getString().str());
+	default:
+		return Data(k);
+	}
+}
+
+//---------------------------------------------------
+BinaryGroup::BinaryGroup()
+	: mBase(nullptr)
+	, mRecord(nullptr)
+{
+}
+
+BinaryGroup::BinaryGroup(const char* base, const void* record)
+	: mBase(base)
+	, mRecord(reinterpret_cast<const BinaryGroupRecord*>(record))
+{
+}
+
+BinaryString BinaryGroup::id() const
+{
+	DL_ASSERT(mRecord);
+	return stringAt(mBase, mRecord->ID);
+}
+
+bool BinaryGroup::isArray() const
+{
+	return id().Length == 0;
+}
+
+size_t BinaryGroup::anonymousCount() const
+{
+	return mRecord ? mRecord->AnonymousCount : 0;
+}
+
+size_t BinaryGroup::namedCount() const
+{
+	return mRecord ? mRecord->NamedCount : 0;
+}
+
+BinaryData BinaryGroup::at(size_t i) const
+{
+	if (i < anonymousCount())
+		return BinaryData(mBase, values(mRecord) + i);
+	else
+		return BinaryData();
+}
+
+BinaryData BinaryGroup::namedAt(size_t i) const
+{
+	if (i < namedCount())
+		return BinaryData(mBase, values(mRecord) + mRecord->AnonymousCount + i);
+	else
+		return BinaryData();
+}
+
+BinaryData BinaryGroup::getFromKey(const string_t& key) const
+{
+	if (!mRecord)
+		return BinaryData();
+
+	const BinaryValueRecord* named = values(mRecord) + mRecord->AnonymousCount;
+	const uint32* index			   = keyIndex(mRecord);
+
+	// Lower bound, the index is stable sorted therefor the first occurrence is found
+	size_t first = 0;
+	size_t count = mRecord->NamedCount;
+	while (count > 0) {
+		const size_t step	= count / 2;
+		const BinaryString k = stringAt(mBase, named[index[first + step]].Key);
+		if (compareKeys(k.Chars, k.Length, key.data(), key.size()) < 0) {
+			first += step + 1;
+			count -= step + 1;
+		} else {
+			count = step;
+		}
+	}
+
+	if (first < mRecord->NamedCount && stringAt(mBase, named[index[first]].Key) == key)
+		return BinaryData(mBase, named + index[first]);
+	else
+		return BinaryData();
+}
+
+// Groups share their content, therefor children are filled after being added to their parent
+struct DL_INTERNAL_LIB BinaryCopyFrame {
+	BinaryGroup Source;
+	DataGroup Target;
+};
+
+DataGroup BinaryGroup::toGroup() const
+{
+	if (!mRecord)
+		return DataGroup();
+
+	// An explicit stack is used, so deep hierarchies are not copied recursively
+	DataGroup root(id().str());
+	vector_t<BinaryCopyFrame> stack;
+	stack.push_back(BinaryCopyFrame{ *this, root });
+	while (!stack.empty()) {
+		BinaryCopyFrame frame = std::move(stack.back());
+		stack.pop_back();
+
+		const size_t anonymous = frame.Source.anonymousCount();
+		const size_t count	   = anonymous + frame.Source.namedCount();
+		for (size_t i = 0; i < count; ++i) {
+			const BinaryData d = i < anonymous ? frame.Source.at(i) : frame.Source.namedAt(i - anonymous);
+			if (d.type() != DT_Group) {
+				frame.Target.add(d.toData());
+				continue;
+			}
+
+			const BinaryGroup child = d.getGroup();
+			DataGroup grp(child.id().str());
+			frame.Target.add(Data(d.key().str(), grp));
+			stack.push_back(BinaryCopyFrame{ child, std::move(grp) });
+		}
+	}
+
+	return root;
+}
+
+//---------------------------------------------------
+BinaryContainer::BinaryContainer()
+	: mData(nullptr)
+	, mSize(0)
+	, mMapping(nullptr)
+{
+}
+
+BinaryContainer::~BinaryContainer()
+{
+	close();
+}
+
+bool BinaryContainer::open(const string_t& path)
+{
+	close();
+
+#if defined(DL_OS_WINDOWS)
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+
+	const void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!ptr) {
+		CloseHandle(mapping);
+		return false;
+	}
+
+	if (!load(reinterpret_cast<const char*>(ptr), static_cast<size_t>(size.QuadPart))) {
+		UnmapViewOfFile(ptr);
+		CloseHandle(mapping);
+		return false;
+	}
+	mMapping = mapping;
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+
+	void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (ptr == MAP_FAILED)
+		return false;
+
+	if (!load(reinterpret_cast<const char*>(ptr), static_cast<size_t>(st.st_size))) {
+		munmap(ptr, static_cast<size_t>(st.st_size));
+		return false;
+	}
+	mMapping = ptr;
+#endif
+
+	return true;
+}
+
+bool BinaryContainer::load(const char* data, size_t size)
+{
+	// The mapping is set by open() after the content was accepted
+	close();
+
+	if (!data || size < sizeof(BinaryHeader) || (reinterpret_cast<uintptr_t>(data) & 7) != 0)
+		return false;
+
+	const BinaryHeader* hdr = header(data);
+	if (std::memcmp(hdr->Magic, BINARY_MAGIC, sizeof(hdr->Magic)) != 0
+		|| hdr->Version != BINARY_VERSION
+		|| hdr->Endian != BINARY_ENDIAN
+		|| hdr->FileSize != size
+		|| hdr->StringTableOffset > size
+		|| hdr->StringTableSize > size - hdr->StringTableOffset
+		|| (hdr->TopGroupsOffset & 7) != 0
+		|| hdr->TopGroupsOffset > size
+		|| hdr->TopGroupCount > (size - hdr->TopGroupsOffset) / sizeof(uint64))
+		return false;
+
+	mData = data;
+	mSize = size;
+	return true;
+}
+
+void BinaryContainer::close()
+{
+	if (mMapping) {
+#if defined(DL_OS_WINDOWS)
+		UnmapViewOfFile(mData);
+		CloseHandle(reinterpret_cast<HANDLE>(mMapping));
+#else
+		munmap(mMapping, mSize);
+#endif
+	}
+
+	mMapping = nullptr;
+	mData	 = nullptr;
+	mSize	 = 0;
+}
+
+bool BinaryContainer::verify() const
+{
+	if (!mData)
+		return false;
+
+	// All bounds are checked by subtraction from the limit, so crafted offsets can not wrap around.
+	// load() already ensured the string table and the top group offsets are inside the content
+	const BinaryHeader* hdr	 = header(mData);
+	const uint64 tableSize	 = hdr->StringTableSize;
+	const uint64 groupsBegin = align8(hdr->StringTableOffset + tableSize);
+
+	auto validString = [&](uint64 offset) {
+		if ((offset & 3) != 0 || offset > tableSize || tableSize - offset < sizeof(uint32) + 1)
+			return false;
+		const BinaryString str = stringAt(mData, offset);
+		return str.Length < tableSize - offset - sizeof(uint32) && str.Chars[str.Length] == '\0';
+	};
+
+	auto validGroup = [&](uint64 offset, uint64 limit) {
+		if ((offset & 7) != 0 || offset < groupsBegin || offset > limit || sizeof(BinaryGroupRecord) > limit - offset)
+			return false;
+		const BinaryGroupRecord* grp = reinterpret_cast<const BinaryGroupRecord*>(mData + offset);
+		return groupSize(grp->AnonymousCount, grp->NamedCount) <= limit - offset && validString(grp->ID);
+	};
+
+	// Children always precede their parents, so offsets strictly decrease while descending.
+	// Every group has to be referenced only once, shared children would expand exponentially
+	std::unordered_set<uint64> visited;
+	auto visit = [&](uint64 offset) { return visited.insert(offset).second; };
+
+	vector_t<uint64> stack;
+	const uint64* top = reinterpret_cast<const uint64*>(mData + hdr->TopGroupsOffset);
+	for (uint32 i = 0; i < hdr->TopGroupCount; ++i) {
+		if (!validGroup(top[i], hdr->TopGroupsOffset) || !visit(top[i]))
+			return false;
+		stack.push_back(top[i]);
+	}
+
+	while (!stack.empty()) {
+		const uint64 offset = stack.back();
+		stack.pop_back();
+
+		const BinaryGroupRecord* grp = reinterpret_cast<const BinaryGroupRecord*>(mData + offset);
+		const BinaryValueRecord* val = values(grp);
+		const uint64 count			 = uint64(grp->AnonymousCount) + grp->NamedCount;
+		for (uint64 j = 0; j < count; ++j) {
+			if (!validString(val[j].Key) || (j < grp->AnonymousCount) != (stringAt(mData, val[j].Key).Length == 0))
+				return false;
+
+			switch (val[j].Type) {
+			case DT_Group:
+				if (!validGroup(val[j].Offset, offset) || !visit(val[j].Offset))
+					return false;
+				stack.push_back(val[j].Offset);
+				break;
+			case DT_String:
+				if (!validString(val[j].Offset))
+					return false;
+				break;
+			case DT_Integer:
+			case DT_Float:
+			case DT_Bool:
+				break;
+			default:
+				return false;
+			}
+		}
+
+		const uint32* index = keyIndex(grp);
+		for (uint32 j = 0; j < grp->NamedCount; ++j) {
+			if (index[j] >= grp->NamedCount)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+size_t BinaryContainer::topGroupCount() const
+{
+	return mData ? header(mData)->TopGroupCount : 0;
+}
+
+BinaryGroup BinaryContainer::topGroup(size_t i) const
+{
+	if (i >= topGroupCount())
+		return BinaryGroup();
+
+	const uint64* top = reinterpret_cast<const uint64*>(mData + header(mData)->TopGroupsOffset);
+	return BinaryGroup(mData, mData + top[i]);
+}
+
+void BinaryContainer::toContainer(DataContainer& container) const
+{
+	for (size_t i = 0; i < topGroupCount(); ++i)
+		container.addTopGroup(topGroup(i).toGroup());
+}
+
+bool BinaryContainer::write(const DataContainer& container, std::ostream& stream)
+{
+	BinaryWriter writer;
+	return writer.write(container, stream);
+}
+
+bool BinaryContainer::write(const DataContainer& container, const string_t& path)
+{
+	std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream)
+		return false;
+
+	if (!write(container, stream))
+		return false;
+
+	// Errors while flushing are only visible after closing
+	stream.close();
+	return !stream.fail();
+}
+} // namespace DL
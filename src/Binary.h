@@ -0,0 +1,243 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Data.h"
+
+#include <ostream>
+
+namespace DL {
+class DataContainer;
+class BinaryGroup;
+
+/** @file Binary.h DL/Binary.h
+ * @brief Compiled binary representation (.dlb) of a DataContainer
+ *
+ * The format consists of a header, a string table with all keys, ids and strings
+ * and the group records. Every group record contains its anonymous and named values
+ * followed by an index of the named values sorted by key.<br>
+ * All records are stored in native byte order and aligned,
+ * therefor a file can be mapped into memory and read without any parsing.
+ */
+
+/** @class BinaryString Binary.h DL/Binary.h
+ * @brief Read-only view of a string inside a binary container
+ *
+ * The characters are always null-terminated.
+ */
+struct DL_LIB BinaryString {
+	const char* Chars;
+	uint32 Length;
+
+	/**
+	 * @brief Copies the characters into a string
+	 */
+	inline string_t str() const { return string_t(Chars, Length); }
+
+	inline bool operator==(const string_t& other) const { return other.size() == Length && other.compare(0, Length, Chars, Length) == 0; }
+	inline bool operator!=(const string_t& other) const { return !(*this == other); }
+};
+
+/** @class BinaryData Binary.h DL/Binary.h
+ * @brief Read-only view of a data entry inside a binary container
+ * @see Data
+ */
+class DL_LIB BinaryData {
+public:
+	/**
+	 * @brief Constructs an invalid view
+	 */
+	BinaryData();
+	BinaryData(const char* base, const void* record);
+
+	BinaryString key() const;
+	DataType type() const;
+	inline bool isValid() const { return type() != DT_None; }
+	inline bool isNumber() const { return type() == DT_Integer || type() == DT_Float; }
+
+	Integer getInt() const;
+	Float getFloat() const;
+	Float getNumber() const;
+	bool getBool() const;
+	BinaryString getString() const;
+	BinaryGroup getGroup() const;
+
+	/**
+	 * @brief Copies the viewed data including all its children
+	 */
+	Data toData() const;
+
+private:
+	const char* mBase;
+	const struct BinaryValueRecord* mRecord;
+};
+
+/** @class BinaryGroup Binary.h DL/Binary.h
+ * @brief Read-only view of a group inside a binary container
+ * @see DataGroup
+ */
+class DL_LIB BinaryGroup {
+public:
+	/**
+	 * @brief Constructs an invalid view
+	 */
+	BinaryGroup();
+	BinaryGroup(const char* base, const void* record);
+
+	inline bool isValid() const { return mRecord != nullptr; }
+
+	BinaryString id() const;
+	bool isArray() const;
+
+	size_t anonymousCount() const;
+	size_t namedCount() const;
+
+	/**
+	 * @brief Returns anonymous data from position i
+	 * @return View at position i if available, invalid view otherwise
+	 */
+	BinaryData at(size_t i) const;
+
+	/**
+	 * @brief Returns named data from position i in original order
+	 * @return View at position i if available, invalid view otherwise
+	 */
+	BinaryData namedAt(size_t i) const;
+
+	/**
+	 * @brief Returns non anonymous data with the given id
+	 *
+	 * Uses the precomputed key index, therefor the lookup is logarithmic.
+	 * If more than one data has the same id. The first one will be returned.
+	 * @return View of the data if available, invalid view otherwise
+	 */
+	BinaryData getFromKey(const string_t& key) const;
+
+	/**
+	 * @brief Copies the viewed group including all its children
+	 */
+	DataGroup toGroup() const;
+
+private:
+	const char* mBase;
+	const struct BinaryGroupRecord* mRecord;
+};
+
+/** @class BinaryContainer Binary.h DL/Binary.h
+ * @brief Read-only container mapped from a compiled binary file
+ *
+ * @subsection Example
+ * @code{.cpp}
+ * DL::BinaryContainer binary;
+ * if (binary.open("config.dlb")) {
+ *   DL::BinaryGroup grp = binary.topGroup(0);
+ *   DL::Float steps = grp.getFromKey("steps").getNumber();
+ * }
+ * @endcode
+ * @attention Views are only valid as long as the container is open.
+ */
+class DL_LIB BinaryContainer {
+public:
+	BinaryContainer();
+	~BinaryContainer();
+
+	BinaryContainer(const BinaryContainer& other) = delete;
+	BinaryContainer& operator=(const BinaryContainer& other) = delete;
+
+	/**
+	 * @brief Maps the given file into memory
+	 *
+	 * Only the header is checked. Use @link verify @endlink for files from untrusted sources.
+	 * @return True if successful
+	 */
+	bool open(const string_t& path);
+
+	/**
+	 * @brief Uses the given memory block as the binary content
+	 *
+	 * The memory block is not copied and has to stay valid as long as the container is open.
+	 * It has to be aligned to at least 8 bytes.
+	 * @return True if successful
+	 */
+	bool load(const char* data, size_t size);
+
+	/**
+	 * @brief Unmaps the content. All views get invalid
+	 */
+	void close();
+
+	/**
+	 * @brief Returns true if content is available
+	 */
+	inline bool isOpen() const { return mData != nullptr; }
+
+	/**
+	 * @brief Checks all records and offsets of the content
+	 *
+	 * Groups have to precede their parent and may only be referenced once.
+	 * @return True if the content is well-formed
+	 */
+	bool verify() const;
+
+	/**
+	 * @brief Amount of groups on top of the hierarchy
+	 */
+	size_t topGroupCount() const;
+
+	/**
+	 * @brief Returns group on top of the hierarchy from position i
+	 * @return View of the group if available, invalid view otherwise
+	 */
+	BinaryGroup topGroup(size_t i) const;
+
+	/**
+	 * @brief Copies all top groups into the given container
+	 * @param container The container to fill. Will not be cleared!
+	 */
+	void toContainer(DataContainer& container) const;
+
+	/**
+	 * @brief Writes a container in the binary format
+	 * @return True if successful
+	 */
+	static bool write(const DataContainer& container, std::ostream& stream);
+
+	/**
+	 * @brief Writes a container in the binary format to the given file
+	 * @return True if successful
+	 */
+	static bool write(const DataContainer& container, const string_t& path);
+
+private:
+	const char* mData;
+	size_t mSize;
+	void* mMapping;
+};
+} // namespace DL
@@ -0,0 +1,405 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataContainer.h"
+#include "DataHandler.h"
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DL {
+/**
+ * @brief FNV-1a hash of a key, usable at compile time
+ */
+constexpr uint64 bindingHash(const char* str, size_t size)
+{
+	uint64 h = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; ++i) {
+		h ^= static_cast<uint8>(str[i]);
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+/**
+ * @brief FNV-1a hash of a null terminated key, usable at compile time
+ */
+constexpr uint64 bindingHash(const char* str)
+{
+	size_t size = 0;
+	while (str[size] != '\0')
+		++size;
+	return bindingHash(str, size);
+}
+
+/**
+ * @brief Descriptor of a single struct member bound to a key
+ * @see DL_FIELD
+ */
+template <typename Struct, typename Member>
+struct BindingField {
+	const char* Name;		 ///< Key of the entry
+	uint64 Hash;			 ///< Hash of the key
+	Member Struct::*Pointer; ///< Bound member
+};
+
+template <uint64 Hash, typename Struct, typename Member>
+constexpr BindingField<Struct, Member> makeBindingField(const char* name, Member Struct::*pointer)
+{
+	return BindingField<Struct, Member>{ name, Hash, pointer };
+}
+
+/**
+ * @brief Describes a member bound to the named entry with the given key. The hash is computed at compile time
+ */
+#define DL_FIELD(name, member) ::DL::makeBindingField<::DL::bindingHash(name)>(name, member)
+
+/**
+ * @brief Declares the fields of a struct. Has to be used in the namespace of the struct
+ *
+ * @code{.cpp}
+ * struct Camera {
+ *	float FOV;
+ *	std::vector<float> Position;
+ * };
+ * DL_BINDING(Camera, DL_FIELD("fov", &Camera::FOV), DL_FIELD("position", &Camera::Position))
+ * @endcode
+ */
+#define DL_BINDING(type, ...)                                     \
+	constexpr auto bindingFields(const type*)                     \
+	{                                                             \
+		return std::make_tuple(__VA_ARGS__);                      \
+	}
+
+/**
+ * @brief Type erased target of events. Object is NULL if all events are ignored
+ */
+struct BindingSink {
+	void* Object = nullptr;
+	bool (*Value)(void* object, const string_t& key, const Data& value)							  = nullptr;
+	bool (*Group)(void* object, const string_t& key, const string_t& id, BindingSink& child) = nullptr;
+};
+
+namespace binding {
+template <typename T, typename = void>
+struct IsStruct : std::false_type {
+};
+
+template <typename T>
+struct IsStruct<T, decltype((void)bindingFields(static_cast<const T*>(nullptr)))> : std::true_type {
+};
+
+template <typename T>
+struct IsVector : std::false_type {
+};
+
+template <typename T, typename A>
+struct IsVector<std::vector<T, A>> : std::true_type {
+};
+
+// Values
+inline bool assign(bool& target, const Data& value)
+{
+	if (value.type() != DT_Bool)
+		return false;
+	target = value.getBool();
+	return true;
+}
+
+inline bool assign(string_t& target, const Data& value)
+{
+	if (value.type() != DT_String)
+		return false;
+	target = value.getString();
+	return true;
+}
+
+inline bool assign(Data& target, const Data& value)
+{
+	target = value;
+	return true;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, bool>::type assign(T& target, const Data& value)
+{
+	if (value.type() != DT_Integer)
+		return false;
+	target = static_cast<T>(value.getInt());
+	return true;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type assign(T& target, const Data& value)
+{
+	if (!value.isNumber())
+		return false;
+	target = static_cast<T>(value.getNumber());
+	return true;
+}
+
+// Groups can not be assigned as value
+template <typename T>
+inline typename std::enable_if<IsStruct<T>::value || IsVector<T>::value, bool>::type assign(T&, const Data&)
+{
+	return false;
+}
+
+template <typename T, typename Enable = void>
+struct Sink {
+	static inline BindingSink make(T&) { return BindingSink(); }
+};
+
+template <typename T>
+inline BindingSink makeSink(T& target)
+{
+	return Sink<T>::make(target);
+}
+
+template <typename Tuple, typename Func, size_t... I>
+inline void forEach(const Tuple& tuple, Func&& func, std::index_sequence<I...>)
+{
+	(void)std::initializer_list<int>{ (func(std::get<I>(tuple)), 0)... };
+}
+
+// Structs accept named entries, dispatched by the hash of the key
+template <typename T>
+struct Sink<T, typename std::enable_if<IsStruct<T>::value>::type> {
+	template <typename Func>
+	static inline void forEachField(Func&& func)
+	{
+		constexpr auto fields = bindingFields(static_cast<const T*>(nullptr));
+		forEach(fields, func, std::make_index_sequence<std::tuple_size<decltype(fields)>::value>());
+	}
+
+	static bool value(void* object, const string_t& key, const Data& value)
+	{
+		T& target		  = *static_cast<T*>(object);
+		const uint64 hash = bindingHash(key.data(), key.size());
+
+		bool result = true; // Unknown keys are ignored
+		forEachField([&](const auto& field) {
+			if (field.Hash == hash && key == field.Name)
+				result = assign(target.*field.Pointer, value);
+		});
+		return result;
+	}
+
+	static bool group(void* object, const string_t& key, const string_t&, BindingSink& child)
+	{
+		T& target		  = *static_cast<T*>(object);
+		const uint64 hash = bindingHash(key.data(), key.size());
+
+		bool result = true;
+		forEachField([&](const auto& field) {
+			if (field.Hash == hash && key == field.Name) {
+				child  = makeSink(target.*field.Pointer);
+				result = child.Object != nullptr;
+			}
+		});
+		return result;
+	}
+
+	static inline BindingSink make(T& target)
+	{
+		BindingSink sink;
+		sink.Object = &target;
+		sink.Value	= &value;
+		sink.Group	= &group;
+		return sink;
+	}
+};
+
+// Vectors accept anonymous entries, which are appended
+template <typename T>
+struct Sink<T, typename std::enable_if<IsVector<T>::value>::type> {
+	typedef typename T::value_type Element;
+
+	static bool value(void* object, const string_t& key, const Data& value)
+	{
+		if (!key.empty())
+			return true;
+
+		T& target = *static_cast<T*>(object);
+		target.emplace_back();
+		if (assign(target.back(), value))
+			return true;
+
+		target.pop_back();
+		return false;
+	}
+
+	static bool group(void* object, const string_t& key, const string_t&, BindingSink& child)
+	{
+		if (!key.empty())
+			return true;
+
+		// The element is bound until the group ends, no other element is added meanwhile
+		T& target = *static_cast<T*>(object);
+		target.emplace_back();
+		child = makeSink(target.back());
+		if (child.Object)
+			return true;
+
+		target.pop_back();
+		return false;
+	}
+
+	static inline BindingSink make(T& target)
+	{
+		BindingSink sink;
+		sink.Object = &target;
+		sink.Value	= &value;
+		sink.Group	= &group;
+		return sink;
+	}
+};
+} // namespace binding
+
+/** @class Binder Binding.h DL/Binding.h
+ * @brief Fills structs, declared with @ref DL_BINDING, directly from events
+ *
+ * Supported members are integers, floats, bool, string_t, Data, other bound structs
+ * and std::vector of all of them. Vectors are filled by the anonymous entries of an array or group.
+ * Entries with unknown keys are ignored, entries with a wrong type are counted as error.
+ *
+ * The key of every entry is hashed once and compared with the hashes of the fields computed at compile time.
+ * Together with DataLisp::build(DataHandler&) no DataContainer has to be built at all:
+ * @code{.cpp}
+ * std::vector<Camera> cameras;
+ * DL::Binder<std::vector<Camera>> binder(cameras, "camera");
+ *
+ * lisp.parse(source);
+ * lisp.build(binder);
+ * @endcode
+ */
+template <typename T>
+class Binder : public DataHandler {
+public:
+	/**
+	 * @brief Binds all top groups with the given id to the target
+	 *
+	 * A vector receives an element for each top group, every other type is filled by all of them.
+	 */
+	Binder(T& target, const string_t& id)
+		: mTarget(target)
+		, mID(id)
+		, mErrors(0)
+		, mBound(0)
+	{
+	}
+
+	void beginGroup(const string_t& key, const string_t& id) override
+	{
+		BindingSink child;
+		if (mStack.empty()) {
+			if (id == mID) {
+				++mBound;
+				bindTop(child, std::integral_constant<bool, binding::IsVector<T>::value>());
+			}
+		} else {
+			const BindingSink& parent = mStack.back();
+			if (parent.Object && !parent.Group(parent.Object, key, id, child))
+				++mErrors;
+		}
+		mStack.push_back(child);
+	}
+
+	void endGroup() override
+	{
+		mStack.pop_back();
+	}
+
+	void value(const string_t& key, const Data& value) override
+	{
+		if (mStack.empty())
+			return;
+
+		const BindingSink& sink = mStack.back();
+		if (sink.Object && !sink.Value(sink.Object, key, value))
+			++mErrors;
+	}
+
+	/**
+	 * @brief Count of entries with a type not matching their member
+	 */
+	inline size_t errorCount() const { return mErrors; }
+
+	/**
+	 * @brief Count of top groups bound to the target
+	 */
+	inline size_t boundCount() const { return mBound; }
+
+private:
+	inline void bindTop(BindingSink& child, std::true_type)
+	{
+		binding::Sink<T>::group(&mTarget, string_t(), mID, child);
+	}
+
+	inline void bindTop(BindingSink& child, std::false_type)
+	{
+		child = binding::makeSink(mTarget);
+	}
+
+	T& mTarget;
+	string_t mID;
+	size_t mErrors;
+	size_t mBound;
+	vector_t<BindingSink> mStack;
+};
+
+/**
+ * @brief Fills the target with a single group
+ * @return True if all entries matched the types of their members
+ */
+template <typename T>
+inline bool bind(const DataGroup& group, T& target)
+{
+	Binder<T> binder(target, group.id());
+	binder.visit(Data(string_t(), group));
+	return binder.errorCount() == 0;
+}
+
+/**
+ * @brief Fills the target with all top groups of the container with the given id
+ * @return True if all entries matched the types of their members
+ */
+template <typename T>
+inline bool bind(const DataContainer& container, const string_t& id, T& target)
+{
+	Binder<T> binder(target, id);
+	for (const DataGroup* group : container.findAllTopGroups(id))
+		binder.visit(Data(string_t(), *group));
+	return binder.errorCount() == 0;
+}
+} // namespace DL
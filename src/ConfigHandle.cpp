@@ -0,0 +1,182 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "ConfigHandle.h"
+#include "DataLisp.h"
+#include "internal/ForwardLogger.h"
+#include "internal/MemoryStream.h"
+
+#include <chrono>
+
+namespace DL {
+static inline uint64 elapsed(const std::chrono::steady_clock::time_point& start)
+{
+	return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+struct DL_INTERNAL_LIB ConfigHandle::Published {
+	uint64 Version;
+	Snapshot Container;
+};
+
+ConfigHandle::ConfigHandle(SourceLogger* log, const std::shared_ptr<const ExpressionRegistry>& registry)
+	: mLogger(log)
+	, mRegistry(registry)
+	, mVersion(0)
+	, mCallback(nullptr)
+	, mCallbackUserData(nullptr)
+{
+	DL_ASSERT(log);
+
+	std::shared_ptr<DataContainer> empty = std::make_shared<DataContainer>();
+	empty->freeze();
+	mCurrent = std::make_shared<const Published>(Published{ 0, empty });
+}
+
+ConfigHandle::~ConfigHandle()
+{
+}
+
+std::shared_ptr<const ConfigHandle::Published> ConfigHandle::current() const
+{
+	return std::atomic_load_explicit(&mCurrent, std::memory_order_acquire);
+}
+
+ConfigHandle::Snapshot ConfigHandle::snapshot() const
+{
+	return current()->Container;
+}
+
+bool ConfigHandle::reload(const string_t& source)
+{
+	MemoryStreamBuf buffer(source.data(), source.size());
+	stream_t stream(&buffer);
+	return reload(&stream);
+}
+
+bool ConfigHandle::reload(stream_t* source)
+{
+	std::lock_guard<std::mutex> lock(mReloadMutex);
+	return reload_internal(source);
+}
+
+std::future<bool> ConfigHandle::reloadAsync(const string_t& source)
+{
+	return std::async(std::launch::async, [this, source]() {
+		return reload(source);
+	});
+}
+
+bool ConfigHandle::reload_internal(stream_t* source)
+{
+	ReloadInfo info;
+	info.Version	 = 0;
+	info.ParseTime	 = 0;
+	info.BuildTime	 = 0;
+	info.PublishTime = 0;
+	info.Success	 = false;
+
+	ForwardLogger logger(mLogger);
+	DataLisp lisp(&logger, mRegistry);
+	std::shared_ptr<DataContainer> container = std::make_shared<DataContainer>();
+
+	auto start = std::chrono::steady_clock::now();
+	lisp.parse(source);
+	info.ParseTime = elapsed(start);
+
+	if (logger.errorCount() == 0) {
+		start = std::chrono::steady_clock::now();
+		lisp.build(*container);
+		container->freeze();
+		info.BuildTime = elapsed(start);
+	}
+
+	info.ErrorCount = logger.errorCount();
+	if (info.ErrorCount == 0) {
+		start			 = std::chrono::steady_clock::now();
+		info.Version	 = publish_internal(container);
+		info.PublishTime = elapsed(start);
+		info.Success	 = true;
+	}
+
+	if (mCallback)
+		mCallback(info, mCallbackUserData);
+
+	return info.Success;
+}
+
+uint64 ConfigHandle::publish(DataContainer&& container)
+{
+	std::shared_ptr<DataContainer> ptr = std::make_shared<DataContainer>(std::move(container));
+	ptr->freeze();
+	return publish_internal(ptr);
+}
+
+uint64 ConfigHandle::publish_internal(const Snapshot& snapshot)
+{
+	std::lock_guard<std::mutex> lock(mPublishMutex);
+
+	// The snapshot has to be visible before readers see the new version
+	const uint64 version = mVersion.load(std::memory_order_relaxed) + 1;
+	std::atomic_store_explicit(&mCurrent, std::make_shared<const Published>(Published{ version, snapshot }), std::memory_order_release);
+	mVersion.store(version, std::memory_order_release);
+	return version;
+}
+
+void ConfigHandle::setReloadCallback(reload_callback_t callback, void* userData)
+{
+	std::lock_guard<std::mutex> lock(mReloadMutex);
+	mCallback		  = callback;
+	mCallbackUserData = userData;
+}
+
+//---------------------------------------------------
+ConfigHandle::Reader::Reader(const ConfigHandle& handle)
+	: mHandle(handle)
+	, mVersion(0)
+{
+	refresh();
+}
+
+// The version is taken from the published pair, never from the counter, so both can not disagree
+void ConfigHandle::Reader::refresh()
+{
+	const std::shared_ptr<const Published> current = mHandle.current();
+	mSnapshot									   = current->Container;
+	mVersion									   = current->Version;
+}
+
+const DataContainer& ConfigHandle::Reader::get()
+{
+	if (mHandle.version() != mVersion)
+		refresh();
+
+	return *mSnapshot;
+}
+} // namespace DL
@@ -0,0 +1,200 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataContainer.h"
+#include "ExpressionRegistry.h"
+
+#include <atomic>
+#include <future>
+#include <mutex>
+
+namespace DL {
+class SourceLogger;
+
+/**
+ * @brief Timing information of a single reload
+ *
+ * All times are in nanoseconds.
+ * @see ConfigHandle::setReloadCallback
+ */
+struct DL_LIB ReloadInfo {
+	uint64 Version;		///< Version published by this reload. Zero if the reload failed
+	uint64 ParseTime;	///< Time spent parsing
+	uint64 BuildTime;	///< Time spent building and freezing the container
+	uint64 PublishTime; ///< Time spent publishing the new snapshot
+	int ErrorCount;		///< Errors reported while parsing and building
+	bool Success;		///< True if the new snapshot was published
+};
+
+typedef void (*reload_callback_t)(const ReloadInfo& info, void* userData); ///< Reload callback
+
+/** @class ConfigHandle ConfigHandle.h DL/ConfigHandle.h
+ * @brief Holds the current version of a configuration which can be reloaded at runtime
+ *
+ * A reload parses and builds the new version completely off the hot path,
+ * freezes it and publishes it with an atomic pointer swap.
+ * Readers keep their snapshot alive as long as they need it,
+ * old versions are freed when the last reader drops them.
+ *
+ * Readers which access the configuration frequently should use a ConfigHandle::Reader,
+ * which only checks an atomic version number as long as no new snapshot was published.
+ *
+ * @subsection Example
+ * @code{.cpp}
+ * DL::ConfigHandle handle(&logger);
+ * handle.reload(source); // Loader thread
+ *
+ * // Reader thread
+ * DL::ConfigHandle::Reader reader(handle);
+ * for (;;) {
+ *   const DL::DataContainer& config = reader.get();
+ *   // ...
+ * }
+ * @endcode
+ * @attention The given SourceLogger is only used by the thread reloading,
+ * reloads are serialized internally.
+ */
+class DL_LIB ConfigHandle {
+public:
+	typedef std::shared_ptr<const DataContainer> Snapshot; ///< Immutable version of a configuration
+
+	/**
+	 * @brief Constructs a handle with an empty configuration
+	 * @param log Logging class used while reloading. Should never be NULL
+	 * @param registry Frozen expression registry used while reloading. Can be NULL
+	 */
+	explicit ConfigHandle(SourceLogger* log,
+						  const std::shared_ptr<const ExpressionRegistry>& registry = ExpressionRegistry::standard());
+	~ConfigHandle();
+
+	ConfigHandle(const ConfigHandle& other) = delete;
+	ConfigHandle& operator=(const ConfigHandle& other) = delete;
+
+	/**
+	 * @brief Returns the current snapshot
+	 *
+	 * Never NULL, an empty container is returned before the first reload.
+	 */
+	Snapshot snapshot() const;
+
+	/**
+	 * @brief Returns the version of the current snapshot
+	 *
+	 * Zero if nothing was published yet.
+	 */
+	inline uint64 version() const { return mVersion.load(std::memory_order_acquire); }
+
+	/**
+	 * @brief Parses and builds the given source and publishes it on success
+	 *
+	 * The current snapshot stays untouched if errors occur.
+	 * @return True if a new snapshot was published
+	 */
+	bool reload(const string_t& source);
+
+	/**
+	 * @brief Parses and builds the given source and publishes it on success
+	 * @see reload(const string_t&)
+	 */
+	bool reload(stream_t* source);
+
+	/**
+	 * @brief Starts a reload on a separate thread
+	 * @return Future containing the result of the reload
+	 */
+	std::future<bool> reloadAsync(const string_t& source);
+
+	/**
+	 * @brief Publishes an already built container
+	 *
+	 * The container will be frozen.
+	 * @return The new version
+	 */
+	uint64 publish(DataContainer&& container);
+
+	/**
+	 * @brief Sets a callback called after each reload with timing information
+	 *
+	 * The callback is called on the thread running the reload.
+	 * @param callback Callback function. Can be NULL to disable it
+	 * @param userData Pointer passed to the callback
+	 */
+	void setReloadCallback(reload_callback_t callback, void* userData = nullptr);
+
+	/** @class Reader ConfigHandle.h DL/ConfigHandle.h
+	 * @brief Per thread accessor caching the current snapshot of a ConfigHandle
+	 *
+	 * As long as no new version was published, @link get @endlink only reads an atomic integer.
+	 * @attention A reader should only be used by a single thread.
+	 */
+	class DL_LIB Reader {
+	public:
+		explicit Reader(const ConfigHandle& handle);
+
+		/**
+		 * @brief Returns the current configuration
+		 *
+		 * The returned reference is valid until the next call of get() on this reader.
+		 */
+		const DataContainer& get();
+
+		/**
+		 * @brief Returns the version of the configuration returned by the last get()
+		 */
+		inline uint64 version() const { return mVersion; }
+
+	private:
+		void refresh();
+
+		const ConfigHandle& mHandle;
+		Snapshot mSnapshot;
+		uint64 mVersion;
+	};
+
+private:
+	struct Published; // Snapshot together with its version, so both are always consistent
+
+	bool reload_internal(stream_t* source);
+	uint64 publish_internal(const Snapshot& snapshot);
+	std::shared_ptr<const Published> current() const;
+
+	SourceLogger* mLogger;
+	std::shared_ptr<const ExpressionRegistry> mRegistry;
+
+	std::shared_ptr<const Published> mCurrent;
+	std::atomic<uint64> mVersion; // Copy of the current version, checked by readers without locking
+
+	std::mutex mReloadMutex;
+	std::mutex mPublishMutex;
+	reload_callback_t mCallback;
+	void* mCallbackUserData;
+};
+} // namespace DL
@@ -33,8 +33,105 @@
 #include "internal/Expressions.h"
 #include "internal/SyntaxTree.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace DL {
+// Keys are looked up in the index of frozen groups, otherwise a hash map is built once per group.
+// Replaced entries are collected by position and the result is built in a single pass over the base
+static DataGroup overlayGroup(const DataGroup& base, const DataGroup& overrides)
+{
+	constexpr size_t NONE			= static_cast<size_t>(-1);
+	const vector_t<Data>& baseNamed = base.getNamedEntries();
+
+	std::unordered_map<string_t, size_t> keys;
+	if (!base.isFrozen() && !overrides.getNamedEntries().empty()) {
+		for (size_t i = 0; i < baseNamed.size(); ++i)
+			keys.emplace(baseNamed[i].key(), i);
+	}
+
+	auto findKey = [&](const string_t& key) -> size_t {
+		if (base.isFrozen()) {
+			const Data* d = base.findFromKey(key);
+			return d ? static_cast<size_t>(d - baseNamed.data()) : NONE;
+		}
+		auto it = keys.find(key);
+		return it != keys.end() ? it->second : NONE;
+	};
+
+	std::unordered_map<size_t, Data> replacedNamed;
+	vector_t<Data> appendedNamed;
+	for (const Data& d : overrides.getNamedEntries()) {
+		const size_t pos = findKey(d.key());
+		if (pos == NONE) {
+			appendedNamed.push_back(d);
+			continue;
+		}
+
+		auto it			    = replacedNamed.find(pos);
+		const Data& current = it != replacedNamed.end() ? it->second : baseNamed[pos];
+		Data next		    = d;
+		if (current.type() == DT_Group && d.type() == DT_Group && current.getGroup().id() == d.getGroup().id())
+			next = Data(d.key(), overlayGroup(current.getGroup(), d.getGroup()));
+
+		replacedNamed[pos] = next;
+	}
+
+	// First anonymous group per id, including appended ones
+	const vector_t<Data>& baseAnonymous = base.getAnonymousEntries();
+	std::unordered_map<string_t, size_t> ids;
+	auto isIdentified				    = [](const Data& d) { return d.type() == DT_Group && !d.getGroup().isArray(); };
+	if (std::any_of(overrides.getAnonymousEntries().begin(), overrides.getAnonymousEntries().end(), isIdentified)) {
+		for (size_t i = 0; i < baseAnonymous.size(); ++i) {
+			if (isIdentified(baseAnonymous[i]))
+				ids.emplace(baseAnonymous[i].getGroup().id(), i);
+		}
+	}
+
+	std::unordered_map<size_t, Data> replacedAnonymous;
+	vector_t<Data> appendedAnonymous;
+	for (const Data& d : overrides.getAnonymousEntries()) {
+		if (!isIdentified(d)) {
+			appendedAnonymous.push_back(d);
+			continue;
+		}
+
+		auto it = ids.find(d.getGroup().id());
+		if (it == ids.end()) {
+			ids.emplace(d.getGroup().id(), baseAnonymous.size() + appendedAnonymous.size());
+			appendedAnonymous.push_back(d);
+		} else if (it->second >= baseAnonymous.size()) {
+			Data& current = appendedAnonymous[it->second - baseAnonymous.size()];
+			current		  = Data(string_t(), overlayGroup(current.getGroup(), d.getGroup()));
+		} else {
+			auto rit			= replacedAnonymous.find(it->second);
+			const Data& current = rit != replacedAnonymous.end() ? rit->second : baseAnonymous[it->second];
+			Data next			= Data(string_t(), overlayGroup(current.getGroup(), d.getGroup()));
+
+			replacedAnonymous[it->second] = next;
+		}
+	}
+
+	DataGroup result(base.id());
+	for (size_t i = 0; i < baseAnonymous.size(); ++i) {
+		auto it = replacedAnonymous.find(i);
+		result.add(it != replacedAnonymous.end() ? it->second : baseAnonymous[i]);
+	}
+	for (const Data& d : appendedAnonymous)
+		result.add(d);
+	for (size_t i = 0; i < baseNamed.size(); ++i) {
+		auto it = replacedNamed.find(i);
+		result.add(it != replacedNamed.end() ? it->second : baseNamed[i]);
+	}
+	for (const Data& d : appendedNamed)
+		result.add(d);
+
+	return result;
+}
+
 DataContainer::DataContainer()
+	: mFrozen(false)
+	, mIndexedCount(0)
 {
 }
 
@@ -49,6 +146,80 @@ const vector_t<DataGroup>& DataContainer::getTopGroups() const
 
 void DataContainer::addTopGroup(const DataGroup& group)
 {
+	DL_ASSERT(!mFrozen);
 	mTopGroups.push_back(group);
 }
+
+const DataGroup* DataContainer::findTopGroup(const string_t& id) const
+{
+	updateIndex();
+
+	auto it = mIndex.find(id);
+	if (it == mIndex.end())
+		return nullptr;
+
+	return &mTopGroups[it->second.front()];
+}
+
+vector_t<const DataGroup*> DataContainer::findAllTopGroups(const string_t& id) const
+{
+	updateIndex();
+
+	vector_t<const DataGroup*> list;
+	auto it = mIndex.find(id);
+	if (it != mIndex.end()) {
+		list.reserve(it->second.size());
+		for (size_t i : it->second)
+			list.push_back(&mTopGroups[i]);
+	}
+
+	return list;
+}
+
+DataContainer DataContainer::overlay(const DataContainer& base, const DataContainer& overrides)
+{
+	DataContainer result;
+	result.mTopGroups = base.mTopGroups;
+
+	// Base groups are found by the id index of the base, only appended ids are tracked here
+	map_t<string_t, size_t> appended;
+	for (const DataGroup& grp : overrides.mTopGroups) {
+		size_t pos = result.mTopGroups.size();
+		if (!grp.isArray()) {
+			const DataGroup* found = base.findTopGroup(grp.id());
+			if (found) {
+				pos = static_cast<size_t>(found - base.mTopGroups.data());
+			} else {
+				auto it = appended.find(grp.id());
+				if (it != appended.end())
+					pos = it->second;
+			}
+		}
+
+		if (pos == result.mTopGroups.size()) {
+			if (!grp.isArray())
+				appended[grp.id()] = pos;
+			result.mTopGroups.push_back(grp);
+		} else {
+			result.mTopGroups[pos] = overlayGroup(result.mTopGroups[pos], grp);
+		}
+	}
+
+	return result;
+}
+
+void DataContainer::updateIndex() const
+{
+	for (; mIndexedCount < mTopGroups.size(); ++mIndexedCount)
+		mIndex[mTopGroups[mIndexedCount].id()].push_back(mIndexedCount);
+}
+
+void DataContainer::freeze()
+{
+	for (DataGroup& grp : mTopGroups)
+		grp.freeze();
+
+	updateIndex();
+	mFrozen = true;
+}
 } // namespace DL
\ No newline at end of file
@@ -36,6 +36,14 @@ class DataGroup;
 
 /** @class DataContainer DataContainer.h DL/DataContainer.h
  * @brief Container class containing all data used by %DataLisp
+ *
+ * @section Concurrency
+ * A container is not thread safe while being filled.<br>
+ * After @link freeze @endlink the container and all its groups are immutable,
+ * any number of threads can traverse a const reference of it concurrently.
+ * Lookups by id on a container which is not frozen modify the internal index
+ * and are therefor not thread safe.
+ * @see DataGroup
  */
 class DL_LIB DataContainer {
 public:
@@ -55,7 +63,70 @@ public:
 	 */
 	void addTopGroup(const DataGroup& group);
 
+	/**
+	 * @brief Returns the first group on top of the hierarchy with the given id
+	 *
+	 * Uses an index of the ids, which is updated in bulk on the first lookup after groups were added.
+	 * @attention Ids changed after the group was added are not recognized.
+	 * @param id The id of the group
+	 * @return Pointer to the group if available, NULL otherwise.
+	 * Only valid as long as no group is added
+	 */
+	const DataGroup* findTopGroup(const string_t& id) const;
+
+	/**
+	 * @brief Returns all groups on top of the hierarchy with the given id in order of appearance
+	 * @param id The id of the groups
+	 * @see findTopGroup
+	 */
+	vector_t<const DataGroup*> findAllTopGroups(const string_t& id) const;
+
+	/**
+	 * @brief Layers the overrides on top of the base
+	 *
+	 * Top groups of the overrides are matched by id with the first top group of the base.
+	 * Unmatched top groups are appended. Matched groups are merged:
+	 * - A named entry replaces the first base entry with the same key.
+	 *   If both are groups with the same id, they are merged recursively instead
+	 * - Named entries with new keys are appended
+	 * - Anonymous groups are merged with the first anonymous base group with the same id
+	 * - All other anonymous entries are appended
+	 *
+	 * Only the groups along the overridden entries are recreated,
+	 * all other groups are shared with the base and the overrides.
+	 * Top groups are matched with the id index of the base, which is kept between calls.
+	 * The list of base top groups is still copied and every matched group is rebuilt,
+	 * therefor the cost is O(base top groups + entries of each matched group).
+	 * Keys of frozen groups are looked up in their key index, otherwise the keys of a matched group are hashed once.
+	 * @attention Shared groups are not copied on write. Freeze the inputs to keep them independent of the result.
+	 * @param base The container to start with
+	 * @param overrides The container with higher priority
+	 * @return The merged container
+	 */
+	static DataContainer overlay(const DataContainer& base, const DataContainer& overrides);
+
+	/**
+	 * @brief Makes the container and all its groups immutable
+	 *
+	 * No groups can be added afterwards. The id index is completed as well.
+	 * @see DataGroup::freeze
+	 */
+	void freeze();
+
+	/**
+	 * @brief Returns true if the container is immutable
+	 * @see freeze
+	 */
+	inline bool isFrozen() const { return mFrozen; }
+
 private:
+	void updateIndex() const;
+
 	vector_t<DataGroup> mTopGroups;
+	bool mFrozen;
+
+	// Id index covering the first mIndexedCount top groups
+	mutable map_t<string_t, vector_t<size_t>> mIndex;
+	mutable size_t mIndexedCount;
 };
 } // namespace DL
@@ -29,14 +29,71 @@
  */
 #include "DataGroup.h"
 #include "Data.h"
+#include "internal/Hash.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace DL {
+// Smaller groups are searched linearly
+constexpr size_t KEY_INDEX_THRESHOLD = 8;
+
+struct DL_INTERNAL_LIB KeyIndexEntry {
+	uint64 Hash;
+	uint32 Position;
+
+	inline bool operator<(const KeyIndexEntry& other) const
+	{
+		return Hash < other.Hash || (Hash == other.Hash && Position < other.Position);
+	}
+};
+
 struct DL_INTERNAL_LIB DataInternal {
 	string_t ID;
 	vector_t<Data> AnonymousData;
 	vector_t<Data> NamedData;
+	vector_t<KeyIndexEntry> KeyIndex; // Only available for frozen groups
+	uint64 Hash = 0;				  // Only available for frozen groups
+	bool Frozen = false;
 };
 
+static uint64 hashData(const Data& d)
+{
+	uint64 h = hashMix(static_cast<uint64>(d.type()) + 1);
+	switch (d.type()) {
+	case DT_Group:
+		return hashCombine(h, d.getGroup().hash());
+	case DT_Integer:
+		return hashCombine(h, static_cast<uint64>(d.getInt()));
+	case DT_Float: {
+		const Float f = d.getFloat();
+		uint32 bits;
+		std::memcpy(&bits, &f, sizeof(bits));
+		return hashCombine(h, bits);
+	}
+	case DT_Bool:
+		return hashCombine(h, d.getBool() ? 1 : 0);
+	case DT_String:
+		return hashCombine(h, hashString(d.getString()));
+	default:
+		return h;
+	}
+}
+
+static uint64 hashGroup(const DataInternal& grp)
+{
+	uint64 h = hashString(grp.ID);
+	for (const Data& d : grp.AnonymousData)
+		h = hashCombine(h, hashData(d));
+
+	// Separates anonymous and named entries
+	h = hashCombine(h, grp.AnonymousData.size());
+	for (const Data& d : grp.NamedData)
+		h = hashCombine(hashCombine(h, hashString(d.key())), hashData(d));
+
+	return h;
+}
+
 DataGroup::DataGroup(const string_t& id)
 	: mShared(new DataInternal)
 {
@@ -48,10 +105,32 @@ DataGroup::DataGroup(const DataGroup& other)
 {
 }
 
+// Uniquely owned child groups are moved to a worklist, therefor deep hierarchies are not destroyed recursively
+void DataGroup::detachChildren(vector_t<Data>& list, vector_t<std::shared_ptr<DataInternal>>& pending)
+{
+	for (Data& d : list) {
+		if (d.type() == DT_Group && d.getGroup().mShared.use_count() == 1)
+			pending.push_back(std::move(d.getGroup().mShared));
+	}
+}
+
 DataGroup::~DataGroup()
 {
+	if (!mShared || mShared.use_count() != 1)
+		return;
+
+	vector_t<std::shared_ptr<DataInternal>> pending;
+	detachChildren(mShared->AnonymousData, pending);
+	detachChildren(mShared->NamedData, pending);
+	while (!pending.empty()) {
+		std::shared_ptr<DataInternal> p = std::move(pending.back());
+		pending.pop_back();
+		detachChildren(p->AnonymousData, pending);
+		detachChildren(p->NamedData, pending);
+	}
 }
 
+
 DataGroup::DataGroup(DataGroup&& other) noexcept
 	: mShared(std::move(other.mShared))
 {
@@ -78,7 +157,7 @@ void DataGroup::makeUnique()
 {
 	DL_ASSERT(mShared);
 
-	if (mShared.unique())
+	if (mShared.use_count() == 1 && !mShared->Frozen)
 		return;
 
 	DataInternal* p  = new DataInternal;
@@ -89,6 +168,53 @@ void DataGroup::makeUnique()
 	mShared = std::shared_ptr<DataInternal>(p);
 }
 
+void DataGroup::freeze()
+{
+	DL_ASSERT(mShared);
+
+	if (mShared->Frozen)
+		return;
+
+	for (Data& d : mShared->AnonymousData) {
+		if (d.type() == DT_Group)
+			d.getGroup().freeze();
+	}
+
+	for (Data& d : mShared->NamedData) {
+		if (d.type() == DT_Group)
+			d.getGroup().freeze();
+	}
+
+	if (mShared->NamedData.size() >= KEY_INDEX_THRESHOLD) {
+		mShared->KeyIndex.reserve(mShared->NamedData.size());
+		for (size_t i = 0; i < mShared->NamedData.size(); ++i)
+			mShared->KeyIndex.push_back(KeyIndexEntry{ hashString(mShared->NamedData[i].key()), static_cast<uint32>(i) });
+		std::sort(mShared->KeyIndex.begin(), mShared->KeyIndex.end());
+	}
+
+	// Child groups are already frozen, their hashes are not computed again
+	mShared->Hash	= hashGroup(*mShared);
+	mShared->Frozen = true;
+}
+
+bool DataGroup::isFrozen() const
+{
+	DL_ASSERT(mShared);
+	return mShared->Frozen;
+}
+
+uint64 DataGroup::hash() const
+{
+	DL_ASSERT(mShared);
+	return mShared->Frozen ? mShared->Hash : hashGroup(*mShared);
+}
+
+void DataGroup::detachIfFrozen()
+{
+	if (mShared->Frozen)
+		makeUnique();
+}
+
 void DataGroup::add(const Data& data)
 {
 	DL_ASSERT(mShared);
@@ -96,6 +222,8 @@ void DataGroup::add(const Data& data)
 	if (!data.isValid())
 		return;
 
+	detachIfFrozen();
+
 	if (data.key().empty())
 		mShared->AnonymousData.push_back(data);
 	else
@@ -105,6 +233,7 @@ void DataGroup::add(const Data& data)
 void DataGroup::clear()
 {
 	DL_ASSERT(mShared);
+	detachIfFrozen();
 	vector_t<Data>().swap(mShared->AnonymousData);
 	vector_t<Data>().swap(mShared->NamedData);
 }
@@ -127,15 +256,33 @@ size_t DataGroup::anonymousCount() const
 }
 
 Data DataGroup::getFromKey(const string_t& str) const
+{
+	const Data* d = findFromKey(str);
+	return d ? *d : Data();
+}
+
+const Data* DataGroup::findFromKey(const string_t& str) const
 {
 	DL_ASSERT(mShared);
 
+	if (!mShared->KeyIndex.empty()) {
+		// Entries with the same hash are ordered by position, therefor the first occurrence is found
+		const uint64 hash = hashString(str);
+		auto it			  = std::lower_bound(mShared->KeyIndex.begin(), mShared->KeyIndex.end(), KeyIndexEntry{ hash, 0 });
+		for (; it != mShared->KeyIndex.end() && it->Hash == hash; ++it) {
+			const Data& d = mShared->NamedData[it->Position];
+			if (d.key() == str)
+				return &d;
+		}
+		return nullptr;
+	}
+
 	for (const Data& d : mShared->NamedData) {
 		if (d.key() == str)
-			return d;
+			return &d;
 	}
 
-	return Data();
+	return nullptr;
 }
 
 vector_t<Data> DataGroup::getAllFromKey(const string_t& key) const
@@ -153,7 +300,7 @@ vector_t<Data> DataGroup::getAllFromKey(const string_t& key) const
 
 bool DataGroup::hasKey(const string_t& key) const
 {
-	return getFromKey(key).isValid();
+	return findFromKey(key) != nullptr;
 }
 
 vector_t<Data> DataGroup::getAllEntries() const
@@ -262,5 +409,9 @@ bool DataGroup::isAllNamedOfType(DL::DataType type) const
 
 bool DataGroup::isArray() const { return mShared->ID.empty(); }
 string_t DataGroup::id() const { return mShared->ID; }
-void DataGroup::setID(const string_t& str) { mShared->ID = str; }
+void DataGroup::setID(const string_t& str)
+{
+	detachIfFrozen();
+	mShared->ID = str;
+}
 } // namespace DL
\ No newline at end of file
@@ -57,7 +57,16 @@ class Data;
  *
  * @attention This class uses reference counting without Copy on Write.<br>
  * Every change will be transferred to other instances aswell.
- * @attention This class is not thread safe!
+ *
+ * @section Concurrency
+ * A group can not be modified and read at the same time.<br>
+ * After @link freeze @endlink the group and all its child groups are immutable
+ * and can be traversed by any number of threads without locking.
+ * Use the reference returning functions like @link getNamedEntries @endlink,
+ * @link getAnonymousEntries @endlink, @link findFromKey @endlink and Data::getGroup
+ * to traverse it without touching any reference counts.<br>
+ * Modifying a frozen group detaches the modified instance first (Copy on Write),
+ * other instances and threads still see the frozen content.
  */
 class DL_LIB DataGroup {
 public:
@@ -102,9 +111,38 @@ public:
 
 	/**
 	 * @brief Sets the reference count to 1 and copies data
+	 *
+	 * A frozen group is always copied. The copy is not frozen.
+	 * @attention Has to be called by the only thread accessing this instance.
 	 */
 	void makeUnique();
 
+	/**
+	 * @brief Makes the group and all its child groups immutable
+	 * @see isFrozen
+	 */
+	void freeze();
+
+	/**
+	 * @brief Returns true if the group is immutable
+	 * @see freeze
+	 */
+	bool isFrozen() const;
+
+	/**
+	 * @brief Returns a hash of the id and the whole content including all child groups
+	 *
+	 * Frozen groups compute the hash once in @link freeze @endlink,
+	 * for all other groups it is computed on every call.
+	 */
+	uint64 hash() const;
+
+	/**
+	 * @brief Returns true if both groups refer to the same shared content
+	 * @see referenceCount
+	 */
+	inline bool shares(const DataGroup& other) const { return mShared == other.mShared; }
+
 	/**
 	 * @brief Returns id
 	 */
@@ -150,6 +188,18 @@ public:
 	 */
 	Data getFromKey(const string_t& str) const;
 
+	/**
+	 * @brief Returns non anonymous data with the given id without copying it
+	 *
+	 * If more than one data has the same id. The first one will be returned.
+	 * Frozen groups with many entries use a key index built by @link freeze @endlink.
+	 * @param str The id of the non anonymous data
+	 * @return Pointer to the data if available, NULL otherwise.
+	 * Only valid as long as the group is not modified
+	 * @see getFromKey
+	 */
+	const Data* findFromKey(const string_t& str) const;
+
 	/**
 	 * @brief Returns all non anonymous data with the given id
 	 * @param str The id of the non anonymous data
@@ -230,6 +280,9 @@ public:
 	bool isAllNamedOfType(DL::DataType type) const;
 
 private:
+	void detachIfFrozen();
+	static void detachChildren(vector_t<Data>& list, vector_t<std::shared_ptr<struct DataInternal>>& pending);
+
 	std::shared_ptr<struct DataInternal> mShared;
 };
 } // namespace DL
@@ -0,0 +1,73 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "DataHandler.h"
+
+namespace DL {
+// Nested groups are visited with an explicit stack instead of recursion
+void DataHandler::visit(const Data& data)
+{
+	if (data.type() != DT_Group) {
+		if (data.isValid())
+			value(data.key(), data);
+		return;
+	}
+
+	struct Frame {
+		const DataGroup* Group;
+		size_t Next;
+	};
+
+	vector_t<Frame> stack;
+	beginGroup(data.key(), data.getGroup().id());
+	stack.push_back(Frame{ &data.getGroup(), 0 });
+
+	while (!stack.empty()) {
+		Frame& frame					= stack.back();
+		const vector_t<Data>& named		= frame.Group->getNamedEntries();
+		const vector_t<Data>& anonymous = frame.Group->getAnonymousEntries();
+
+		if (frame.Next >= named.size() + anonymous.size()) {
+			stack.pop_back();
+			endGroup();
+			continue;
+		}
+
+		const Data& d = frame.Next < named.size() ? named[frame.Next] : anonymous[frame.Next - named.size()];
+		++frame.Next;
+
+		if (d.type() == DT_Group) {
+			beginGroup(d.key(), d.getGroup().id());
+			stack.push_back(Frame{ &d.getGroup(), 0 });
+		} else {
+			value(d.key(), d);
+		}
+	}
+}
+} // namespace DL
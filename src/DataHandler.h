@@ -0,0 +1,73 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Data.h"
+
+namespace DL {
+/** @class DataHandler DataHandler.h DL/DataHandler.h
+ * @brief Receives content as a sequence of events instead of a DataContainer
+ *
+ * Groups are reported by @link beginGroup @endlink and @link endGroup @endlink,
+ * all other entries by @link value @endlink in between. Top groups have an empty key,
+ * as well as anonymous entries.
+ * @see DataLisp::build(DataHandler&)
+ */
+class DL_LIB DataHandler {
+public:
+	virtual ~DataHandler() {}
+
+	/**
+	 * @brief Called at the start of a group or an array
+	 * @param key Key of the entry. Empty for top groups and anonymous entries
+	 * @param id Id of the group. Empty for arrays
+	 */
+	virtual void beginGroup(const string_t& key, const string_t& id) = 0;
+
+	/**
+	 * @brief Called at the end of the last begun group
+	 */
+	virtual void endGroup() = 0;
+
+	/**
+	 * @brief Called for every entry which is not a group
+	 * @param key Key of the entry. Empty for anonymous entries
+	 * @param value The value of the entry
+	 */
+	virtual void value(const string_t& key, const Data& value) = 0;
+
+	/**
+	 * @brief Reports the given data and all its content as events
+	 *
+	 * Named entries of a group are reported before the anonymous entries.
+	 */
+	void visit(const Data& data);
+};
+} // namespace DL
@@ -28,10 +28,19 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
  */
 #include "DataLisp.h"
+#include "ExpressionRegistry.h"
 #include "VM.h"
-#include "internal/Expressions.h"
+#include "Binary.h"
+#include "internal/Generator.h"
+#include "internal/Hash.h"
+#include "internal/MemoryStream.h"
+#include "internal/NodePool.h"
 #include "internal/Parser.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
 #include <sstream>
 
 namespace DL {
@@ -39,23 +48,70 @@ class DL_INTERNAL_LIB DataLisp_Internal {
 public:
 	typedef map_t<string_t, expr_t> ExpressionMap;
 
-	DataLisp_Internal(SourceLogger* logger)
+	DataLisp_Internal(SourceLogger* logger, const std::shared_ptr<const ExpressionRegistry>& registry)
 		: mTree(nullptr)
 		, mLogger(logger)
+		, mRegistry(registry)
 		, mExpressions()
+		, mCacheErrors(0)
+		, mStatistics(nullptr)
+		, mProfiler(nullptr)
+		, mSchema(nullptr)
+		, mFileId(0)
+		, mMaxDepth(Parser::DEFAULT_MAX_DEPTH)
+		, mMaxErrors(Parser::DEFAULT_MAX_ERRORS)
 	{
 	}
 
 	~DataLisp_Internal()
 	{
-		if (mTree) {
-			for (StatementNode* ptr : mTree->Nodes)
-				deleteNode(ptr);
+		releaseTree();
+	}
 
-			delete mTree;
+	void releaseTree()
+	{
+		if (mTree) {
+			mPool.release(mTree);
+			mTree = nullptr;
 		}
 	}
 
+	// Content address of the source, including everything influencing the built content
+	string_t cachePath(const string_t& source) const
+	{
+		vector_t<string_t> names = mRegistry ? mRegistry->names() : vector_t<string_t>();
+		for (const auto& p : mExpressions)
+			names.push_back(p.first);
+		std::sort(names.begin(), names.end());
+
+		uint64 fingerprint = hashCombine(hashString(DL_VERSION_STRING), hashString(mCacheVersion));
+		for (const string_t& name : names)
+			fingerprint = hashCombine(fingerprint, hashString(name));
+
+		const uint64 h1 = hashCombine(fingerprint, hashString(source));
+		const uint64 h2 = hashCombine(hashMix(source.size()), hashString(source, hashMix(fingerprint)));
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%016llx%016llx.dlb",
+					  static_cast<unsigned long long>(h1), static_cast<unsigned long long>(h2));
+		return mCacheDirectory + "/" + name;
+	}
+
+	void storeCache(const DataContainer& container, size_t firstGroup)
+	{
+		DataContainer snapshot;
+		const vector_t<DataGroup>& groups = container.getTopGroups();
+		for (size_t i = firstGroup; i < groups.size(); ++i)
+			snapshot.addTopGroup(groups[i]);
+
+		// Other processes may populate the same entry, only complete files are renamed into place
+		std::random_device device;
+		const uint64 salt  = hashCombine(device(), std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		const string_t tmp = mCacheFile + "." + std::to_string(salt) + ".tmp";
+		if (!BinaryContainer::write(snapshot, tmp) || std::rename(tmp.c_str(), mCacheFile.c_str()) != 0)
+			std::remove(tmp.c_str());
+	}
+
 	static string_t dumpNode(StatementNode* n, int depth)
 	{
 		string_t white;
@@ -151,215 +207,260 @@ public:
 		return white + str + "\n";
 	}
 
-	static string_t generateDataGroup(const DataGroup& d, int depth)
+	// Group or expression under construction
+	struct BuildFrame {
+		const vector_t<DataNode*>* Nodes;
+		size_t Next;
+		const string_t* Key;		// Key of the resulting entry
+		ExpressionNode* Expression; // NULL for groups
+		DataGroup Group;
+		vector_t<Data> Args;
+	};
+
+	// Nested values are built with an explicit stack instead of recursion
+	DataGroup buildGroup(StatementNode* n, VM& vm)
 	{
-		string_t white;
-		for (int i = 0; i < depth; ++i)
-			white += " ";
-
-		string_t str;
-
-		if (d.isArray())
-			str = white + "[" + "\n";
-		else
-			str = white + "(" + d.id() + "\n";
-
-		for (const Data& data : d.getAnonymousEntries())
-			str += generateData(data, depth + 1) + "\n";
-
-		for (const Data& data : d.getNamedEntries())
-			str += generateData(data, depth + 1) + "\n";
-
-		str += white + (!d.isArray() ? ")" : "]");
+		DL_ASSERT(n);
 
-		return str;
+		mBuildStack.clear();
+		pushGroup(n, nullptr);
+		return run(vm).getGroup();
 	}
 
-	static string_t generateData(const Data& d, int depth)
+	Data buildExpression(ExpressionNode* n, const string_t& key, VM& vm)
 	{
-		string_t white;
-		for (int i = 0; i < depth; ++i)
-			white += " ";
-
-		string_t str;
+		DL_ASSERT(n);
 
-		if (d.key().empty())
-			str = generateValue(d, depth + 1);
-		else
-			str = ":" + d.key() + "  " + generateValue(d, depth + 1);
-		return white + str;
+		mBuildStack.clear();
+		pushExpression(n, &key);
+		return run(vm);
 	}
 
-	static string_t generateValue(const Data& d, int depth)
+	// Builds until the frame at the bottom of the stack is complete
+	Data run(VM& vm)
 	{
-		string_t str;
-
-		switch (d.type()) {
-		case DT_Group:
-			str = generateDataGroup(d.getGroup(), depth);
-			break;
-		case DT_Bool:
-			if (d.getBool())
-				str = "true";
-			else
-				str = "false";
-			break;
-		case DT_Float: {
-			std::stringstream stream;
-			stream << d.getFloat();
-			str = stream.str();
-		} break;
-		case DT_Integer: {
-			std::stringstream stream;
-			stream << d.getInt();
-			str = stream.str();
-		} break;
-		case DT_String:
-			str = "\"" + d.getString() + "\"";
-			break;
-		case DT_None:
-			break;
+		for (;;) {
+			BuildFrame& frame = mBuildStack.back();
+			if (frame.Next < frame.Nodes->size()) {
+				DataNode* child = (*frame.Nodes)[frame.Next++];
+				switch (child->Value->Type) {
+				case VNT_Statement:
+					pushGroup(child->Value->_Statement, &child->Key);
+					break;
+				case VNT_Expression:
+					pushExpression(child->Value->_Expression, &child->Key);
+					break;
+				default:
+					deliver(frame, buildValue(child));
+					break;
+				}
+				continue;
+			}
+
+			Data result;
+			if (frame.Expression) {
+				ExpressionNode* expr = frame.Expression;
+				vm.setLocation(mFileId, expr->Line, expr->Column, expr->Begin, expr->End);
+				result = exec_expression(expr->Name, frame.Args, vm);
+				result.setKey(*frame.Key);
+
+				if (mProfiler)
+					mProfiler->leave();
+				if (mStatistics && result.isValid())
+					++mStatistics->NodeCount[result.type()];
+			} else {
+				if (frame.Key)
+					result.setKey(*frame.Key);
+				result.setGroup(frame.Group);
+			}
+
+			mBuildStack.pop_back();
+			if (mBuildStack.empty())
+				return result;
+
+			deliver(mBuildStack.back(), result);
 		}
-
-		return str;
 	}
 
-	static void deleteNode(StatementNode* n)
+	// Reports the statement as events, only the results of expressions are built
+	void emitGroup(StatementNode* n, DataHandler& handler, VM& vm)
 	{
-		if (!n)
-			return;
-
-		for (DataNode* ptr : n->Nodes)
-			deleteNode(ptr);
+		DL_ASSERT(n);
 
-		delete n;
+		mEmitStack.clear();
+		handler.beginGroup(string_t(), n->Name);
+		mEmitStack.push_back(&n->Nodes);
+		mEmitPositions.assign(1, 0);
+
+		while (!mEmitStack.empty()) {
+			size_t& next = mEmitPositions.back();
+			if (next >= mEmitStack.back()->size()) {
+				mEmitStack.pop_back();
+				mEmitPositions.pop_back();
+				handler.endGroup();
+				continue;
+			}
+
+			DataNode* child = (*mEmitStack.back())[next++];
+			switch (child->Value->Type) {
+			case VNT_Statement:
+				if (mStatistics)
+					++mStatistics->NodeCount[DT_Group];
+				handler.beginGroup(child->Key, child->Value->_Statement->Name);
+				mEmitStack.push_back(&child->Value->_Statement->Nodes);
+				mEmitPositions.push_back(0);
+				break;
+			case VNT_Expression:
+				handler.visit(buildExpression(child->Value->_Expression, child->Key, vm));
+				break;
+			default: {
+				const Data value = buildValue(child);
+				if (value.isValid())
+					handler.value(child->Key, value);
+			} break;
+			}
+		}
 	}
 
-	static void deleteNode(ExpressionNode* n)
+	void pushGroup(StatementNode* n, const string_t* key)
 	{
-		if (!n)
-			return;
+		if (mStatistics)
+			++mStatistics->NodeCount[DT_Group];
 
-		for (DataNode* ptr : n->Nodes)
-			deleteNode(ptr);
-
-		delete n;
+		mBuildStack.push_back(BuildFrame{ &n->Nodes, 0, key, nullptr, DataGroup(n->Name), {} });
 	}
 
-	static void deleteNode(DataNode* n)
+	void pushExpression(ExpressionNode* n, const string_t* key)
 	{
-		if (!n)
-			return;
+		if (mProfiler)
+			mProfiler->enter(n->Name, n->Line, n->Column);
 
-		deleteNode(n->Value);
-
-		delete n;
+		mBuildStack.push_back(BuildFrame{ &n->Nodes, 0, key, n, DataGroup(), {} });
+		mBuildStack.back().Args.reserve(n->Nodes.size());
 	}
 
-	static void deleteNode(ValueNode* n)
+	static inline void deliver(BuildFrame& frame, const Data& data)
 	{
-		if (!n)
+		if (!data.isValid())
 			return;
 
-		if (n->Type == VNT_Statement)
-			deleteNode(n->_Statement);
-		else if (n->Type == VNT_Expression)
-			deleteNode(n->_Expression);
-
-		delete n;
-	}
-
-	DataGroup buildGroup(StatementNode* n, VM& vm)
-	{
-		DL_ASSERT(n);
-
-		DataGroup group(n->Name);
-		for (DataNode* ptr : n->Nodes) {
-			Data data = buildData(ptr, vm);
-			if (data.isValid())
-				group.add(data);
-		}
-
-		return group;
+		if (frame.Expression)
+			frame.Args.push_back(data);
+		else
+			frame.Group.add(data);
 	}
 
-	Data buildData(DataNode* n, VM& vm)
+	Data buildValue(DataNode* n)
 	{
 		DL_ASSERT(n);
 
-		Data data;
+		Data data(n->Key);
 		switch (n->Value->Type) {
-		case VNT_Statement: {
-			data = Data(n->Key);
-			data.setGroup(buildGroup(n->Value->_Statement, vm));
-		} break;
 		case VNT_Integer:
-			data = Data(n->Key);
 			data.setInt(n->Value->_Integer);
 			break;
 		case VNT_Float:
-			data = Data(n->Key);
 			data.setFloat(n->Value->_Float);
 			break;
 		case VNT_String:
-			data = Data(n->Key);
 			data.setString(n->Value->_String);
 			break;
 		case VNT_Boolean:
-			data = Data(n->Key);
 			data.setBool(n->Value->_Boolean);
 			break;
-		case VNT_Expression: {
-			data = buildExpression(n->Value->_Expression, vm);
-			data.setKey(n->Key);
-		} break;
 		default:
-			break;
+			return Data();
 		};
 
+		if (mStatistics)
+			++mStatistics->NodeCount[data.type()];
+
 		return data;
 	}
 
-	Data buildExpression(ExpressionNode* n, VM& vm)
+	expr_t findExpression(const string_t& name) const
 	{
-		vector_t<Data> args;
-		for (DataNode* ptr : n->Nodes) {
-			Data data = buildData(ptr, vm);
-
-			if (data.isValid())
-				args.push_back(data);
+		// Instance expressions override the shared registry; the overlay is usually empty, so skip the lookup then
+		if (!mExpressions.empty()) {
+			auto it = mExpressions.find(name);
+			if (it != mExpressions.end())
+				return it->second;
 		}
 
-		return exec_expression(n->Name, args, vm);
+		return mRegistry ? mRegistry->find(name) : nullptr;
 	}
 
 	Data exec_expression(const string_t& name, const vector_t<Data>& args, VM& vm)
 	{
-		if (!mExpressions.count(name)) {
-			std::stringstream stream;
-			stream << "Couldn't find expression '" << name << "'";
-			mLogger->log(L_Error, stream.str());
+		expr_t expr = findExpression(name);
+		if (!expr) {
+			Diagnostic diagnostic(DC_UnknownExpression, L_Error);
+			diagnostic.Text = name;
+			vm.report(diagnostic);
 
 			return Data();
 		}
 
-		return mExpressions[name](args, vm);
+		if (!mStatistics)
+			return expr(args, vm);
+
+		const auto start = std::chrono::steady_clock::now();
+		Data result		 = expr(args, vm);
+
+		ExpressionStatistics& exprStats = mStatistics->Expressions[name];
+		++exprStats.Calls;
+		exprStats.Time += elapsed(start);
+		return result;
+	}
+
+	// Without statistics no timestamp is taken at all
+	static inline std::chrono::steady_clock::time_point startTime(const Statistics* stats)
+	{
+		return stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	}
+
+	static inline uint64 elapsed(const std::chrono::steady_clock::time_point& start)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
 	}
 
 public:
 	SyntaxTree* mTree;
 	SourceLogger* mLogger;
-	ExpressionMap mExpressions;
+	std::shared_ptr<const ExpressionRegistry> mRegistry;
+	ExpressionMap mExpressions; // Instance overlay
+	NodePool mPool;
+
+	string_t mCacheDirectory;
+	string_t mCacheVersion; // Given by the user, changes with the behaviour of the expressions
+	string_t mCacheFile; // Entry to populate after building
+	BinaryContainer mCached;
+	int mCacheErrors; // Errors reported before parsing
+
+	Statistics* mStatistics;
+	ExpressionProfiler* mProfiler;
+	const Schema* mSchema;
+	uint32 mFileId;
+	uint32 mMaxDepth;
+	uint32 mMaxErrors;
+
+	vector_t<BuildFrame> mBuildStack;
+	vector_t<const vector_t<DataNode*>*> mEmitStack;
+	vector_t<size_t> mEmitPositions;
 };
 
 //---------------------------------------------------
 DataLisp::DataLisp(SourceLogger* log, bool stdlib)
-	: mInternal(new DataLisp_Internal(log))
+	: mInternal(new DataLisp_Internal(log, stdlib ? ExpressionRegistry::standard() : nullptr))
 {
 	DL_ASSERT(log);
+}
 
-	if (stdlib)
-		mInternal->mExpressions = Expressions::getStdLib();
+DataLisp::DataLisp(SourceLogger* log, const std::shared_ptr<const ExpressionRegistry>& registry)
+	: mInternal(new DataLisp_Internal(log, registry))
+{
+	DL_ASSERT(log);
+	DL_ASSERT(!registry || registry->isFrozen());
 }
 
 DataLisp::~DataLisp()
@@ -387,35 +488,292 @@ DataLisp& DataLisp::operator=(DataLisp&& other) noexcept
 void DataLisp::parse(stream_t* source)
 {
 	DL_ASSERT(mInternal->mTree == nullptr);
-	Parser parser(source, mInternal->mLogger);
+
+	Statistics* stats = mInternal->mStatistics;
+	if (!stats) {
+		Parser parser(source, mInternal->mLogger, &mInternal->mPool);
+		parser.setFileId(mInternal->mFileId);
+		parser.setMaxDepth(mInternal->mMaxDepth);
+		parser.setMaxErrors(mInternal->mMaxErrors);
+		mInternal->mTree = parser.parse();
+		return;
+	}
+
+	// The lexer starts reading on construction
+	const uint64 lexTime	 = stats->LexTime;
+	const uint64 allocations = mInternal->mPool.allocationCount();
+	const auto begin		 = source->rdbuf()->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+	const auto start		 = std::chrono::steady_clock::now();
+
+	Parser parser(source, mInternal->mLogger, &mInternal->mPool);
+	parser.setFileId(mInternal->mFileId);
+	parser.setMaxDepth(mInternal->mMaxDepth);
+	parser.setMaxErrors(mInternal->mMaxErrors);
+	parser.setStatistics(stats);
+
 	mInternal->mTree = parser.parse();
+
+	stats->ParseTime += DataLisp_Internal::elapsed(start) - (stats->LexTime - lexTime);
+	stats->NodeAllocations += mInternal->mPool.allocationCount() - allocations;
+	stats->PeakTreeMemory = std::max<uint64>(stats->PeakTreeMemory, NodePool::memoryUsage(mInternal->mTree));
+
+	const auto end = source->rdbuf()->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+	if (begin != std::streampos(-1) && end != std::streampos(-1))
+		stats->ParsedBytes += static_cast<uint64>(end - begin);
 }
 
 void DataLisp::parse(const string_t& source)
 {
-	std::stringstream stream(source);
+	if (!mInternal->mCacheDirectory.empty()) {
+		DL_ASSERT(mInternal->mTree == nullptr && !mInternal->mCached.isOpen());
+
+		mInternal->mCacheFile = mInternal->cachePath(source);
+		if (mInternal->mCached.open(mInternal->mCacheFile)) {
+			if (mInternal->mCached.verify()) {
+				mInternal->mCacheFile.clear();
+				if (mInternal->mStatistics)
+					mInternal->mStatistics->ParsedBytes += source.size();
+				return;
+			}
+			mInternal->mCached.close();
+		}
+		mInternal->mCacheErrors = mInternal->mLogger->errorCount();
+	}
+
+	MemoryStreamBuf buffer(source.data(), source.size());
+	stream_t stream(&buffer);
 	parse(&stream);
 }
 
+void DataLisp::setCacheDirectory(const string_t& path)
+{
+	mInternal->mCacheDirectory = path;
+}
+
+const string_t& DataLisp::cacheDirectory() const
+{
+	return mInternal->mCacheDirectory;
+}
+
+void DataLisp::setCacheVersion(const string_t& version)
+{
+	mInternal->mCacheVersion = version;
+}
+
+const string_t& DataLisp::cacheVersion() const
+{
+	return mInternal->mCacheVersion;
+}
+
+string_t DataLisp::cacheEntry(const string_t& source) const
+{
+	DL_ASSERT(!mInternal->mCacheDirectory.empty());
+	return mInternal->cachePath(source);
+}
+
+void DataLisp::setStatistics(Statistics* stats)
+{
+	mInternal->mStatistics = stats;
+}
+
+Statistics* DataLisp::statistics() const
+{
+	return mInternal->mStatistics;
+}
+
+void DataLisp::setFileId(uint32 id)
+{
+	mInternal->mFileId = id;
+}
+
+uint32 DataLisp::fileId() const
+{
+	return mInternal->mFileId;
+}
+
+void DataLisp::setMaxDepth(uint32 depth)
+{
+	DL_ASSERT(depth > 0);
+	mInternal->mMaxDepth = depth;
+}
+
+uint32 DataLisp::maxDepth() const
+{
+	return mInternal->mMaxDepth;
+}
+
+void DataLisp::setMaxErrors(uint32 count)
+{
+	DL_ASSERT(count > 0);
+	mInternal->mMaxErrors = count;
+}
+
+uint32 DataLisp::maxErrors() const
+{
+	return mInternal->mMaxErrors;
+}
+
+void DataLisp::setProfiler(ExpressionProfiler* profiler)
+{
+	mInternal->mProfiler = profiler;
+}
+
+ExpressionProfiler* DataLisp::profiler() const
+{
+	return mInternal->mProfiler;
+}
+
+void DataLisp::setSchema(const Schema* schema)
+{
+	mInternal->mSchema = schema;
+}
+
+const Schema* DataLisp::schema() const
+{
+	return mInternal->mSchema;
+}
+
+bool DataLisp::isCached() const
+{
+	return mInternal->mCached.isOpen();
+}
+
+void DataLisp::reset()
+{
+	mInternal->releaseTree();
+	mInternal->mCached.close();
+	mInternal->mCacheFile.clear();
+}
+
+void DataLisp::releaseMemory()
+{
+	reset();
+	mInternal->mPool.clear();
+}
+
 void DataLisp::build(DataContainer& container)
 {
+	const auto start	 = DataLisp_Internal::startTime(mInternal->mStatistics);
+	const Schema* schema = mInternal->mSchema;
+	if (mInternal->mCached.isOpen()) {
+		mInternal->mCached.toContainer(container);
+		if (mInternal->mStatistics)
+			mInternal->mStatistics->BuildTime += DataLisp_Internal::elapsed(start);
+		if (schema)
+			schema->validate(container, mInternal->mLogger);
+		return;
+	}
+
 	DL_ASSERT(mInternal->mTree);
 
+	const size_t firstGroup = container.getTopGroups().size();
 	VM vm(container, mInternal->mLogger);
+	bool valid = true;
 	for (StatementNode* ptr : mInternal->mTree->Nodes) {
-		container.addTopGroup(mInternal->buildGroup(ptr, vm));
+		DataGroup grp = mInternal->buildGroup(ptr, vm);
+		if (schema && !schema->validate(grp, mInternal->mLogger)) {
+			valid = false;
+			break;
+		}
+		container.addTopGroup(grp);
+	}
+
+	if (schema && valid)
+		schema->validateRequired(container, mInternal->mLogger);
+
+	if (mInternal->mStatistics)
+		mInternal->mStatistics->BuildTime += DataLisp_Internal::elapsed(start);
+
+	mInternal->mLogger->flushRepeated();
+
+	if (!mInternal->mCacheFile.empty()) {
+		if (mInternal->mLogger->errorCount() == mInternal->mCacheErrors)
+			mInternal->storeCache(container, firstGroup);
+		mInternal->mCacheFile.clear();
 	}
 }
 
-string_t DataLisp::generate(const DataContainer& container)
+void DataLisp::build(DataHandler& handler)
 {
+	const auto start	 = DataLisp_Internal::startTime(mInternal->mStatistics);
+	const Schema* schema = mInternal->mSchema;
+
+	// Without a schema expressions are evaluated without access to other top groups.
+	// With a schema every top group is built and validated before its events are reported
+	DataContainer container;
+	bool valid = true;
+	if (mInternal->mCached.isOpen()) {
+		mInternal->mCached.toContainer(container);
+		for (const DataGroup& grp : container.getTopGroups()) {
+			if (schema && !schema->validate(grp, mInternal->mLogger)) {
+				valid = false;
+				break;
+			}
+			handler.visit(Data(string_t(), grp));
+		}
+	} else {
+		DL_ASSERT(mInternal->mTree);
+
+		VM vm(container, mInternal->mLogger);
+		for (StatementNode* ptr : mInternal->mTree->Nodes) {
+			if (!schema) {
+				mInternal->emitGroup(ptr, handler, vm);
+				continue;
+			}
+
+			DataGroup grp = mInternal->buildGroup(ptr, vm);
+			if (!schema->validate(grp, mInternal->mLogger)) {
+				valid = false;
+				break;
+			}
+			container.addTopGroup(grp);
+			handler.visit(Data(string_t(), grp));
+		}
+	}
+
+	if (schema && valid)
+		schema->validateRequired(container, mInternal->mLogger);
+
+	if (mInternal->mStatistics)
+		mInternal->mStatistics->BuildTime += DataLisp_Internal::elapsed(start);
+
+	mInternal->mLogger->flushRepeated();
+
+	// Events are not cached
+	mInternal->mCacheFile.clear();
+}
+
+string_t DataLisp::generate(const DataContainer& container, GenerateMode mode, Statistics* stats)
+{
+	const auto start = DataLisp_Internal::startTime(stats);
+
 	string_t output;
-	for (const DataGroup& grp : container.getTopGroups())
-		output += DataLisp_Internal::generateDataGroup(grp, 0) + "\n";
+	Generator generator(output, nullptr, mode);
+	generator.write(container);
+
+	if (stats) {
+		stats->GenerateTime += DataLisp_Internal::elapsed(start);
+		stats->GeneratedBytes += generator.writtenBytes();
+	}
 
 	return output;
 }
 
+void DataLisp::generate(const DataContainer& container, std::ostream& stream, GenerateMode mode, Statistics* stats)
+{
+	const auto start = DataLisp_Internal::startTime(stats);
+
+	string_t buffer;
+	Generator generator(buffer, &stream, mode);
+	generator.write(container);
+	generator.flush();
+
+	if (stats) {
+		stats->GenerateTime += DataLisp_Internal::elapsed(start);
+		stats->GeneratedBytes += generator.writtenBytes();
+	}
+}
+
 string_t DataLisp::dump()
 {
 	if (!mInternal->mTree) {
@@ -436,9 +794,11 @@ void DataLisp::addExpression(const string_t& name, expr_t handler)
 
 expr_t DataLisp::expression(const string_t& name)
 {
-	if (mInternal->mExpressions.count(name))
-		return mInternal->mExpressions.at(name);
-	else
-		return nullptr;
+	return mInternal->findExpression(name);
+}
+
+const std::shared_ptr<const ExpressionRegistry>& DataLisp::registry() const
+{
+	return mInternal->mRegistry;
 }
 } // namespace DL
\ No newline at end of file
@@ -31,8 +31,16 @@
 
 #include "Data.h"
 #include "DataContainer.h"
+#include "DiagnosticBuffer.h"
 #include "DataGroup.h"
+#include "DataHandler.h"
+#include "ExpressionProfiler.h"
+#include "ExpressionRegistry.h"
+#include "Schema.h"
 #include "SourceLogger.h"
+#include "Statistics.h"
+
+#include <ostream>
 
 /** @mainpage notitle
  * DataLisp is an modular and modable configuration scripting language for C++ and Python.<br>
@@ -52,6 +60,15 @@
  */
 namespace DL {
 class SourceProvider;
+
+/** @enum GenerateMode DataLisp.h DL/DataLisp.h
+ * @brief Layout of generated source code
+ */
+enum GenerateMode {
+	GM_Pretty, ///< Every entry on its own indented line
+	GM_Compact ///< Every top group on a single line without indentation
+};
+
 /** @class DataLisp DataLisp.h DL/DataLisp.h
  * @brief General class to parse or generate %DataLisp source code
  *
@@ -62,6 +79,10 @@ class SourceProvider;
  * afterwards it can be @link build @endlink to fill a DataContainer.<br>
  * Possible expression should be added before filling the container.
  *
+ * A single instance can be used for multiple sources.
+ * Call @link reset @endlink before parsing the next source,
+ * the memory used by the previous syntax tree will be recycled.
+ *
  * @subsection Example
  * @code{.cpp}
  * DL::DataContainer parse_datalisp(const std::string& source, bool& error) {
@@ -97,9 +118,17 @@ public:
 	/**
 	 * @brief Construct the class with a given logging class
 	 * @param log Logging class. Should never be NULL
-	 * @param stdlib Enable the standard library expressions
+	 * @param stdlib Enable the standard library expressions. The shared standard registry will be used
+	 * @see ExpressionRegistry::standard
 	 */
 	explicit DataLisp(SourceLogger* log, bool stdlib = true);
+
+	/**
+	 * @brief Construct the class with a given logging class and a shared expression registry
+	 * @param log Logging class. Should never be NULL
+	 * @param registry A frozen registry. Can be NULL to start without expressions
+	 */
+	DataLisp(SourceLogger* log, const std::shared_ptr<const ExpressionRegistry>& registry);
 	~DataLisp();
 
 	DataLisp(const DataLisp& other) = delete;
@@ -119,6 +148,7 @@ public:
 	 * @brief Parse a string given by a source provider
 
 	 * @attention Parsing errors or warnings will be post to the given SourceLogger instance.
+	 * @attention A previously parsed source has to be discarded with @link reset @endlink first.
 	 * @param source A SourceProvider
 	 * @see build
 	 */
@@ -133,6 +163,164 @@ public:
 	 */
 	void parse(const string_t& source);
 
+	/**
+	 * @brief Enables the parse cache in the given directory
+	 *
+	 * A source given by string is hashed together with the library version,
+	 * the names of all available expressions and the @link setCacheVersion cache version @endlink.
+	 * If a compiled snapshot for the hash is available, it will be loaded
+	 * by @link build @endlink instead of parsing and evaluating the source again.
+	 * Otherwise the built content is written into the cache
+	 * (into a temporary file first, which is renamed afterwards) if no errors occured.
+	 * @attention Expressions are not evaluated again on a cache hit.
+	 * Warnings of the original parse will not be reported again either.
+	 * Replacing an expression under the same name or changing its behaviour is not detected,
+	 * change the cache version or clear the directory in that case.
+	 * @param path Existing directory. An empty path disables the cache
+	 * @see BinaryContainer
+	 */
+	void setCacheDirectory(const string_t& path);
+
+	/**
+	 * @brief Returns the directory of the parse cache. Empty if disabled
+	 */
+	const string_t& cacheDirectory() const;
+
+	/**
+	 * @brief Sets a version included in the hash of all cache entries
+	 *
+	 * Has to be changed whenever the behaviour of a registered expression changes,
+	 * otherwise snapshots evaluated with the old behaviour are still used.
+	 * Empty by default.
+	 * @see setCacheDirectory
+	 */
+	void setCacheVersion(const string_t& version);
+
+	/**
+	 * @brief Returns the version included in the hash of all cache entries
+	 */
+	const string_t& cacheVersion() const;
+
+	/**
+	 * @brief Returns the path of the cache entry for the given source
+	 *
+	 * The entry does not have to exist. Useful to invalidate single entries.
+	 * @attention Only valid if the cache is enabled
+	 */
+	string_t cacheEntry(const string_t& source) const;
+
+	/**
+	 * @brief Returns true if the current content was loaded from the parse cache
+	 */
+	bool isCached() const;
+
+	/**
+	 * @brief Enables per phase timings and counters for parse and build
+	 *
+	 * Measuring has a small overhead per token and expression.
+	 * Without statistics object nothing is measured.
+	 * @param stats Statistics to accumulate into. Can be NULL to disable it. Has to outlive the usage
+	 * @see generate
+	 */
+	void setStatistics(Statistics* stats);
+
+	/**
+	 * @brief Returns the statistics object given by @link setStatistics @endlink. Can be NULL
+	 */
+	Statistics* statistics() const;
+
+	/**
+	 * @brief Sets the id given to all diagnostics reported while parsing and building
+	 *
+	 * Used to distinguish multiple sources reported into a single DiagnosticBuffer.
+	 * @param id Id of the source. Zero by default
+	 * @see Diagnostic
+	 */
+	void setFileId(uint32 id);
+
+	/**
+	 * @brief Returns the id given by @link setFileId @endlink
+	 */
+	uint32 fileId() const;
+
+	/**
+	 * @brief Sets the maximum nesting depth of statements, arrays and expressions
+	 *
+	 * Parsing, building and generating do not recurse per nesting level,
+	 * deeply nested sources therefor do not exhaust the call stack.
+	 * Sources exceeding the depth are rejected with a fatal error and parsing stops.
+	 * @param depth Maximum depth, a top statement has depth one. The default is 1024
+	 */
+	void setMaxDepth(uint32 depth);
+
+	/**
+	 * @brief Returns the maximum nesting depth
+	 * @see setMaxDepth
+	 */
+	uint32 maxDepth() const;
+
+	/**
+	 * @brief Sets the maximum count of syntax errors reported by a single @link parse @endlink
+	 *
+	 * The parser recovers from syntax errors by skipping to the end of the innermost list,
+	 * all following statements are still parsed. After the given count of errors
+	 * a single fatal error is reported and parsing stops.
+	 * @param count Maximum count of errors. The default is 100
+	 */
+	void setMaxErrors(uint32 count);
+
+	/**
+	 * @brief Returns the maximum count of syntax errors
+	 * @see setMaxErrors
+	 */
+	uint32 maxErrors() const;
+
+	/**
+	 * @brief Enables profiling of all expressions evaluated by @link build @endlink
+	 * @param profiler Profiler to record into. Can be NULL to disable it. Has to outlive the usage
+	 */
+	void setProfiler(ExpressionProfiler* profiler);
+
+	/**
+	 * @brief Returns the profiler given by @link setProfiler @endlink. Can be NULL
+	 */
+	ExpressionProfiler* profiler() const;
+
+	/**
+	 * @brief Validates the content while building
+	 *
+	 * Every top group is validated directly after it was built.
+	 * The build stops at the first invalid top group, which is not added to the container.
+	 * Required top groups are checked after all statements were built.
+	 * Content loaded from the cache is validated as a whole.
+	 * @param schema Compiled schema. Can be NULL to disable validation. Has to outlive the usage
+	 */
+	void setSchema(const Schema* schema);
+
+	/**
+	 * @brief Returns the schema given by @link setSchema @endlink. Can be NULL
+	 */
+	const Schema* schema() const;
+
+	/**
+	 * @brief Discards the parsed content, making the instance ready for the next parse
+	 *
+	 * The allocations of the syntax tree are kept and reused by the next parse.
+	 * Registered expressions are kept as well.
+	 * @note Only the syntax tree is recycled. The lexer and parser state, token strings
+	 * too long for the small string buffer and diagnostics are still allocated per parse,
+	 * and building allocates the groups of the container as usual.
+	 * Use Statistics::NodeAllocations to check the reuse of the tree.
+	 * @see releaseMemory
+	 */
+	void reset();
+
+	/**
+	 * @brief Discards the parsed content and frees all recycled memory
+	 * @see reset
+	 */
+	void releaseMemory();
+
 	/**
 	 * @brief Fills a DataContainer with the content parsed beforehand
 
@@ -145,9 +333,25 @@ public:
 	 */
 	void build(DataContainer& container);
 
+	/**
+	 * @brief Reports the content parsed beforehand as events, without building a DataContainer
+	 *
+	 * Only the results of expressions are built as Data.
+	 * If a schema is given by @link setSchema @endlink, every top group is built and validated
+	 * before its events are reported. Reporting stops at the first invalid top group.
+	 * @attention Without a schema, expressions are evaluated against an empty container,
+	 * therefor expressions accessing other top groups by VM::container behave differently to
+	 * @link build(DataContainer&) @endlink. The content is never written into the parse cache.
+	 * @param handler The handler receiving the events
+	 * @see Binder
+	 */
+	void build(DataHandler& handler);
+
 	/**
 	 * @brief Add expression to run when built
 	 *
+	 * The expression is only visible to this instance
+	 * and takes precedence over the expressions of the shared registry.
 	 * @param name Name of the expression. Will replace if already set
 	 * @param handler Callback function to run
 	 * @see build
@@ -163,6 +367,13 @@ public:
 	 */
 	expr_t expression(const string_t& name);
 
+	/**
+	 * @brief Returns the shared expression registry used by this instance
+	 *
+	 * Can be NULL if constructed without expressions.
+	 */
+	const std::shared_ptr<const ExpressionRegistry>& registry() const;
+
 	/**
 	 * @brief Generates a overview of the parsed content
 	 *
@@ -176,8 +387,22 @@ public:
 	 *
 	 * No expression will be in the source.
 	 * @param container A container to whom to construct the source code
+	 * @param mode Layout of the source code
+	 * @param stats Statistics to accumulate the generate time into. Can be NULL
+	 */
+	static string_t generate(const DataContainer& container, GenerateMode mode = GM_Pretty, Statistics* stats = nullptr);
+
+	/**
+	 * @brief Writes source code based on the content of the container into a stream
+	 *
+	 * The source is written in chunks, without building the whole source in memory.
+	 * No expression will be in the source.
+	 * @param container A container to whom to construct the source code
+	 * @param stream Output stream
+	 * @param mode Layout of the source code
+	 * @param stats Statistics to accumulate the generate time into. Can be NULL
 	 */
-	static string_t generate(const DataContainer& container);
+	static void generate(const DataContainer& container, std::ostream& stream, GenerateMode mode = GM_Pretty, Statistics* stats = nullptr);
 
 private:
 	class DataLisp_Internal* mInternal;
@@ -0,0 +1,196 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Diagnostic.h"
+#include "DataType.h"
+#include "Schema.h"
+#include "internal/Parser.h"
+
+namespace DL {
+static const char* typeToName(int32 type)
+{
+	switch (type) {
+	case DT_Bool:
+		return "Bool";
+	case DT_Integer:
+		return "Integer";
+	case DT_Float:
+		return "Float";
+	case DT_String:
+		return "String";
+	case DT_Group:
+		return "Group";
+	case DT_None:
+		return "None";
+	default:
+		return "Unknown";
+	}
+}
+
+static const char* schemaTypeToName(int32 type)
+{
+	switch (type) {
+	case ST_Any:
+		return "Any";
+	case ST_Integer:
+		return "Integer";
+	case ST_Float:
+		return "Float";
+	case ST_Number:
+		return "Number";
+	case ST_Bool:
+		return "Bool";
+	case ST_String:
+		return "String";
+	case ST_Group:
+		return "Group";
+	case ST_Array:
+		return "Array";
+	default:
+		return "Unknown";
+	}
+}
+
+static const char* levelToName(Level level)
+{
+	switch (level) {
+	case L_Debug:
+		return "Debug";
+	case L_Info:
+		return "Info";
+	case L_Warning:
+		return "Warning";
+	case L_Error:
+		return "Error";
+	case L_Fatal:
+		return "Fatal";
+	default:
+		return "Unknown";
+	}
+}
+
+Diagnostic::Diagnostic()
+	: Diagnostic(DC_Message, L_Info)
+{
+}
+
+Diagnostic::Diagnostic(DiagnosticCode code, Level severity, int32 arg0, int32 arg1)
+	: Code(code)
+	, Severity(severity)
+	, FileId(0)
+	, Begin(0)
+	, End(0)
+	, Line(0)
+	, Column(0)
+	, Arguments{ arg0, arg1 }
+{
+}
+
+string_t Diagnostic::message() const
+{
+	// Schema diagnostics refer to an entry instead of a source position
+	const string_t at = Path.empty() ? string_t() : ("'" + Path + "': ");
+
+	switch (Code) {
+	case DC_Message:
+		return Text;
+	case DC_MissingExpressionParanthese:
+		return "No '(' after '$'";
+	case DC_InvalidCharacter:
+		return "Invalid character '" + string_t(1, static_cast<char>(Arguments[0])) + "'";
+	case DC_UnclosedString:
+		return "The string \"" + Text + "\" is not closed";
+	case DC_InvalidEscapeOperator:
+		return "Invalid use of the '\\' operator";
+	case DC_InvalidUnicodeEscape:
+		return "Invalid use of Unicode escape sequence.";
+	case DC_InvalidEscapeSequence:
+		return "Given escape sequence is invalid.";
+	case DC_InvalidUnicodeSequence:
+		return "Given Unicode sequence is invalid.";
+	case DC_InvalidUnicodeRange:
+		return "Invalid Unicode range.";
+	case DC_InvalidNumber:
+		return "Invalid number '" + Text + "'";
+	case DC_UnexpectedToken:
+		return string_t("Expected '") + Parser::tokenToString(static_cast<TokenType>(Arguments[0]))
+			   + "' but got '" + Parser::tokenToString(static_cast<TokenType>(Arguments[1])) + "'";
+	case DC_UnknownLookahead:
+		return string_t("Expected a value but got '") + Parser::tokenToString(static_cast<TokenType>(Arguments[0])) + "'";
+	case DC_MaxDepthExceeded:
+		return "Maximum nesting depth of " + std::to_string(Arguments[0]) + " exceeded";
+	case DC_TooManyErrors:
+		return "Too many errors, stopped after " + std::to_string(Arguments[0]);
+	case DC_UnknownExpression:
+		return "Couldn't find expression '" + Text + "'";
+	case DC_InvalidConversion:
+		return string_t("Can not convert '") + typeToName(Arguments[0]) + "' to '" + typeToName(Arguments[1]) + "'";
+	case DC_ImplicitConversion:
+		return string_t("Implicit conversion from '") + typeToName(Arguments[0]) + "' to '" + typeToName(Arguments[1]) + "'";
+	case DC_InvalidArguments:
+		return "Invalid arguments given for $(" + Text + " ...)";
+	case DC_InvalidCondition:
+		return "Non boolean condition given for $(" + Text + " ...)";
+	case DC_SchemaUnknownGroup:
+		return at + "Unknown group '" + Text + "'";
+	case DC_SchemaMissingGroup:
+		return "Missing required group '" + Text + "'";
+	case DC_SchemaUnknownKey:
+		return at + "Unknown key '" + Text + "'";
+	case DC_SchemaMissingKey:
+		return at + "Missing required key '" + Text + "'";
+	case DC_SchemaDuplicateKey:
+		return at + "Key '" + Text + "' given multiple times";
+	case DC_SchemaUnexpectedAnonymous:
+		return at + "Anonymous entries are not allowed";
+	case DC_SchemaInvalidType:
+		return at + "Expected '" + schemaTypeToName(Arguments[0]) + "' but got '" + typeToName(Arguments[1]) + "'";
+	case DC_SchemaInvalidGroup:
+		return at + "Expected group '" + Text + "'";
+	default:
+		return "Unknown diagnostic";
+	}
+}
+
+string_t Diagnostic::toString() const
+{
+	string_t str;
+	if (FileId != 0)
+		str += std::to_string(FileId) + ":";
+	if (hasPosition())
+		str += std::to_string(Line) + ":" + std::to_string(Column) + ":";
+	if (!str.empty())
+		str += " ";
+
+	str += levelToName(Severity);
+	str += ": ";
+	str += message();
+	return str;
+}
+} // namespace DL
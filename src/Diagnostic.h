@@ -0,0 +1,111 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "SourceLogger.h"
+
+namespace DL {
+/** @enum DiagnosticCode Diagnostic.h DL/Diagnostic.h
+ * @brief Identifies the kind of a Diagnostic
+ */
+enum DiagnosticCode {
+	DC_Message,						///< Free message. Text contains the message
+	DC_MissingExpressionParanthese, ///< No '(' after '$'
+	DC_InvalidCharacter,			///< Unexpected character. Arguments[0] contains the character
+	DC_UnclosedString,				///< String not closed before the end of the line. Text contains the string read so far
+	DC_InvalidEscapeOperator,		///< '\' at the end of the source
+	DC_InvalidUnicodeEscape,		///< Unicode escape sequence cut off
+	DC_InvalidEscapeSequence,		///< Escape sequence is not a hexadecimal number
+	DC_InvalidUnicodeSequence,		///< Escape sequence contains invalid characters
+	DC_InvalidUnicodeRange,			///< Unicode code point out of range
+	DC_InvalidNumber,				///< Number without digits or exponent. Text contains the characters read
+	DC_UnexpectedToken,				///< Arguments[0] contains the expected, Arguments[1] the actual token
+	DC_UnknownLookahead,			///< No value found. Arguments[0] contains the token
+	DC_MaxDepthExceeded,			///< Nesting too deep, parsing stopped. Arguments[0] contains the maximum depth
+	DC_TooManyErrors,				///< Error limit reached, parsing stopped. Arguments[0] contains the maximum count
+	DC_UnknownExpression,			///< Text contains the name of the expression
+	DC_InvalidConversion,			///< Arguments[0] contains the source, Arguments[1] the target DataType
+	DC_ImplicitConversion,			///< Arguments[0] contains the source, Arguments[1] the target DataType
+	DC_InvalidArguments,			///< Text contains the name of the expression
+	DC_InvalidCondition,			///< Text contains the name of the expression
+	DC_SchemaUnknownGroup,			///< Top group without definition. Text contains the id
+	DC_SchemaMissingGroup,			///< Required top group not found. Text contains the id
+	DC_SchemaUnknownKey,			///< Named entry without definition. Text contains the key
+	DC_SchemaMissingKey,			///< Required named entry not found. Text contains the key
+	DC_SchemaDuplicateKey,			///< Named entry given multiple times. Text contains the key
+	DC_SchemaUnexpectedAnonymous,	///< Anonymous entry in a group not allowing them
+	DC_SchemaInvalidType,			///< Arguments[0] contains the expected SchemaType, Arguments[1] the actual DataType
+	DC_SchemaInvalidGroup			///< Group with the wrong id. Text contains the expected id
+};
+
+/**
+ * @brief A single message of the lexer, parser or build step
+ *
+ * The message is stored in its compact form and only formatted on demand.
+ * @see DiagnosticBuffer
+ */
+struct DL_LIB Diagnostic {
+	DiagnosticCode Code; ///< Kind of the diagnostic
+	Level Severity;		 ///< Importance level
+	uint32 FileId;		 ///< Id of the source given by DataLisp::setFileId
+	uint32 Begin;		 ///< Byte offset of the first character the diagnostic refers to
+	uint32 End;			 ///< Byte offset after the last character the diagnostic refers to
+	line_t Line;		 ///< Line the diagnostic is reported at. Zero if unknown
+	column_t Column;	 ///< Column the diagnostic is reported at. Zero if unknown
+	int32 Arguments[2];	 ///< Numeric payload, depending on the code
+	string_t Text;		 ///< Textual payload, depending on the code
+	string_t Path;		 ///< Path of the entry inside the container. Only used by schema diagnostics
+
+	Diagnostic();
+
+	/**
+	 * @brief Constructs a diagnostic without position
+	 */
+	Diagnostic(DiagnosticCode code, Level severity, int32 arg0 = 0, int32 arg1 = 0);
+
+	/**
+	 * @brief Returns true if the diagnostic refers to a position in the source
+	 */
+	inline bool hasPosition() const { return Line != 0; }
+
+	/**
+	 * @brief Formats the message, without position and level
+	 */
+	string_t message() const;
+
+	/**
+	 * @brief Formats the diagnostic as single line
+	 *
+	 * The format is 'FileId:Line:Column: Level: Message'.
+	 * Unknown parts are omitted.
+	 */
+	string_t toString() const;
+};
+} // namespace DL
@@ -0,0 +1,96 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "DiagnosticBuffer.h"
+
+namespace DL {
+DiagnosticBuffer::DiagnosticBuffer()
+{
+}
+
+DiagnosticBuffer::~DiagnosticBuffer()
+{
+}
+
+void DiagnosticBuffer::log(line_t line, column_t column, Level level, const string_t& str)
+{
+	Diagnostic diagnostic(DC_Message, level);
+	diagnostic.Line	  = line;
+	diagnostic.Column = column;
+	diagnostic.Text	  = str;
+	report(diagnostic);
+}
+
+void DiagnosticBuffer::log(Level level, const string_t& str)
+{
+	Diagnostic diagnostic(DC_Message, level);
+	diagnostic.Text = str;
+	report(diagnostic);
+}
+
+void DiagnosticBuffer::report(const Diagnostic& diagnostic)
+{
+	count(diagnostic.Severity);
+	if (!enabled(diagnostic.Severity))
+		return;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mDiagnostics.push_back(diagnostic);
+}
+
+vector_t<Diagnostic> DiagnosticBuffer::diagnostics() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mDiagnostics;
+}
+
+size_t DiagnosticBuffer::size() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mDiagnostics.size();
+}
+
+void DiagnosticBuffer::clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mDiagnostics.clear();
+}
+
+string_t DiagnosticBuffer::toString() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	string_t str;
+	for (const Diagnostic& d : mDiagnostics) {
+		str += d.toString();
+		str += '\n';
+	}
+	return str;
+}
+} // namespace DL
@@ -0,0 +1,91 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Diagnostic.h"
+
+#include <mutex>
+
+namespace DL {
+/** @class DiagnosticBuffer DiagnosticBuffer.h DL/DiagnosticBuffer.h
+ * @brief Logger recording all messages as structured diagnostics
+ *
+ * Nothing is formatted while parsing or building.
+ * Plain messages given by @link log @endlink are recorded as @link DC_Message @endlink.
+ * Messages below the minimum level are only counted.
+ *
+ * A single buffer can be shared by multiple DataLisp instances running concurrently.
+ * Use DataLisp::setFileId to distinguish the sources.
+ * @attention The repeat limit of the SourceLogger is not thread safe and should not be used with a shared buffer
+ *
+ * @subsection Example
+ * @code{.cpp}
+ * DL::DiagnosticBuffer diagnostics;
+ * DL::DataLisp datalisp(&diagnostics);
+ * datalisp.parse(source);
+ * for (const DL::Diagnostic& d : diagnostics.diagnostics())
+ *   mark(d.Begin, d.End, d.message());
+ * @endcode
+ */
+class DL_LIB DiagnosticBuffer : public SourceLogger {
+public:
+	DiagnosticBuffer();
+	~DiagnosticBuffer();
+
+	void log(line_t line, column_t column, Level level, const string_t& str) override;
+	void log(Level level, const string_t& str) override;
+	void report(const Diagnostic& diagnostic) override;
+
+	/**
+	 * @brief Returns a copy of all recorded diagnostics in order of arrival
+	 */
+	vector_t<Diagnostic> diagnostics() const;
+
+	/**
+	 * @brief Returns the number of recorded diagnostics
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief Discards all recorded diagnostics. The counters are kept
+	 */
+	void clear();
+
+	/**
+	 * @brief Formats all recorded diagnostics, one per line
+	 * @see Diagnostic::toString
+	 */
+	string_t toString() const;
+
+private:
+	mutable std::mutex mMutex;
+	vector_t<Diagnostic> mDiagnostics;
+};
+} // namespace DL
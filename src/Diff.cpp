@@ -0,0 +1,234 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Diff.h"
+#include "DataContainer.h"
+
+#include <algorithm>
+
+namespace DL {
+class DL_INTERNAL_LIB DiffBuilder {
+public:
+	explicit DiffBuilder(vector_t<DiffEntry>& entries)
+		: mEntries(entries)
+	{
+	}
+
+	void compareContainers(const DataContainer& a, const DataContainer& b)
+	{
+		const vector_t<DataGroup>& oldGroups = a.getTopGroups();
+		const vector_t<DataGroup>& newGroups = b.getTopGroups();
+
+		vector_t<Data> oldEntries, newEntries;
+		oldEntries.reserve(oldGroups.size());
+		newEntries.reserve(newGroups.size());
+		for (const DataGroup& grp : oldGroups)
+			oldEntries.push_back(Data(string_t(), grp));
+		for (const DataGroup& grp : newGroups)
+			newEntries.push_back(Data(string_t(), grp));
+
+		compareGroupLists(string_t(), oldEntries, newEntries);
+	}
+
+private:
+	static bool skip(const DataGroup& a, const DataGroup& b)
+	{
+		return a.shares(b) || (a.isFrozen() && b.isFrozen() && a.hash() == b.hash());
+	}
+
+	static bool equalValues(const Data& a, const Data& b)
+	{
+		if (a.type() != b.type())
+			return false;
+
+		switch (a.type()) {
+		case DT_Integer:
+			return a.getInt() == b.getInt();
+		case DT_Float:
+			return a.getFloat() == b.getFloat();
+		case DT_Bool:
+			return a.getBool() == b.getBool();
+		case DT_String:
+			return a.getString() == b.getString();
+		default:
+			return true;
+		}
+	}
+
+	static bool isIdentified(const Data& d)
+	{
+		return d.type() == DT_Group && !d.getGroup().isArray();
+	}
+
+	static string_t join(const string_t& path, const string_t& step)
+	{
+		return path.empty() ? step : path + "/" + step;
+	}
+
+	static string_t occurrence(const string_t& name, size_t n)
+	{
+		return n == 0 ? name : name + "[" + std::to_string(n) + "]";
+	}
+
+	void add(DiffType type, const string_t& path, const Data& a, const Data& b)
+	{
+		mEntries.push_back(DiffEntry{ type, path, a, b });
+	}
+
+	void compareEntries(const string_t& path, const Data& a, const Data& b)
+	{
+		if (a.type() == DT_Group && b.type() == DT_Group) {
+			const DataGroup& ga = a.getGroup();
+			const DataGroup& gb = b.getGroup();
+			if (skip(ga, gb))
+				return;
+
+			if (ga.id() != gb.id())
+				add(DFT_Changed, path, a, b);
+			else
+				compareGroups(path, ga, gb);
+		} else if (!equalValues(a, b)) {
+			add(DFT_Changed, path, a, b);
+		}
+	}
+
+	void compareGroups(const string_t& path, const DataGroup& a, const DataGroup& b)
+	{
+		// Anonymous groups with an id are paired by id, everything else by position among the values.
+		// Paths use the position inside all anonymous entries, of the old group if available
+		const vector_t<Data>& oldEntries = a.getAnonymousEntries();
+		const vector_t<Data>& newEntries = b.getAnonymousEntries();
+
+		vector_t<Data> oldGroups, newGroups;
+		vector_t<size_t> oldValues, newValues;
+		for (size_t i = 0; i < oldEntries.size(); ++i) {
+			if (isIdentified(oldEntries[i]))
+				oldGroups.push_back(oldEntries[i]);
+			else
+				oldValues.push_back(i);
+		}
+		for (size_t i = 0; i < newEntries.size(); ++i) {
+			if (isIdentified(newEntries[i]))
+				newGroups.push_back(newEntries[i]);
+			else
+				newValues.push_back(i);
+		}
+
+		compareGroupLists(path, oldGroups, newGroups);
+
+		auto step			= [&](size_t position) { return join(path, "[" + std::to_string(position) + "]"); };
+		const size_t common = std::min(oldValues.size(), newValues.size());
+		for (size_t i = 0; i < common; ++i)
+			compareEntries(step(oldValues[i]), oldEntries[oldValues[i]], newEntries[newValues[i]]);
+		for (size_t i = common; i < oldValues.size(); ++i)
+			add(DFT_Removed, step(oldValues[i]), oldEntries[oldValues[i]], Data());
+		for (size_t i = common; i < newValues.size(); ++i)
+			add(DFT_Added, step(newValues[i]), Data(), newEntries[newValues[i]]);
+
+		compareNamed(path, a.getNamedEntries(), b.getNamedEntries());
+	}
+
+	// Pairs the n-th occurrence of a name in both lists
+	template <typename NameFunc>
+	static void pair(const vector_t<Data>& a, const vector_t<Data>& b, NameFunc name,
+					 vector_t<size_t>& pairs, vector_t<size_t>& occurrences)
+	{
+		map_t<string_t, vector_t<size_t>> positions;
+		for (size_t i = 0; i < b.size(); ++i)
+			positions[name(b[i])].push_back(i);
+
+		map_t<string_t, size_t> counts;
+		pairs.assign(a.size(), b.size());
+		occurrences.assign(a.size(), 0);
+		for (size_t i = 0; i < a.size(); ++i) {
+			const string_t& n = name(a[i]);
+			const size_t k	  = counts[n]++;
+			occurrences[i]	  = k;
+
+			auto it = positions.find(n);
+			if (it != positions.end() && k < it->second.size())
+				pairs[i] = it->second[k];
+		}
+	}
+
+	void compareGroupLists(const string_t& path, const vector_t<Data>& a, const vector_t<Data>& b)
+	{
+		auto name = [](const Data& d) { return d.getGroup().id(); };
+		compareLists(path, a, b, name, false);
+	}
+
+	void compareNamed(const string_t& path, const vector_t<Data>& a, const vector_t<Data>& b)
+	{
+		auto name = [](const Data& d) { return d.key(); };
+		compareLists(path, a, b, name, true);
+	}
+
+	template <typename NameFunc>
+	void compareLists(const string_t& path, const vector_t<Data>& a, const vector_t<Data>& b, NameFunc name, bool named)
+	{
+		vector_t<size_t> pairs, occurrences;
+		pair(a, b, name, pairs, occurrences);
+
+		auto step = [&](const string_t& n, size_t k) { return join(path, occurrence(named ? ":" + n : n, k)); };
+
+		vector_t<bool> paired(b.size(), false);
+		for (size_t i = 0; i < a.size(); ++i) {
+			if (pairs[i] < b.size()) {
+				paired[pairs[i]] = true;
+				compareEntries(step(name(a[i]), occurrences[i]), a[i], b[pairs[i]]);
+			} else {
+				add(DFT_Removed, step(name(a[i]), occurrences[i]), a[i], Data());
+			}
+		}
+
+		map_t<string_t, size_t> counts;
+		for (size_t i = 0; i < b.size(); ++i) {
+			const size_t k = counts[name(b[i])]++;
+			if (!paired[i])
+				add(DFT_Added, step(name(b[i]), k), Data(), b[i]);
+		}
+	}
+
+	vector_t<DiffEntry>& mEntries;
+};
+
+//---------------------------------------------------
+void Diff::compare(const DataContainer& oldContainer, const DataContainer& newContainer, vector_t<DiffEntry>& entries)
+{
+	DiffBuilder builder(entries);
+	builder.compareContainers(oldContainer, newContainer);
+}
+
+vector_t<DiffEntry> Diff::compare(const DataContainer& oldContainer, const DataContainer& newContainer)
+{
+	vector_t<DiffEntry> entries;
+	compare(oldContainer, newContainer, entries);
+	return entries;
+}
+} // namespace DL
@@ -0,0 +1,85 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Data.h"
+
+namespace DL {
+class DataContainer;
+
+/// Kind of a difference
+enum DiffType {
+	DFT_Added,	 ///< Entry only available in the new container
+	DFT_Removed, ///< Entry only available in the old container
+	DFT_Changed	 ///< Entry available in both containers with different values
+};
+
+/** @class DiffEntry Diff.h DL/Diff.h
+ * @brief Single difference between two containers
+ */
+struct DL_LIB DiffEntry {
+	DiffType Type;
+	string_t Path; ///< Path of the entry in Selector syntax
+	Data Old;	   ///< Old value. Invalid if added. Empty key for top groups
+	Data New;	   ///< New value. Invalid if removed. Empty key for top groups
+};
+
+/** @class Diff Diff.h DL/Diff.h
+ * @brief Structural comparison of two containers
+ *
+ * Top groups and anonymous child groups are paired by their id and order of appearance,
+ * named entries by their key and order of appearance and all other anonymous entries by position.
+ * The path of every difference uses the Selector syntax, later occurrences of the same name carry their index.
+ * Anonymous values carry their position inside all anonymous entries, of the old group for changed entries.
+ * Apart from named entries with duplicated keys, paths can be evaluated by a Selector
+ * on the old container, or on the new container for added entries.
+ *
+ * Groups sharing their content or frozen groups with the same hash are skipped without visiting them,
+ * therefor comparing frozen containers only takes time proportional to the changed parts.
+ * @see DataGroup::hash
+ */
+class DL_LIB Diff {
+public:
+	/**
+	 * @brief Compares two containers
+	 * @param oldContainer The previous version
+	 * @param newContainer The current version
+	 * @param entries List the differences are added to. Will not be cleared!
+	 */
+	static void compare(const DataContainer& oldContainer, const DataContainer& newContainer, vector_t<DiffEntry>& entries);
+
+	/**
+	 * @brief Compares two containers
+	 * @return All differences
+	 * @see compare
+	 */
+	static vector_t<DiffEntry> compare(const DataContainer& oldContainer, const DataContainer& newContainer);
+};
+} // namespace DL
@@ -0,0 +1,160 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "ExpressionProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace DL {
+static inline uint64 now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ExpressionProfiler::ExpressionProfiler()
+{
+	reset();
+}
+
+void ExpressionProfiler::reset()
+{
+	DL_ASSERT(mStack.empty());
+
+	mEntries.clear();
+	mActive.clear();
+	mEntryIndex.clear();
+
+	mNodes.clear();
+	mNodes.push_back(CallNode{ 0, 0, 0, {} });
+}
+
+void ExpressionProfiler::enter(const string_t& name, line_t line, column_t column)
+{
+	auto key = std::make_tuple(name, line, column);
+	auto it	 = mEntryIndex.find(key);
+
+	size_t entry;
+	if (it != mEntryIndex.end()) {
+		entry = it->second;
+	} else {
+		entry = mEntries.size();
+		mEntries.push_back(ProfileEntry{ name, line, column, 0, 0, 0 });
+		mActive.push_back(0);
+		mEntryIndex.emplace(std::move(key), entry);
+	}
+
+	const size_t parent = mStack.empty() ? 0 : mStack.back().Node;
+	auto child			= mNodes[parent].Children.find(entry);
+
+	size_t node;
+	if (child != mNodes[parent].Children.end()) {
+		node = child->second;
+	} else {
+		node = mNodes.size();
+		mNodes.push_back(CallNode{ entry, parent, 0, {} });
+		mNodes[parent].Children.emplace(entry, node);
+	}
+
+	++mEntries[entry].Calls;
+	++mActive[entry];
+	mStack.push_back(Frame{ node, now(), 0 });
+}
+
+void ExpressionProfiler::leave()
+{
+	DL_ASSERT(!mStack.empty());
+
+	const Frame frame = mStack.back();
+	mStack.pop_back();
+
+	const uint64 total = now() - frame.Start;
+	const uint64 self  = total > frame.ChildTime ? total - frame.ChildTime : 0;
+
+	CallNode& node		= mNodes[frame.Node];
+	ProfileEntry& entry = mEntries[node.Entry];
+	node.SelfTime += self;
+	entry.SelfTime += self;
+
+	if (--mActive[node.Entry] == 0)
+		entry.TotalTime += total;
+
+	if (!mStack.empty())
+		mStack.back().ChildTime += total;
+}
+
+string_t ExpressionProfiler::flatProfile() const
+{
+	vector_t<const ProfileEntry*> sorted;
+	sorted.reserve(mEntries.size());
+	for (const ProfileEntry& entry : mEntries)
+		sorted.push_back(&entry);
+
+	std::stable_sort(sorted.begin(), sorted.end(), [](const ProfileEntry* a, const ProfileEntry* b) {
+		return a->SelfTime > b->SelfTime;
+	});
+
+	string_t out = "      Self(ns)      Total(ns)      Calls  Expression\n";
+	char buffer[128];
+	for (const ProfileEntry* entry : sorted) {
+		std::snprintf(buffer, sizeof(buffer), "%14llu %14llu %10llu  ",
+					  static_cast<unsigned long long>(entry->SelfTime),
+					  static_cast<unsigned long long>(entry->TotalTime),
+					  static_cast<unsigned long long>(entry->Calls));
+		out += buffer;
+		out += entry->Name + " (" + std::to_string(entry->Line) + ":" + std::to_string(entry->Column) + ")\n";
+	}
+
+	return out;
+}
+
+void ExpressionProfiler::writeStacks(string_t& out, size_t node, const string_t& prefix) const
+{
+	for (const auto& p : mNodes[node].Children) {
+		const CallNode& child	  = mNodes[p.second];
+		const ProfileEntry& entry = mEntries[child.Entry];
+
+		string_t path = prefix;
+		if (!path.empty())
+			path += ';';
+		path += entry.Name + "@" + std::to_string(entry.Line) + ":" + std::to_string(entry.Column);
+
+		out += path + " " + std::to_string(child.SelfTime) + "\n";
+		writeStacks(out, p.second, path);
+	}
+}
+
+string_t ExpressionProfiler::collapsedStacks() const
+{
+	string_t out;
+	writeStacks(out, 0, "");
+	return out;
+}
+} // namespace DL
@@ -0,0 +1,125 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "SourceLogger.h"
+
+#include <tuple>
+
+namespace DL {
+/**
+ * @brief Profile of a single expression call site
+ * @see ExpressionProfiler
+ */
+struct DL_LIB ProfileEntry {
+	string_t Name;	  ///< Name of the expression
+	line_t Line;	  ///< Line of the call site
+	column_t Column;  ///< Column of the call site
+	uint64 Calls;	  ///< Number of evaluations
+	uint64 SelfTime;  ///< Time spent in the expression itself in nanoseconds
+	uint64 TotalTime; ///< Time spent including the nested expressions of its arguments in nanoseconds
+};
+
+/** @class ExpressionProfiler ExpressionProfiler.h DL/ExpressionProfiler.h
+ * @brief Records call counts and times of all expressions evaluated by DataLisp::build
+ *
+ * Every call site, an expression name together with its source position, is recorded separately.
+ * The total time of an expression includes building its arguments,
+ * the self time excludes the time spent in nested expressions.
+ * Recursive calls of the same call site are only counted once in the total time.
+ *
+ * @subsection Example
+ * @code{.cpp}
+ * DL::ExpressionProfiler profiler;
+ * datalisp.setProfiler(&profiler);
+ * datalisp.build(container);
+ * std::cout << profiler.flatProfile();
+ * @endcode
+ * @see DataLisp::setProfiler
+ */
+class DL_LIB ExpressionProfiler {
+public:
+	ExpressionProfiler();
+
+	/**
+	 * @brief Discards all recorded data
+	 * @attention Should not be called while building
+	 */
+	void reset();
+
+	/**
+	 * @brief Returns all call sites in order of their first evaluation
+	 */
+	inline const vector_t<ProfileEntry>& entries() const { return mEntries; }
+
+	/**
+	 * @brief Returns a table of all call sites sorted by self time
+	 */
+	string_t flatProfile() const;
+
+	/**
+	 * @brief Returns the self times of all call stacks in collapsed stack format
+	 *
+	 * Each line contains the frames separated by ';' followed by the self time in nanoseconds.
+	 * A frame is written as name\@line:column.
+	 * The output can be used directly by flame graph tools.
+	 */
+	string_t collapsedStacks() const;
+
+private:
+	friend class DataLisp_Internal;
+
+	// Called by DataLisp around each expression
+	void enter(const string_t& name, line_t line, column_t column);
+	void leave();
+
+	struct CallNode {
+		size_t Entry;
+		size_t Parent;
+		uint64 SelfTime;
+		map_t<size_t, size_t> Children; // Entry -> Node
+	};
+
+	struct Frame {
+		size_t Node;
+		uint64 Start;
+		uint64 ChildTime;
+	};
+
+	void writeStacks(string_t& out, size_t node, const string_t& prefix) const;
+
+	vector_t<ProfileEntry> mEntries;
+	vector_t<uint32> mActive; // Recursion depth per entry
+	map_t<std::tuple<string_t, line_t, column_t>, size_t> mEntryIndex;
+
+	vector_t<CallNode> mNodes; // First node is the root
+	vector_t<Frame> mStack;
+};
+} // namespace DL
@@ -0,0 +1,195 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "ExpressionRegistry.h"
+#include "internal/Expressions.h"
+#include "internal/Hash.h"
+
+#include <algorithm>
+
+namespace DL {
+constexpr uint32 MAX_DISPLACEMENT = 1 << 16;
+constexpr size_t BUCKET_SIZE	  = 4;
+
+static inline size_t slotOf(uint64 h, uint32 displacement, size_t slotCount)
+{
+	return hashCombine(h, displacement) % slotCount;
+}
+
+ExpressionRegistry::ExpressionRegistry()
+	: mFrozen(false)
+{
+}
+
+ExpressionRegistry::~ExpressionRegistry()
+{
+}
+
+std::shared_ptr<const ExpressionRegistry> ExpressionRegistry::standard()
+{
+	static const std::shared_ptr<const ExpressionRegistry> registry = []() {
+		std::shared_ptr<ExpressionRegistry> r = std::make_shared<ExpressionRegistry>();
+		r->addStandardLibrary();
+		r->freeze();
+		return r;
+	}();
+
+	return registry;
+}
+
+void ExpressionRegistry::addStandardLibrary()
+{
+	DL_ASSERT(!mFrozen);
+
+	for (const auto& p : Expressions::getStdLib())
+		mExpressions[p.first] = p.second;
+}
+
+void ExpressionRegistry::add(const string_t& name, expr_t handler)
+{
+	DL_ASSERT(!mFrozen);
+	mExpressions[name] = handler;
+}
+
+void ExpressionRegistry::freeze()
+{
+	if (mFrozen)
+		return;
+
+	mFrozen = true;
+
+	// Start with a load factor of ~0.8 and grow on the (unlikely) failure
+	const size_t count = mExpressions.size();
+	if (count == 0)
+		return;
+
+	for (size_t slotCount = count + count / 4 + 1; slotCount < 16 * count + 16; slotCount *= 2) {
+		if (buildTable(slotCount))
+			return;
+	}
+
+	// Keep the ordered map as lookup, it is immutable anyway
+	mSlots.clear();
+	mDisplacements.clear();
+}
+
+/* Hash and displace construction:
+ * Keys are distributed into buckets by their hash.
+ * Starting with the largest bucket, a displacement is searched
+ * which places all keys of the bucket into free slots.
+ */
+bool ExpressionRegistry::buildTable(size_t slotCount)
+{
+	const size_t bucketCount = (mExpressions.size() + BUCKET_SIZE - 1) / BUCKET_SIZE;
+
+	struct Key {
+		const string_t* Name;
+		expr_t Handler;
+		uint64 Hash;
+	};
+
+	vector_t<vector_t<Key>> buckets(bucketCount);
+	for (const auto& p : mExpressions) {
+		const uint64 h = hashString(p.first);
+		buckets[h % bucketCount].push_back(Key{ &p.first, p.second, h });
+	}
+
+	vector_t<size_t> order(bucketCount);
+	for (size_t i = 0; i < bucketCount; ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		return buckets[a].size() > buckets[b].size();
+	});
+
+	vector_t<bool> used(slotCount, false);
+	vector_t<size_t> positions;
+	mDisplacements.assign(bucketCount, 0);
+	mSlots.assign(slotCount, Slot{ string_t(), nullptr });
+
+	for (size_t b : order) {
+		const vector_t<Key>& bucket = buckets[b];
+		if (bucket.empty())
+			break;
+
+		bool placed = false;
+		for (uint32 d = 0; d < MAX_DISPLACEMENT && !placed; ++d) {
+			positions.clear();
+			placed = true;
+			for (const Key& key : bucket) {
+				const size_t pos = slotOf(key.Hash, d, slotCount);
+				if (used[pos] || std::find(positions.begin(), positions.end(), pos) != positions.end()) {
+					placed = false;
+					break;
+				}
+				positions.push_back(pos);
+			}
+
+			if (placed) {
+				mDisplacements[b] = d;
+				for (size_t i = 0; i < bucket.size(); ++i) {
+					used[positions[i]]	 = true;
+					mSlots[positions[i]] = Slot{ *bucket[i].Name, bucket[i].Handler };
+				}
+			}
+		}
+
+		if (!placed)
+			return false;
+	}
+
+	return true;
+}
+
+expr_t ExpressionRegistry::find(const string_t& name) const
+{
+	if (!mSlots.empty()) {
+		const uint64 h		= hashString(name);
+		const uint32 d		= mDisplacements[h % mDisplacements.size()];
+		const Slot& slot	= mSlots[slotOf(h, d, mSlots.size())];
+		return slot.Name == name ? slot.Handler : nullptr;
+	}
+
+	auto it = mExpressions.find(name);
+	return it != mExpressions.end() ? it->second : nullptr;
+}
+
+size_t ExpressionRegistry::size() const
+{
+	return mExpressions.size();
+}
+
+vector_t<string_t> ExpressionRegistry::names() const
+{
+	vector_t<string_t> list;
+	list.reserve(mExpressions.size());
+	for (const auto& p : mExpressions)
+		list.push_back(p.first);
+	return list;
+}
+} // namespace DL
@@ -0,0 +1,129 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLispConfig.h"
+
+#include <memory>
+
+namespace DL {
+/** @class ExpressionRegistry ExpressionRegistry.h DL/ExpressionRegistry.h
+ * @brief Set of expressions which can be shared by multiple DataLisp instances
+ *
+ * A registry is filled with @link add @endlink and afterwards frozen with @link freeze @endlink.
+ * A frozen registry is immutable and lookups use a perfect hash table built at freeze time.
+ * Therefor a frozen registry can be used by any number of DataLisp instances on any thread
+ * without locking.
+ *
+ * @subsection Example
+ * @code{.cpp}
+ * auto registry = std::make_shared<DL::ExpressionRegistry>();
+ * registry->addStandardLibrary();
+ * registry->add("env", env_func);
+ * registry->freeze();
+ *
+ * // On any thread
+ * DL::DataLisp datalisp(&logger, registry);
+ * @endcode
+ * @attention Adding expressions is not thread safe and only possible before freezing.
+ */
+class DL_LIB ExpressionRegistry {
+public:
+	ExpressionRegistry();
+	~ExpressionRegistry();
+
+	ExpressionRegistry(const ExpressionRegistry& other) = delete;
+	ExpressionRegistry& operator=(const ExpressionRegistry& other) = delete;
+
+	/**
+	 * @brief Returns the frozen registry containing the standard library expressions
+	 *
+	 * The registry is created once and shared by all callers.
+	 */
+	static std::shared_ptr<const ExpressionRegistry> standard();
+
+	/**
+	 * @brief Adds all standard library expressions
+	 * @attention Only allowed before freezing
+	 */
+	void addStandardLibrary();
+
+	/**
+	 * @brief Adds an expression
+	 *
+	 * @param name Name of the expression. Will replace if already set
+	 * @param handler Callback function to run
+	 * @attention Only allowed before freezing
+	 */
+	void add(const string_t& name, expr_t handler);
+
+	/**
+	 * @brief Makes the registry immutable and builds the lookup table
+	 */
+	void freeze();
+
+	/**
+	 * @brief Returns true if the registry was frozen already
+	 */
+	inline bool isFrozen() const { return mFrozen; }
+
+	/**
+	 * @brief Returns callback function of an expression
+	 *
+	 * @param name Name of the expression
+	 * @return Callback of the expression. Can be NULL if not found
+	 */
+	expr_t find(const string_t& name) const;
+
+	/**
+	 * @brief Amount of registered expressions
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief Names of all registered expressions in lexicographical order
+	 */
+	vector_t<string_t> names() const;
+
+private:
+	struct Slot {
+		string_t Name;
+		expr_t Handler;
+	};
+
+	bool buildTable(size_t slotCount);
+
+	map_t<string_t, expr_t> mExpressions;
+	bool mFrozen;
+
+	vector_t<Slot> mSlots;
+	vector_t<uint32> mDisplacements;
+};
+} // namespace DL
@@ -0,0 +1,307 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "FileLoader.h"
+#include "Data.h"
+#include "DataLisp.h"
+#include "internal/BufferedLogger.h"
+#include "internal/FileSystem.h"
+#include "internal/ForwardLogger.h"
+#include "internal/StatementScanner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+
+namespace DL {
+struct DL_INTERNAL_LIB LoadedItem {
+	DataGroup Group;
+	string_t IncludePath; // Canonical path. Empty if the item is a group or the include was not found
+	line_t Line;
+};
+
+struct DL_INTERNAL_LIB LoadedFile {
+	int64 ModificationTime = 0;
+	vector_t<LoadedItem> Items;
+	bool Success = false;
+};
+
+struct DL_INTERNAL_LIB LoadTask {
+	string_t Path;
+	uint32 FileId;
+	std::shared_ptr<const LoadedFile> File;
+	BufferedLogger Logger;
+};
+
+struct DL_INTERNAL_LIB IncludeLink {
+	const string_t* Path;
+	line_t Line;
+};
+
+class DL_INTERNAL_LIB FileLoader_Internal {
+public:
+	typedef map_t<string_t, std::shared_ptr<const LoadedFile>> FileMap;
+
+	FileLoader_Internal(SourceLogger* logger, const std::shared_ptr<const ExpressionRegistry>& registry)
+		: mLogger(logger)
+		, mRegistry(registry)
+		, mThreadCount(0)
+		, mParsedCount(0)
+	{
+	}
+
+	static bool isIncludeDirective(const DataGroup& grp)
+	{
+		return grp.id() == "include" && grp.getNamedEntries().empty() && grp.isAllAnonymousOfType(DT_String);
+	}
+
+	void loadFile(LoadTask& task) const
+	{
+		std::shared_ptr<LoadedFile> file = std::make_shared<LoadedFile>();
+		task.File						 = file;
+
+		string_t source;
+		if (!modificationTime(task.Path, file->ModificationTime) || !readFile(task.Path, source)) {
+			task.Logger.log(L_Error, "Couldn't read file");
+			return;
+		}
+
+		DataLisp lisp(&task.Logger, mRegistry);
+		lisp.setFileId(task.FileId);
+		DataContainer container;
+		lisp.parse(source);
+		if (task.Logger.errorCount() == 0)
+			lisp.build(container);
+
+		// Every statement builds exactly one top group
+		const vector_t<DataGroup>& groups = container.getTopGroups();
+		vector_t<StatementRange> ranges;
+		const bool hasLines = scanStatements(source.data(), source.size(), ranges) && ranges.size() == groups.size();
+
+		const string_t directory = directoryOf(task.Path);
+		for (size_t i = 0; i < groups.size(); ++i) {
+			const line_t line = hasLines ? ranges[i].Line : 0;
+			if (!isIncludeDirective(groups[i])) {
+				// Cached groups are shared between loads and have to stay unchanged
+				DataGroup grp = groups[i];
+				grp.freeze();
+				file->Items.push_back(LoadedItem{ grp, string_t(), line });
+				continue;
+			}
+
+			for (const Data& d : groups[i].getAnonymousEntries()) {
+				const string_t path = canonicalPath(resolvePath(directory, d.getString()));
+				if (path.empty())
+					task.Logger.log(line, hasLines ? ranges[i].Column : 0, L_Error, "Couldn't find included file '" + d.getString() + "'");
+				else
+					file->Items.push_back(LoadedItem{ DataGroup(), path, line });
+			}
+		}
+
+		file->Success = task.Logger.errorCount() == 0;
+	}
+
+	void runTasks(vector_t<LoadTask>& tasks) const
+	{
+		const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+		const size_t count	  = std::min(tasks.size(), mThreadCount == 0 ? hardware : mThreadCount);
+		if (count <= 1) {
+			for (LoadTask& task : tasks)
+				loadFile(task);
+			return;
+		}
+
+		std::atomic<size_t> next(0);
+		vector_t<std::thread> workers;
+		workers.reserve(count);
+		for (size_t t = 0; t < count; ++t) {
+			workers.emplace_back([&]() {
+				for (size_t i = next++; i < tasks.size(); i = next++)
+					loadFile(tasks[i]);
+			});
+		}
+
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	// Loads all files reachable from the root, one include depth per wave
+	void loadAll(const string_t& root, FileMap& files, SourceLogger* logger)
+	{
+		vector_t<string_t> wave{ root };
+		while (!wave.empty()) {
+			vector_t<LoadTask> tasks;
+			tasks.reserve(wave.size());
+			for (const string_t& path : wave) {
+				auto it = mCache.find(path);
+				int64 time;
+				if (it != mCache.end() && modificationTime(path, time) && time == it->second->ModificationTime) {
+					files[path] = it->second;
+				} else {
+					tasks.emplace_back();
+					tasks.back().Path	= path;
+					tasks.back().FileId = fileId(path);
+					tasks.back().Logger.setMinimumLevel(logger->minimumLevel());
+				}
+			}
+
+			runTasks(tasks);
+
+			for (LoadTask& task : tasks) {
+				task.Logger.replay(logger, task.Path + ": ");
+				files[task.Path] = task.File;
+				if (task.File->Success)
+					mCache[task.Path] = task.File;
+				else
+					mCache.erase(task.Path);
+				++mParsedCount;
+			}
+
+			vector_t<string_t> next;
+			for (const string_t& path : wave) {
+				for (const LoadedItem& item : files[path]->Items) {
+					if (!item.IncludePath.empty() && files.count(item.IncludePath) == 0
+						&& std::find(next.begin(), next.end(), item.IncludePath) == next.end())
+						next.push_back(item.IncludePath);
+				}
+			}
+			wave.swap(next);
+		}
+	}
+
+	// Ids start at one, zero is used by diagnostics without file
+	uint32 fileId(const string_t& path)
+	{
+		auto it = mFileIds.find(path);
+		if (it != mFileIds.end())
+			return it->second;
+
+		mFilePaths.push_back(path);
+		const uint32 id = static_cast<uint32>(mFilePaths.size());
+		mFileIds[path]	= id;
+		return id;
+	}
+
+	// Every file is expanded once, so repeated includes like diamonds neither duplicate groups nor work
+	void assemble(const string_t& path, const FileMap& files, vector_t<IncludeLink>& chain, std::set<string_t>& expanded,
+				  DataContainer& container, SourceLogger* logger) const
+	{
+		for (const LoadedItem& item : files.at(path)->Items) {
+			if (item.IncludePath.empty()) {
+				container.addTopGroup(item.Group);
+				continue;
+			}
+
+			chain.push_back(IncludeLink{ &path, item.Line });
+
+			auto it = std::find_if(chain.begin(), chain.end(), [&](const IncludeLink& link) { return *link.Path == item.IncludePath; });
+			if (it != chain.end()) {
+				string_t msg = "Include cycle: ";
+				for (; it != chain.end(); ++it)
+					msg += *it->Path + ":" + std::to_string(it->Line) + " -> ";
+				msg += item.IncludePath;
+				logger->log(item.Line, 1, L_Error, path + ": " + msg);
+			} else if (expanded.insert(item.IncludePath).second) {
+				assemble(item.IncludePath, files, chain, expanded, container, logger);
+			}
+
+			chain.pop_back();
+		}
+	}
+
+	SourceLogger* mLogger;
+	std::shared_ptr<const ExpressionRegistry> mRegistry;
+	size_t mThreadCount;
+	size_t mParsedCount;
+	FileMap mCache;
+	map_t<string_t, uint32> mFileIds;
+	vector_t<string_t> mFilePaths;
+};
+
+//---------------------------------------------------
+FileLoader::FileLoader(SourceLogger* logger, const std::shared_ptr<const ExpressionRegistry>& registry)
+	: mInternal(new FileLoader_Internal(logger, registry))
+{
+	DL_ASSERT(logger);
+	DL_ASSERT(!registry || registry->isFrozen());
+}
+
+FileLoader::~FileLoader()
+{
+	delete mInternal;
+}
+
+void FileLoader::setThreadCount(size_t count)
+{
+	mInternal->mThreadCount = count;
+}
+
+bool FileLoader::load(const string_t& path, DataContainer& container)
+{
+	// Counts the errors of this load only
+	ForwardLogger logger(mInternal->mLogger);
+	mInternal->mParsedCount = 0;
+
+	const string_t root = canonicalPath(path);
+	if (root.empty()) {
+		logger.log(L_Error, "Couldn't find file '" + path + "'");
+		return false;
+	}
+
+	FileLoader_Internal::FileMap files;
+	mInternal->loadAll(root, files, &logger);
+
+	vector_t<IncludeLink> chain;
+	std::set<string_t> expanded{ root };
+	mInternal->assemble(root, files, chain, expanded, container, &logger);
+
+	return logger.errorCount() == 0;
+}
+
+size_t FileLoader::cachedFileCount() const
+{
+	return mInternal->mCache.size();
+}
+
+size_t FileLoader::parsedFileCount() const
+{
+	return mInternal->mParsedCount;
+}
+
+void FileLoader::clearCache()
+{
+	mInternal->mCache.clear();
+}
+
+string_t FileLoader::filePath(uint32 id) const
+{
+	return id > 0 && id <= mInternal->mFilePaths.size() ? mInternal->mFilePaths[id - 1] : string_t();
+}
+} // namespace DL
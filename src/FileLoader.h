@@ -0,0 +1,116 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataContainer.h"
+#include "ExpressionRegistry.h"
+#include "SourceLogger.h"
+
+namespace DL {
+/** @class FileLoader FileLoader.h DL/FileLoader.h
+ * @brief Loads sources split across multiple files
+ *
+ * A top level statement with the id @c include and only strings as entries is an include directive:
+ * @code
+ * (include "materials.dl" "objects/scene.dl")
+ * @endcode
+ * The paths are relative to the including file. The directive is replaced by the
+ * top groups of the included files, in the given order.
+ * Every file is included only once per load, further includes of it are ignored.
+ *
+ * Every distinct file is parsed once per load, even if included multiple times.
+ * Files of the same include depth are loaded concurrently.
+ * Successfully built files are cached by their canonical path and modification time,
+ * so following loads only parse changed files.
+ *
+ * Include cycles are reported as errors with the file and line of every include in the cycle.
+ * Diagnostics of the parser and the builder carry the id of the file they refer to, see @link filePath @endlink.
+ * All other messages are prefixed with the path of the file they refer to.
+ * @attention Expressions can not refer to groups of other files.
+ * Warnings of cached files are not reported again.
+ */
+class DL_LIB FileLoader {
+public:
+	/**
+	 * @brief Construct the loader with a given logging class
+	 * @param logger Logging class. Should never be NULL
+	 * @param registry A frozen registry used to build all files. Can be NULL to build without expressions
+	 */
+	explicit FileLoader(SourceLogger* logger,
+						const std::shared_ptr<const ExpressionRegistry>& registry = ExpressionRegistry::standard());
+	~FileLoader();
+
+	FileLoader(const FileLoader& other) = delete;
+	FileLoader& operator=(const FileLoader& other) = delete;
+
+	/**
+	 * @brief Sets the maximum amount of threads used to load files concurrently
+	 * @param count Amount of threads. Zero uses the amount of hardware threads
+	 */
+	void setThreadCount(size_t count);
+
+	/**
+	 * @brief Loads a file including all its includes
+	 *
+	 * @attention Errors or warnings will be post to the given SourceLogger instance.
+	 * @param path Path of the root file
+	 * @param container The container to fill. Will not be cleared!
+	 * @return True if no errors occurred
+	 */
+	bool load(const string_t& path, DataContainer& container);
+
+	/**
+	 * @brief Amount of files in the cache
+	 */
+	size_t cachedFileCount() const;
+
+	/**
+	 * @brief Amount of files parsed by the last load. Cached files are not counted
+	 */
+	size_t parsedFileCount() const;
+
+	/**
+	 * @brief Removes all files from the cache
+	 */
+	void clearCache();
+
+	/**
+	 * @brief Returns the canonical path of the file with the given id
+	 *
+	 * Every distinct file gets an id on its first load, which stays the same for the lifetime of the loader.
+	 * @param id The Diagnostic::FileId of a reported diagnostic
+	 * @return The path, or an empty string if the id is unknown
+	 */
+	string_t filePath(uint32 id) const;
+
+private:
+	class FileLoader_Internal* mInternal;
+};
+} // namespace DL
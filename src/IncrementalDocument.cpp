@@ -0,0 +1,170 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "IncrementalDocument.h"
+#include "DataGroup.h"
+#include "DataLisp.h"
+#include "internal/ForwardLogger.h"
+#include "internal/Hash.h"
+#include "internal/MemoryStream.h"
+#include "internal/StatementScanner.h"
+
+#include <cstring>
+
+namespace DL {
+struct DL_INTERNAL_LIB IncrementalStatement {
+	size_t Begin;
+	size_t End;
+	uint64 Hash;
+	vector_t<DataGroup> Groups;
+};
+
+class DL_INTERNAL_LIB IncrementalDocument_Internal {
+public:
+	IncrementalDocument_Internal(SourceLogger* logger, const std::shared_ptr<const ExpressionRegistry>& registry)
+		: mLogger(logger)
+		, mLisp(&mLogger, registry)
+	{
+	}
+
+	void build(const string_t& source, const StatementRange& range, vector_t<DataGroup>& groups)
+	{
+		mLogger.setOffset(range.Line - 1, range.Column - 1, static_cast<uint32>(range.Begin));
+
+		MemoryStreamBuf buffer(source.data() + range.Begin, range.End - range.Begin);
+		stream_t stream(&buffer);
+
+		DataContainer container;
+		mLisp.reset();
+		mLisp.parse(&stream);
+		mLisp.build(container);
+
+		groups = container.getTopGroups();
+	}
+
+	ForwardLogger mLogger;
+	DataLisp mLisp;
+	vector_t<IncrementalStatement> mStatements;
+};
+
+IncrementalDocument::IncrementalDocument(SourceLogger* log, const std::shared_ptr<const ExpressionRegistry>& registry)
+	: mInternal(new IncrementalDocument_Internal(log, registry))
+	, mReparsedCount(0)
+{
+	DL_ASSERT(log);
+}
+
+IncrementalDocument::~IncrementalDocument()
+{
+	delete mInternal;
+}
+
+size_t IncrementalDocument::statementCount() const
+{
+	return mInternal->mStatements.size();
+}
+
+void IncrementalDocument::setSource(const string_t& source)
+{
+	update(string_t(source));
+}
+
+void IncrementalDocument::applyEdit(size_t offset, size_t length, const string_t& text)
+{
+	DL_ASSERT(offset + length <= mSource.size());
+
+	string_t source = mSource;
+	source.replace(offset, length, text);
+	update(std::move(source));
+}
+
+void IncrementalDocument::update(string_t&& source)
+{
+	vector_t<StatementRange> ranges;
+	if (!scanStatements(source.data(), source.size(), ranges)) {
+		// Let the parser handle and report the malformed source as a whole
+		ranges.clear();
+		ranges.push_back(StatementRange{ 0, source.size(), 1, 1 });
+	}
+
+	vector_t<IncrementalStatement>& oldStatements = mInternal->mStatements;
+
+	// Index the previous statements by their content hash
+	map_t<uint64, vector_t<size_t>> previous;
+	for (size_t i = 0; i < oldStatements.size(); ++i)
+		previous[oldStatements[i].Hash].push_back(i);
+
+	vector_t<bool> reused(oldStatements.size(), false);
+	vector_t<IncrementalStatement> statements;
+	statements.reserve(ranges.size());
+	mReparsedCount = 0;
+
+	for (const StatementRange& range : ranges) {
+		const size_t length = range.End - range.Begin;
+
+		IncrementalStatement stmt;
+		stmt.Begin = range.Begin;
+		stmt.End   = range.End;
+		stmt.Hash  = hashBytes(source.data() + range.Begin, length);
+
+		bool found = false;
+		auto it	   = previous.find(stmt.Hash);
+		if (it != previous.end()) {
+			for (size_t index : it->second) {
+				const IncrementalStatement& old = oldStatements[index];
+				if (reused[index] || old.End - old.Begin != length
+					|| std::memcmp(mSource.data() + old.Begin, source.data() + range.Begin, length) != 0)
+					continue;
+
+				stmt.Groups	  = std::move(oldStatements[index].Groups);
+				reused[index] = true;
+				found		  = true;
+				break;
+			}
+		}
+
+		if (!found) {
+			mInternal->build(source, range, stmt.Groups);
+			++mReparsedCount;
+		}
+
+		statements.push_back(std::move(stmt));
+	}
+
+	DataContainer container;
+	for (const IncrementalStatement& stmt : statements) {
+		for (const DataGroup& grp : stmt.Groups)
+			container.addTopGroup(grp);
+	}
+
+	mSource		  = std::move(source);
+	oldStatements = std::move(statements);
+	mContainer	  = container;
+}
+} // namespace DL
@@ -0,0 +1,107 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataContainer.h"
+#include "ExpressionRegistry.h"
+
+namespace DL {
+class SourceLogger;
+
+/** @class IncrementalDocument IncrementalDocument.h DL/IncrementalDocument.h
+ * @brief Keeps a source and its built container up to date with minimal work on changes
+ *
+ * The source is split into its top level statements and the content hash of every statement is kept.
+ * When the source changes only statements with a new content are parsed and built again,
+ * the groups of all other statements are reused.
+ *
+ * @attention Expressions inside reused statements are not evaluated again.
+ * Expressions depending on anything else than their arguments may give outdated results.
+ */
+class DL_LIB IncrementalDocument {
+public:
+	/**
+	 * @brief Constructs an empty document
+	 * @param log Logging class. Should never be NULL
+	 * @param registry Frozen expression registry. Can be NULL
+	 */
+	explicit IncrementalDocument(SourceLogger* log,
+								 const std::shared_ptr<const ExpressionRegistry>& registry = ExpressionRegistry::standard());
+	~IncrementalDocument();
+
+	IncrementalDocument(const IncrementalDocument& other) = delete;
+	IncrementalDocument& operator=(const IncrementalDocument& other) = delete;
+
+	/**
+	 * @brief Replaces the whole source
+	 *
+	 * Statements with unchanged content are not parsed again.
+	 * @attention Parsing errors or warnings will be post to the given SourceLogger instance.
+	 */
+	void setSource(const string_t& source);
+
+	/**
+	 * @brief Replaces a part of the current source
+	 *
+	 * @param offset Byte offset of the replaced part
+	 * @param length Length in bytes of the replaced part
+	 * @param text The new text
+	 */
+	void applyEdit(size_t offset, size_t length, const string_t& text);
+
+	/**
+	 * @brief Returns the current source
+	 */
+	inline const string_t& source() const { return mSource; }
+
+	/**
+	 * @brief Returns the container built from the current source
+	 */
+	inline const DataContainer& container() const { return mContainer; }
+
+	/**
+	 * @brief Amount of top level statements in the current source
+	 */
+	size_t statementCount() const;
+
+	/**
+	 * @brief Amount of statements parsed by the last change
+	 */
+	inline size_t reparsedCount() const { return mReparsedCount; }
+
+private:
+	void update(string_t&& source);
+
+	class IncrementalDocument_Internal* mInternal;
+	string_t mSource;
+	DataContainer mContainer;
+	size_t mReparsedCount;
+};
+} // namespace DL
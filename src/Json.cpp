@@ -0,0 +1,641 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Json.h"
+#include "internal/MemoryStream.h"
+#include "internal/NumberFormat.h"
+
+#include <cerrno>
+#include <cmath>
+
+namespace DL {
+constexpr size_t JSON_FLUSH_THRESHOLD = 64 * 1024;
+constexpr int JSON_MAX_DEPTH		  = 512;
+
+class DL_INTERNAL_LIB JsonWriter {
+public:
+	JsonWriter(string_t& buffer, std::ostream* stream, GenerateMode mode)
+		: mBuffer(buffer)
+		, mStream(stream)
+		, mMode(mode)
+	{
+		if (mStream)
+			mBuffer.reserve(JSON_FLUSH_THRESHOLD + JSON_FLUSH_THRESHOLD / 4);
+	}
+
+	void write(const DataContainer& container)
+	{
+		const vector_t<DataGroup>& groups = container.getTopGroups();
+
+		mBuffer += '[';
+		for (size_t i = 0; i < groups.size(); ++i) {
+			if (i != 0)
+				mBuffer += ',';
+			newline(1);
+			writeGroup(groups[i], 1);
+			checkFlush();
+		}
+		if (!groups.empty())
+			newline(0);
+		mBuffer += "]\n";
+	}
+
+	void flush()
+	{
+		if (mStream && !mBuffer.empty()) {
+			mStream->write(mBuffer.data(), mBuffer.size());
+			mBuffer.clear();
+		}
+	}
+
+private:
+	void checkFlush()
+	{
+		if (mStream && mBuffer.size() >= JSON_FLUSH_THRESHOLD)
+			flush();
+	}
+
+	void newline(int depth)
+	{
+		if (mMode == GM_Pretty) {
+			mBuffer += '\n';
+			mBuffer.append(static_cast<size_t>(depth) * 2, ' ');
+		}
+	}
+
+	void member(const string_t& name, int depth)
+	{
+		mBuffer += ',';
+		newline(depth);
+		writeString(name);
+		mBuffer += mMode == GM_Pretty ? ": " : ":";
+	}
+
+	void writeGroup(const DataGroup& grp, int depth)
+	{
+		const vector_t<Data>& anonymous = grp.getAnonymousEntries();
+		const vector_t<Data>& named		= grp.getNamedEntries();
+
+		if (grp.isArray() && named.empty()) {
+			writeArray(anonymous, depth);
+			return;
+		}
+
+		mBuffer += '{';
+		newline(depth + 1);
+		writeString("__id__");
+		mBuffer += mMode == GM_Pretty ? ": " : ":";
+		writeString(grp.id());
+
+		if (!anonymous.empty()) {
+			member("__anonymous__", depth + 1);
+			writeArray(anonymous, depth + 1);
+		}
+
+		for (const Data& d : named) {
+			member(d.key(), depth + 1);
+			writeValue(d, depth + 1);
+		}
+
+		newline(depth);
+		mBuffer += '}';
+		checkFlush();
+	}
+
+	void writeArray(const vector_t<Data>& entries, int depth)
+	{
+		mBuffer += '[';
+		for (size_t i = 0; i < entries.size(); ++i) {
+			if (i != 0)
+				mBuffer += ',';
+			newline(depth + 1);
+			writeValue(entries[i], depth + 1);
+		}
+		if (!entries.empty())
+			newline(depth);
+		mBuffer += ']';
+	}
+
+	void writeValue(const Data& d, int depth)
+	{
+		switch (d.type()) {
+		case DT_Group:
+			writeGroup(d.getGroup(), depth);
+			break;
+		case DT_Bool:
+			mBuffer += d.getBool() ? "true" : "false";
+			break;
+		case DT_Float:
+			if (std::isfinite(d.getFloat()))
+				appendFloat(mBuffer, d.getFloat());
+			else
+				mBuffer += "null";
+			break;
+		case DT_Integer:
+			appendInteger(mBuffer, d.getInt());
+			break;
+		case DT_String:
+			writeString(d.getString());
+			break;
+		case DT_None:
+			mBuffer += "null";
+			break;
+		}
+	}
+
+	void writeString(const string_t& str)
+	{
+		static const char* HEX = "0123456789abcdef";
+
+		mBuffer += '"';
+		for (char c : str) {
+			switch (c) {
+			case '"':
+				mBuffer += "\\\"";
+				break;
+			case '\\':
+				mBuffer += "\\\\";
+				break;
+			case '\n':
+				mBuffer += "\\n";
+				break;
+			case '\t':
+				mBuffer += "\\t";
+				break;
+			case '\r':
+				mBuffer += "\\r";
+				break;
+			case '\b':
+				mBuffer += "\\b";
+				break;
+			case '\f':
+				mBuffer += "\\f";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					mBuffer += "\\u00";
+					mBuffer += HEX[(c >> 4) & 0xF];
+					mBuffer += HEX[c & 0xF];
+				} else {
+					mBuffer += c;
+				}
+				break;
+			}
+		}
+		mBuffer += '"';
+	}
+
+	string_t& mBuffer;
+	std::ostream* mStream;
+	GenerateMode mMode;
+};
+
+//---------------------------------------------------
+class DL_INTERNAL_LIB JsonReader {
+public:
+	JsonReader(std::istream& stream, SourceLogger* logger)
+		: mBuffer(stream.rdbuf())
+		, mLogger(logger)
+		, mLine(1)
+		, mColumn(1)
+	{
+	}
+
+	bool read(DataContainer& container)
+	{
+		skipWhitespace();
+		if (peek() == '[') {
+			get();
+			skipWhitespace();
+			if (peek() == ']') {
+				get();
+			} else {
+				for (;;) {
+					skipWhitespace();
+					if (peek() != '{')
+						return error("Expected group object");
+
+					DataGroup grp("__unknown__");
+					if (!readObject(grp, 1))
+						return false;
+					container.addTopGroup(grp);
+
+					skipWhitespace();
+					const int c = get();
+					if (c == ']')
+						break;
+					else if (c != ',')
+						return error("Expected ',' or ']'");
+				}
+			}
+		} else if (peek() == '{') {
+			// Groups keyed by their id
+			get();
+			skipWhitespace();
+			if (peek() == '}') {
+				get();
+			} else {
+				for (;;) {
+					string_t id;
+					skipWhitespace();
+					if (!readString(id) || !colon())
+						return false;
+					if (peek() != '{')
+						return error("Expected group object");
+
+					DataGroup grp(id);
+					if (!readObject(grp, 1))
+						return false;
+					container.addTopGroup(grp);
+
+					skipWhitespace();
+					const int c = get();
+					if (c == '}')
+						break;
+					else if (c != ',')
+						return error("Expected ',' or '}'");
+				}
+			}
+		} else {
+			return error("Expected array or object");
+		}
+
+		skipWhitespace();
+		if (peek() != EOF_CHAR)
+			return error("Unexpected content after JSON value");
+
+		return true;
+	}
+
+private:
+	static constexpr int EOF_CHAR = std::char_traits<char>::eof();
+
+	inline int peek() { return mBuffer->sgetc(); }
+	inline int get()
+	{
+		const int c = mBuffer->sbumpc();
+		if (c == '\n') {
+			++mLine;
+			mColumn = 1;
+		} else {
+			++mColumn;
+		}
+		return c;
+	}
+
+	void skipWhitespace()
+	{
+		for (int c = peek(); c == ' ' || c == '\t' || c == '\n' || c == '\r'; c = peek())
+			get();
+	}
+
+	bool error(const string_t& msg)
+	{
+		mLogger->log(mLine, mColumn, L_Error, msg);
+		return false;
+	}
+
+	bool colon()
+	{
+		skipWhitespace();
+		if (get() != ':')
+			return error("Expected ':'");
+		skipWhitespace();
+		return true;
+	}
+
+	bool readObject(DataGroup& grp, int depth)
+	{
+		if (depth > JSON_MAX_DEPTH)
+			return error("Maximum nesting depth exceeded");
+
+		get(); // '{'
+		skipWhitespace();
+		if (peek() == '}') {
+			get();
+			return true;
+		}
+
+		// Members "0", "1", ... as written by datalisp2python, which puts "__id__" last.
+		// Json::write starts every group with "__id__", so its named entries are never affected
+		bool indexed = true;
+		size_t index = 0;
+		for (;;) {
+			string_t key;
+			skipWhitespace();
+			if (!readString(key) || !colon())
+				return false;
+
+			if (key == "__id__" || key == "__anonymous__")
+				indexed = false;
+
+			if (indexed && key == std::to_string(index)) {
+				++index;
+				Data data;
+				if (!readValue(data, depth + 1))
+					return false;
+				if (data.isValid())
+					grp.add(data);
+			} else if (key == "__id__") {
+				string_t id;
+				if (!readString(id))
+					return false;
+				grp.setID(id);
+			} else if (key == "__anonymous__" && peek() == '[') {
+				if (!readArray(grp, depth + 1))
+					return false;
+			} else {
+				Data data(key);
+				if (!readValue(data, depth + 1))
+					return false;
+				if (data.isValid())
+					grp.add(data);
+			}
+
+			skipWhitespace();
+			const int c = get();
+			if (c == '}')
+				return true;
+			else if (c != ',')
+				return error("Expected ',' or '}'");
+		}
+	}
+
+	// Adds all elements as anonymous entries
+	bool readArray(DataGroup& grp, int depth)
+	{
+		if (depth > JSON_MAX_DEPTH)
+			return error("Maximum nesting depth exceeded");
+
+		get(); // '['
+		skipWhitespace();
+		if (peek() == ']') {
+			get();
+			return true;
+		}
+
+		for (;;) {
+			skipWhitespace();
+			Data data;
+			if (!readValue(data, depth + 1))
+				return false;
+			if (data.isValid())
+				grp.add(data);
+
+			skipWhitespace();
+			const int c = get();
+			if (c == ']')
+				return true;
+			else if (c != ',')
+				return error("Expected ',' or ']'");
+		}
+	}
+
+	bool readValue(Data& data, int depth)
+	{
+		const int c = peek();
+		switch (c) {
+		case '{': {
+			DataGroup grp("__unknown__");
+			if (!readObject(grp, depth))
+				return false;
+			// Array groups are written as objects without "__id__" by datalisp2python
+			if (grp.id() == "__unknown__" && grp.getNamedEntries().empty() && grp.anonymousCount() > 0)
+				grp.setID("");
+			data.setGroup(grp);
+		} break;
+		case '[': {
+			DataGroup grp;
+			if (!readArray(grp, depth))
+				return false;
+			data.setGroup(grp);
+		} break;
+		case '"': {
+			string_t str;
+			if (!readString(str))
+				return false;
+			data.setString(str);
+		} break;
+		case 't':
+			if (!readLiteral("true"))
+				return false;
+			data.setBool(true);
+			break;
+		case 'f':
+			if (!readLiteral("false"))
+				return false;
+			data.setBool(false);
+			break;
+		case 'n':
+			return readLiteral("null");
+		default:
+			if (c == '-' || (c >= '0' && c <= '9'))
+				return readNumber(data);
+			return error("Unexpected character");
+		}
+
+		return true;
+	}
+
+	bool readLiteral(const char* word)
+	{
+		for (; *word; ++word) {
+			if (get() != *word)
+				return error("Invalid literal");
+		}
+		return true;
+	}
+
+	bool readNumber(Data& data)
+	{
+		char tmp[64];
+		size_t length = 0;
+		bool isFloat  = false;
+		for (int c = peek(); (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'; c = peek()) {
+			if (length + 1 >= sizeof(tmp))
+				return error("Number too long");
+			isFloat |= c == '.' || c == 'e' || c == 'E';
+			tmp[length++] = static_cast<char>(get());
+		}
+		tmp[length] = '\0';
+
+		char* end = nullptr;
+		errno	 = 0;
+		if (!isFloat) {
+			const long long v = std::strtoll(tmp, &end, 10);
+			if (end == tmp + length && errno != ERANGE) {
+				data.setInt(static_cast<Integer>(v));
+				return true;
+			}
+		}
+
+		// Integers out of range are kept as floats
+		const float f = std::strtof(tmp, &end);
+		if (end != tmp + length || length == 0)
+			return error("Invalid number");
+
+		data.setFloat(f);
+		return true;
+	}
+
+	static void appendUtf8(string_t& str, uint32 cp)
+	{
+		if (cp <= 0x7F) {
+			str += static_cast<char>(cp);
+		} else if (cp <= 0x7FF) {
+			str += static_cast<char>(0xC0 | (cp >> 6));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		} else if (cp <= 0xFFFF) {
+			str += static_cast<char>(0xE0 | (cp >> 12));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		} else {
+			str += static_cast<char>(0xF0 | (cp >> 18));
+			str += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+			str += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+			str += static_cast<char>(0x80 | (cp & 0x3F));
+		}
+	}
+
+	bool readHex4(uint32& v)
+	{
+		v = 0;
+		for (int i = 0; i < 4; ++i) {
+			const int c = get();
+			v <<= 4;
+			if (c >= '0' && c <= '9')
+				v |= c - '0';
+			else if (c >= 'a' && c <= 'f')
+				v |= c - 'a' + 10;
+			else if (c >= 'A' && c <= 'F')
+				v |= c - 'A' + 10;
+			else
+				return error("Invalid unicode escape sequence");
+		}
+		return true;
+	}
+
+	bool readString(string_t& str)
+	{
+		if (get() != '"')
+			return error("Expected string");
+
+		for (;;) {
+			const int c = get();
+			if (c == EOF_CHAR)
+				return error("Unterminated string");
+			else if (c == '"')
+				return true;
+			else if (c < 0x20 && c >= 0)
+				return error("Control character in string");
+			else if (c != '\\') {
+				str += static_cast<char>(c);
+				continue;
+			}
+
+			const int e = get();
+			switch (e) {
+			case '"':
+			case '\\':
+			case '/':
+				str += static_cast<char>(e);
+				break;
+			case 'b':
+				str += '\b';
+				break;
+			case 'f':
+				str += '\f';
+				break;
+			case 'n':
+				str += '\n';
+				break;
+			case 'r':
+				str += '\r';
+				break;
+			case 't':
+				str += '\t';
+				break;
+			case 'u': {
+				uint32 cp;
+				if (!readHex4(cp))
+					return false;
+
+				if (cp >= 0xD800 && cp <= 0xDBFF) {
+					uint32 low;
+					if (get() != '\\' || get() != 'u' || !readHex4(low) || low < 0xDC00 || low > 0xDFFF)
+						return error("Invalid surrogate pair");
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				}
+				appendUtf8(str, cp);
+			} break;
+			default:
+				return error("Invalid escape sequence");
+			}
+		}
+	}
+
+	std::streambuf* mBuffer;
+	SourceLogger* mLogger;
+	line_t mLine;
+	column_t mColumn;
+};
+
+//---------------------------------------------------
+string_t Json::write(const DataContainer& container, GenerateMode mode)
+{
+	string_t output;
+	JsonWriter writer(output, nullptr, mode);
+	writer.write(container);
+
+	return output;
+}
+
+void Json::write(const DataContainer& container, std::ostream& stream, GenerateMode mode)
+{
+	string_t buffer;
+	JsonWriter writer(buffer, &stream, mode);
+	writer.write(container);
+	writer.flush();
+}
+
+bool Json::read(std::istream& stream, DataContainer& container, SourceLogger* logger)
+{
+	DL_ASSERT(logger);
+
+	JsonReader reader(stream, logger);
+	return reader.read(container);
+}
+
+bool Json::read(const string_t& source, DataContainer& container, SourceLogger* logger)
+{
+	MemoryStreamBuf buffer(source.data(), source.size());
+	std::istream stream(&buffer);
+	return read(stream, container, logger);
+}
+} // namespace DL
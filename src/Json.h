@@ -0,0 +1,97 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLisp.h"
+
+#include <istream>
+#include <ostream>
+
+namespace DL {
+/** @class Json Json.h DL/Json.h
+ * @brief Conversion between DataContainer and JSON
+ *
+ * The content is mapped as follows:
+ * - A container is an array of its top groups
+ * - A group is an object with its id as member "__id__".
+ *   Anonymous entries are listed in the array member "__anonymous__",
+ *   named entries follow as members in their original order
+ * - An array group without named entries is an array
+ * - Integers, floats, booleans and strings map to their JSON counterparts.
+ *   Floats are always written with a fractional part or exponent
+ *
+ * Named entries with the same key are written as multiple members with the same name.
+ * When reading, an object without "__id__" gets the id "__unknown__"
+ * and numbers without fractional part or exponent are read as integers.
+ * An object on the top level is read as groups keyed by their id.
+ * Members named "0", "1", ... in sequence are read as anonymous entries as long as they
+ * precede "__id__" and "__anonymous__", and a nested object without "__id__" containing
+ * only such entries is read as an array group. This accepts the output of the Python
+ * datalisp2json script. As "__id__" is always written first, named entries with such keys
+ * are kept.
+ * @attention Floats which are not finite are written as null. Null values are ignored when read.
+ */
+class DL_LIB Json {
+public:
+	/**
+	 * @brief Returns a JSON string based on the content of the container
+	 * @param container The container to convert
+	 * @param mode Layout of the JSON output
+	 */
+	static string_t write(const DataContainer& container, GenerateMode mode = GM_Compact);
+
+	/**
+	 * @brief Writes JSON based on the content of the container into a stream
+	 *
+	 * The output is written in chunks, without building the whole output in memory.
+	 * @param container The container to convert
+	 * @param stream Output stream
+	 * @param mode Layout of the JSON output
+	 */
+	static void write(const DataContainer& container, std::ostream& stream, GenerateMode mode = GM_Compact);
+
+	/**
+	 * @brief Reads JSON from a stream and adds its content to the container
+	 *
+	 * @attention Errors will be post to the given SourceLogger instance.
+	 * @param stream Input stream
+	 * @param container The container to fill. Will not be cleared!
+	 * @param logger Logging class. Should never be NULL
+	 * @return True if successful
+	 */
+	static bool read(std::istream& stream, DataContainer& container, SourceLogger* logger);
+
+	/**
+	 * @brief Reads JSON from a string and adds its content to the container
+	 * @see read
+	 */
+	static bool read(const string_t& source, DataContainer& container, SourceLogger* logger);
+};
+} // namespace DL
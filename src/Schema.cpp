@@ -0,0 +1,668 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Schema.h"
+#include "DataContainer.h"
+#include "DataLisp.h"
+#include "internal/Hash.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace DL {
+constexpr size_t NO_GROUP = static_cast<size_t>(-1);
+
+// Constraint of a single value
+struct DL_INTERNAL_LIB SchemaRule {
+	SchemaType Type		= ST_Any;
+	string_t GroupID;				// Required id of groups. Empty if any id is allowed
+	size_t Group		= NO_GROUP; // Definition of the group id or the array
+};
+
+struct DL_INTERNAL_LIB SchemaKey {
+	string_t Name;
+	SchemaRule Rule;
+	bool Required = false;
+	bool Multiple = false;
+};
+
+struct DL_INTERNAL_LIB SchemaKeyIndex {
+	uint64 Hash;
+	uint32 Position;
+
+	inline bool operator<(const SchemaKeyIndex& other) const { return Hash < other.Hash; }
+};
+
+struct DL_INTERNAL_LIB SchemaGroup {
+	string_t ID;
+	bool Strict		  = true;
+	bool HasAnonymous = false;
+	SchemaRule Anonymous;
+	vector_t<SchemaKey> Keys;
+	vector_t<SchemaKeyIndex> Index;
+	vector_t<uint32> Required;
+};
+
+// Group currently validated. Entries are visited one after another, nested groups are pushed on top
+struct DL_INTERNAL_LIB SchemaFrame {
+	const DataGroup* Group;
+	const SchemaGroup* Definition;
+	size_t Next;
+	size_t Seen; // Offset of the key counters
+	const string_t* Key;
+	size_t Index;
+};
+
+class DL_INTERNAL_LIB Schema_Internal {
+public:
+	Schema_Internal()
+		: mValid(false)
+		, mStrict(false)
+		, mLogger(nullptr)
+	{
+	}
+
+	//---------------------------------------------------
+	// Compilation
+	bool compile(const DataContainer& definition, SourceLogger* logger)
+	{
+		mValid = false;
+		mStrict = false;
+		mRequired.clear();
+		mGroups.clear();
+		mGroupIndex.clear();
+		mLogger = logger;
+
+		// Ids are resolved after all groups are known
+		for (const DataGroup& grp : definition.getTopGroups()) {
+			if (grp.id() != "group")
+				continue;
+
+			const Data id = grp.getFromKey("id");
+			if (id.type() != DT_String || id.getString().empty())
+				return error("Group definition without id");
+			if (mGroupIndex.count(id.getString()))
+				return error("Group '" + id.getString() + "' is defined multiple times");
+
+			mGroupIndex[id.getString()] = mGroups.size();
+			mGroups.emplace_back();
+			mGroups.back().ID = id.getString();
+		}
+
+		for (const DataGroup& grp : definition.getTopGroups()) {
+			if (grp.id() == "schema") {
+				if (!compileSettings(grp))
+					return false;
+			} else if (grp.id() == "group") {
+				const string_t id = grp.getFromKey("id").getString();
+				if (!compileGroup(grp, id))
+					return false;
+			} else {
+				return error("Unknown definition '" + grp.id() + "'");
+			}
+		}
+
+		mLogger = nullptr;
+		mValid	= true;
+		return true;
+	}
+
+	bool error(const string_t& msg)
+	{
+		if (mLogger)
+			mLogger->log(L_Error, "Schema: " + msg);
+		mValid = false;
+		mRequired.clear();
+		mGroups.clear();
+		mGroupIndex.clear();
+		mLogger = nullptr;
+		return false;
+	}
+
+	bool compileSettings(const DataGroup& grp)
+	{
+		for (const Data& d : grp.getNamedEntries()) {
+			if (d.key() == "strict" && d.type() == DT_Bool) {
+				mStrict = d.getBool();
+			} else if (d.key() == "required" && d.type() == DT_Group && d.getGroup().isArray()) {
+				for (const Data& id : d.getGroup().getAnonymousEntries()) {
+					if (id.type() != DT_String)
+						return error("Required top groups have to be given by id");
+					mRequired.push_back(id.getString());
+				}
+			} else {
+				return error("Invalid schema setting '" + d.key() + "'");
+			}
+		}
+		return true;
+	}
+
+	bool compileGroup(const DataGroup& grp, const string_t& id)
+	{
+		// Arrays may add definitions, therefor the group is only referenced by index
+		const size_t index = mGroupIndex[id];
+		for (const Data& d : grp.getNamedEntries()) {
+			if (d.key() == "strict" && d.type() == DT_Bool)
+				mGroups[index].Strict = d.getBool();
+			else if (d.key() != "id")
+				return error("Invalid setting '" + d.key() + "' of group '" + id + "'");
+		}
+
+		for (const Data& d : grp.getAnonymousEntries()) {
+			if (d.type() != DT_Group)
+				return error("Invalid entry in group '" + id + "'");
+
+			const DataGroup& entry = d.getGroup();
+			if (entry.id() == "key") {
+				SchemaKey key;
+				if (!compileKey(entry, id, key))
+					return false;
+
+				SchemaGroup& def = mGroups[index];
+				for (const SchemaKey& other : def.Keys) {
+					if (other.Name == key.Name)
+						return error("Key '" + key.Name + "' of group '" + id + "' is defined multiple times");
+				}
+
+				if (key.Required)
+					def.Required.push_back(static_cast<uint32>(def.Keys.size()));
+				def.Index.push_back(SchemaKeyIndex{ hashString(key.Name), static_cast<uint32>(def.Keys.size()) });
+				def.Keys.push_back(std::move(key));
+			} else if (entry.id() == "anonymous") {
+				SchemaRule rule;
+				if (!compileRule(entry, id, rule))
+					return false;
+
+				mGroups[index].HasAnonymous = true;
+				mGroups[index].Anonymous	= rule;
+			} else {
+				return error("Unknown definition '" + entry.id() + "' in group '" + id + "'");
+			}
+		}
+
+		std::stable_sort(mGroups[index].Index.begin(), mGroups[index].Index.end());
+		return true;
+	}
+
+	bool compileKey(const DataGroup& grp, const string_t& id, SchemaKey& key)
+	{
+		const Data name = grp.getFromKey("name");
+		if (name.type() != DT_String || name.getString().empty())
+			return error("Key without name in group '" + id + "'");
+		key.Name = name.getString();
+
+		const Data required = grp.getFromKey("required");
+		const Data multiple = grp.getFromKey("multiple");
+		key.Required		= required.type() == DT_Bool && required.getBool();
+		key.Multiple		= multiple.type() == DT_Bool && multiple.getBool();
+
+		return compileRule(grp, id + ":" + key.Name, key.Rule);
+	}
+
+	bool compileRule(const DataGroup& grp, const string_t& context, SchemaRule& rule)
+	{
+		for (const Data& d : grp.getNamedEntries()) {
+			if (d.key() != "name" && d.key() != "required" && d.key() != "multiple"
+				&& d.key() != "type" && d.key() != "element" && d.key() != "group")
+				return error("Invalid setting '" + d.key() + "' of '" + context + "'");
+		}
+
+		const Data type	   = grp.getFromKey("type");
+		const Data element = grp.getFromKey("element");
+		const Data group   = grp.getFromKey("group");
+
+		if (!toType(type, rule.Type, context))
+			return false;
+
+		if (group.isValid()) {
+			if (group.type() != DT_String)
+				return error("Invalid group id of '" + context + "'");
+			rule.GroupID = group.getString();
+		}
+
+		if (rule.Type == ST_Array) {
+			// The entries of an array are described by an anonymous group definition
+			SchemaRule entries;
+			if (!toType(element, entries.Type, context))
+				return false;
+			entries.GroupID = rule.GroupID;
+			entries.Group	= resolve(entries);
+			rule.GroupID.clear();
+
+			SchemaGroup array;
+			array.HasAnonymous = true;
+			array.Anonymous	   = entries;
+			rule.Group		   = mGroups.size();
+			mGroups.push_back(std::move(array));
+		} else if (element.isValid()) {
+			return error("Element type given for non array '" + context + "'");
+		} else {
+			rule.Group = resolve(rule);
+		}
+
+		return true;
+	}
+
+	size_t resolve(const SchemaRule& rule) const
+	{
+		if (rule.Type != ST_Group && rule.Type != ST_Any)
+			return NO_GROUP;
+
+		auto it = mGroupIndex.find(rule.GroupID);
+		return it != mGroupIndex.end() ? it->second : NO_GROUP;
+	}
+
+	bool toType(const Data& d, SchemaType& type, const string_t& context)
+	{
+		if (!d.isValid()) {
+			type = ST_Any;
+			return true;
+		}
+
+		static const char* names[] = { "any", "integer", "float", "number", "bool", "string", "group", "array" };
+		if (d.type() == DT_String) {
+			for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+				if (d.getString() == names[i]) {
+					type = static_cast<SchemaType>(i);
+					return true;
+				}
+			}
+		}
+
+		return error("Invalid type of '" + context + "'");
+	}
+
+	//---------------------------------------------------
+	// Validation
+	const SchemaGroup* findGroup(const string_t& id) const
+	{
+		auto it = mGroupIndex.find(id);
+		return it != mGroupIndex.end() ? &mGroups[it->second] : nullptr;
+	}
+
+	static const SchemaKey* findKey(const SchemaGroup& def, const string_t& name, size_t& position)
+	{
+		const uint64 hash = hashString(name);
+		auto it			  = std::lower_bound(def.Index.begin(), def.Index.end(), SchemaKeyIndex{ hash, 0 });
+		for (; it != def.Index.end() && it->Hash == hash; ++it) {
+			if (def.Keys[it->Position].Name == name) {
+				position = it->Position;
+				return &def.Keys[it->Position];
+			}
+		}
+		return nullptr;
+	}
+
+	static bool matches(const Data& d, SchemaType type)
+	{
+		switch (type) {
+		case ST_Any:
+			return true;
+		case ST_Integer:
+			return d.type() == DT_Integer;
+		case ST_Float:
+			return d.type() == DT_Float;
+		case ST_Number:
+			return d.isNumber();
+		case ST_Bool:
+			return d.type() == DT_Bool;
+		case ST_String:
+			return d.type() == DT_String;
+		case ST_Group:
+			return d.type() == DT_Group && !d.getGroup().isArray();
+		case ST_Array:
+			return d.type() == DT_Group && d.getGroup().isArray();
+		default:
+			return false;
+		}
+	}
+
+	// Paths are only built for violations
+	static string_t pathOf(const vector_t<SchemaFrame>& stack, const string_t* key, size_t index)
+	{
+		string_t path;
+		for (const SchemaFrame& frame : stack) {
+			if (frame.Key)
+				path += (path.empty() ? ":" : "/:") + *frame.Key;
+			else if (frame.Index == NO_GROUP)
+				path += frame.Group->id();
+			else
+				path += "/[" + std::to_string(frame.Index) + "]";
+		}
+
+		if (key)
+			path += "/:" + *key;
+		else if (index != NO_GROUP)
+			path += "/[" + std::to_string(index) + "]";
+		return path;
+	}
+
+	class Validation {
+	public:
+		Validation(const Schema_Internal& schema, SourceLogger* logger)
+			: mSchema(schema)
+			, mLogger(logger)
+			, mViolations(0)
+		{
+		}
+
+		inline size_t violations() const { return mViolations; }
+
+		void report(DiagnosticCode code, const string_t* key, size_t index, const string_t& text, int32 arg0 = 0, int32 arg1 = 0)
+		{
+			++mViolations;
+			if (!mLogger)
+				return;
+
+			Diagnostic diagnostic(code, L_Error, arg0, arg1);
+			diagnostic.Text = text;
+			diagnostic.Path = pathOf(mStack, key, index);
+			mLogger->report(diagnostic);
+		}
+
+		void push(const DataGroup& grp, const SchemaGroup* def, const string_t* key, size_t index)
+		{
+			mStack.push_back(SchemaFrame{ &grp, def, 0, mSeen.size(), key, index });
+			mSeen.resize(mSeen.size() + def->Keys.size(), 0);
+		}
+
+		void run(const DataGroup& top, const SchemaGroup& def)
+		{
+			push(top, &def, nullptr, NO_GROUP);
+
+			while (!mStack.empty()) {
+				SchemaFrame& frame			 = mStack.back();
+				const vector_t<Data>& named	 = frame.Group->getNamedEntries();
+				const vector_t<Data>& anonymous = frame.Group->getAnonymousEntries();
+
+				if (frame.Next < named.size()) {
+					const Data& d = named[frame.Next++];
+
+					size_t position;
+					const SchemaKey* key = findKey(*frame.Definition, d.key(), position);
+					if (!key) {
+						if (frame.Definition->Strict)
+							report(DC_SchemaUnknownKey, nullptr, NO_GROUP, d.key());
+						continue;
+					}
+
+					if (++mSeen[frame.Seen + position] > 1 && !key->Multiple)
+						report(DC_SchemaDuplicateKey, nullptr, NO_GROUP, d.key());
+
+					check(d, key->Rule, &key->Name, NO_GROUP);
+				} else if (frame.Next < named.size() + anonymous.size()) {
+					const size_t index = frame.Next++ - named.size();
+					if (!frame.Definition->HasAnonymous) {
+						if (frame.Definition->Strict)
+							report(DC_SchemaUnexpectedAnonymous, nullptr, index, string_t());
+						continue;
+					}
+
+					check(anonymous[index], frame.Definition->Anonymous, nullptr, index);
+				} else {
+					for (uint32 position : frame.Definition->Required) {
+						if (mSeen[frame.Seen + position] == 0)
+							report(DC_SchemaMissingKey, nullptr, NO_GROUP, frame.Definition->Keys[position].Name);
+					}
+
+					mSeen.resize(frame.Seen);
+					mStack.pop_back();
+				}
+			}
+		}
+
+	private:
+		// Pushes nested groups, which invalidates the current frame
+		void check(const Data& d, const SchemaRule& rule, const string_t* key, size_t index)
+		{
+			if (!matches(d, rule.Type)) {
+				report(DC_SchemaInvalidType, key, index, string_t(), rule.Type, d.type());
+				return;
+			}
+
+			if (d.type() != DT_Group)
+				return;
+
+			const DataGroup& grp = d.getGroup();
+			if (!rule.GroupID.empty() && grp.id() != rule.GroupID) {
+				report(DC_SchemaInvalidGroup, key, index, rule.GroupID);
+				return;
+			}
+
+			// Groups without required id are validated by their own id
+			const SchemaGroup* def = rule.Group != NO_GROUP ? &mSchema.mGroups[rule.Group] : mSchema.findGroup(grp.id());
+			if (def)
+				push(grp, def, key, index);
+		}
+
+		const Schema_Internal& mSchema;
+		SourceLogger* mLogger;
+		size_t mViolations;
+
+		vector_t<SchemaFrame> mStack;
+		vector_t<uint32> mSeen;
+	};
+
+	bool validate(const DataGroup& grp, SourceLogger* logger) const
+	{
+		if (!mValid)
+			return true;
+
+		const SchemaGroup* def = findGroup(grp.id());
+		if (!def) {
+			if (!mStrict)
+				return true;
+
+			if (logger) {
+				Diagnostic diagnostic(DC_SchemaUnknownGroup, L_Error);
+				diagnostic.Text = grp.id();
+				diagnostic.Path = grp.id();
+				logger->report(diagnostic);
+			}
+			return false;
+		}
+
+		Validation validation(*this, logger);
+		validation.run(grp, *def);
+		return validation.violations() == 0;
+	}
+
+	bool validateRequired(const DataContainer& container, SourceLogger* logger) const
+	{
+		bool valid = true;
+		for (const string_t& id : mRequired) {
+			if (container.findTopGroup(id))
+				continue;
+
+			valid = false;
+			if (logger) {
+				Diagnostic diagnostic(DC_SchemaMissingGroup, L_Error);
+				diagnostic.Text = id;
+				logger->report(diagnostic);
+			}
+		}
+		return valid;
+	}
+
+	//---------------------------------------------------
+	// Reflection
+	SchemaEntryInfo toInfo(const SchemaRule& rule) const
+	{
+		SchemaEntryInfo info;
+		info.Type = rule.Type;
+		if (rule.Type == ST_Array) {
+			const SchemaRule& entries = mGroups[rule.Group].Anonymous;
+			info.Element			  = entries.Type;
+			info.GroupID			  = entries.GroupID;
+		} else {
+			info.GroupID = rule.GroupID;
+		}
+		return info;
+	}
+
+	vector_t<SchemaGroupInfo> groups() const
+	{
+		vector_t<SchemaGroupInfo> infos;
+		if (!mValid)
+			return infos;
+
+		// Definitions given by id come first, the array definitions are appended after them
+		infos.reserve(mGroupIndex.size());
+		for (size_t i = 0; i < mGroupIndex.size(); ++i) {
+			const SchemaGroup& def = mGroups[i];
+
+			SchemaGroupInfo info;
+			info.ID			  = def.ID;
+			info.Strict		  = def.Strict;
+			info.HasAnonymous = def.HasAnonymous;
+			if (def.HasAnonymous)
+				info.Anonymous = toInfo(def.Anonymous);
+
+			for (const SchemaKey& key : def.Keys) {
+				SchemaEntryInfo entry = toInfo(key.Rule);
+				entry.Name			  = key.Name;
+				entry.Required		  = key.Required;
+				entry.Multiple		  = key.Multiple;
+				info.Keys.push_back(std::move(entry));
+			}
+			infos.push_back(std::move(info));
+		}
+		return infos;
+	}
+
+	bool mValid;
+	bool mStrict;
+	vector_t<string_t> mRequired;
+	vector_t<SchemaGroup> mGroups;
+	map_t<string_t, size_t> mGroupIndex;
+	SourceLogger* mLogger;
+};
+
+//---------------------------------------------------
+Schema::Schema()
+	: mInternal(new Schema_Internal)
+{
+}
+
+Schema::Schema(const DataContainer& definition, SourceLogger* logger)
+	: mInternal(new Schema_Internal)
+{
+	compile(definition, logger);
+}
+
+Schema::Schema(const string_t& source, SourceLogger* logger)
+	: mInternal(new Schema_Internal)
+{
+	compile(source, logger);
+}
+
+Schema::~Schema()
+{
+	if (mInternal)
+		delete mInternal;
+}
+
+Schema::Schema(const Schema& other)
+	: mInternal(new Schema_Internal(*other.mInternal))
+{
+}
+
+// The moved-from schema stays usable and behaves like a default constructed one
+Schema::Schema(Schema&& other) noexcept
+	: mInternal(new Schema_Internal)
+{
+	std::swap(mInternal, other.mInternal);
+}
+
+Schema& Schema::operator=(const Schema& other)
+{
+	if (this != &other)
+		*mInternal = *other.mInternal;
+	return *this;
+}
+
+Schema& Schema::operator=(Schema&& other) noexcept
+{
+	std::swap(mInternal, other.mInternal);
+	return *this;
+}
+
+bool Schema::compile(const DataContainer& definition, SourceLogger* logger)
+{
+	return mInternal->compile(definition, logger);
+}
+
+bool Schema::compile(const string_t& source, SourceLogger* logger)
+{
+	SourceLogger defaultLogger;
+	SourceLogger* log = logger ? logger : &defaultLogger;
+	const int errors  = log->errorCount();
+
+	DataLisp lisp(log);
+	DataContainer definition;
+	lisp.parse(source);
+	lisp.build(definition);
+
+	if (log->errorCount() != errors) {
+		mInternal->mLogger = logger;
+		return mInternal->error("Invalid source");
+	}
+
+	return mInternal->compile(definition, logger);
+}
+
+bool Schema::isValid() const
+{
+	return mInternal->mValid;
+}
+
+bool Schema::validate(const DataContainer& container, SourceLogger* logger) const
+{
+	bool valid = true;
+	for (const DataGroup& grp : container.getTopGroups())
+		valid = mInternal->validate(grp, logger) && valid;
+
+	return mInternal->validateRequired(container, logger) && valid;
+}
+
+bool Schema::validate(const DataGroup& group, SourceLogger* logger) const
+{
+	return mInternal->validate(group, logger);
+}
+
+bool Schema::validateRequired(const DataContainer& container, SourceLogger* logger) const
+{
+	return mInternal->validateRequired(container, logger);
+}
+
+vector_t<SchemaGroupInfo> Schema::groups() const
+{
+	return mInternal->groups();
+}
+} // namespace DL
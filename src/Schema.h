@@ -0,0 +1,189 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Data.h"
+#include "SourceLogger.h"
+
+namespace DL {
+class DataContainer;
+
+/**
+ * @brief Type of a value described by a Schema
+ */
+enum SchemaType {
+	ST_Any,		///< Every value
+	ST_Integer, ///< Integer values
+	ST_Float,	///< Float values
+	ST_Number,	///< Integer or float values
+	ST_Bool,	///< Boolean values
+	ST_String,	///< String values
+	ST_Group,	///< Groups with an id
+	ST_Array	///< Groups without an id
+};
+
+/**
+ * @brief Description of a key or the anonymous entries of a group definition
+ * @see Schema::groups
+ */
+struct DL_LIB SchemaEntryInfo {
+	string_t Name;				///< Name of the key. Empty for anonymous entries
+	SchemaType Type	   = ST_Any; ///< Type of the value
+	SchemaType Element = ST_Any; ///< Type of the array entries. Only used with ST_Array
+	string_t GroupID;			///< Required id of the group or the group entries of an array. Empty if any id is allowed
+	bool Required = false;		///< True if the key has to be available
+	bool Multiple = false;		///< True if the key can be given multiple times
+};
+
+/**
+ * @brief Description of a group definition
+ * @see Schema::groups
+ */
+struct DL_LIB SchemaGroupInfo {
+	string_t ID;				///< Id of the described groups
+	bool Strict		  = true;	///< True if named entries without definition are not allowed
+	bool HasAnonymous = false;	///< True if anonymous entries are described
+	SchemaEntryInfo Anonymous;	///< Description of the anonymous entries. Only used with HasAnonymous
+	vector_t<SchemaEntryInfo> Keys; ///< All keys in order of definition
+};
+
+/** @class Schema Schema.h DL/Schema.h
+ * @brief Compiled description of the groups allowed in a DataContainer
+ *
+ * A schema is written in %DataLisp itself:
+ * @code
+ * (schema :strict true :required ["scene"])
+ * (group :id "scene"
+ *	(key :name "camera" :type "group" :group "camera" :required true)
+ *	(key :name "objects" :type "array" :element "group" :group "object"))
+ * (group :id "camera" :strict false
+ *	(key :name "fov" :type "number" :required true)
+ *	(key :name "position" :type "array" :element "float"))
+ * (group :id "object"
+ *	(key :name "name" :type "string")
+ *	(key :name "tag" :type "string" :multiple true)
+ *	(anonymous :type "number"))
+ * @endcode
+ * - @c schema Optional top level settings. With @c :strict top groups without definition are not allowed.
+ *   @c :required lists the ids of top groups which have to be available
+ * - @c group Definition of all groups with the given @c :id. With @c :strict, which is the default,
+ *   named entries without definition are not allowed
+ * - @c key Named entry of the group. It can be @c :required and only be given @c :multiple times if allowed
+ * - @c anonymous Anonymous entries of the group. Without it, anonymous entries are only allowed in non strict groups
+ *
+ * The @c :type is one of @c any, @c integer, @c float, @c number, @c bool, @c string, @c group or @c array.
+ * Arrays can restrict their entries with an @c :element type. Groups and group elements can
+ * require an id with @c :group. Nested groups are validated with the definition of their id, if available.
+ *
+ * Keys are looked up in a hashed index, therefor a container is validated in a single traversal.
+ * Violations are reported as Diagnostic with the path of the entry, e.g. @c scene/:objects/[2]/:name.
+ * The schema is compiled once and can be used concurrently.
+ * @see DataLisp::setSchema
+ */
+class DL_LIB Schema {
+public:
+	/**
+	 * @brief Constructs an empty schema, which accepts every container
+	 */
+	Schema();
+
+	/**
+	 * @brief Constructs and compiles the given definition
+	 * @see compile
+	 */
+	explicit Schema(const DataContainer& definition, SourceLogger* logger = nullptr);
+
+	/**
+	 * @brief Constructs and compiles the given definition source
+	 * @see compile
+	 */
+	explicit Schema(const string_t& source, SourceLogger* logger = nullptr);
+	~Schema();
+
+	Schema(const Schema& other);
+	Schema(Schema&& other) noexcept;
+	Schema& operator=(const Schema& other);
+	Schema& operator=(Schema&& other) noexcept;
+
+	/**
+	 * @brief Compiles the given definition
+	 *
+	 * @attention Errors in the definition will be post to the given SourceLogger instance, if available.
+	 * @return True if successful
+	 */
+	bool compile(const DataContainer& definition, SourceLogger* logger = nullptr);
+
+	/**
+	 * @brief Parses and compiles the given definition source
+	 * @see compile
+	 */
+	bool compile(const string_t& source, SourceLogger* logger = nullptr);
+
+	/**
+	 * @brief Returns true if a definition was compiled successfully
+	 */
+	bool isValid() const;
+
+	/**
+	 * @brief Validates all top groups and checks the required top groups
+	 * @param container The container to validate
+	 * @param logger All violations are reported to it. Can be NULL
+	 * @return True if the container is valid
+	 */
+	bool validate(const DataContainer& container, SourceLogger* logger) const;
+
+	/**
+	 * @brief Validates a single top group
+	 * @param group The top group to validate
+	 * @param logger All violations are reported to it. Can be NULL
+	 * @return True if the group is valid
+	 */
+	bool validate(const DataGroup& group, SourceLogger* logger) const;
+
+	/**
+	 * @brief Checks only if all required top groups are available
+	 * @param container The container to check
+	 * @param logger All missing groups are reported to it. Can be NULL
+	 * @return True if all required groups are available
+	 */
+	bool validateRequired(const DataContainer& container, SourceLogger* logger) const;
+
+	/**
+	 * @brief Returns all group definitions in order of definition
+	 *
+	 * Meant for tools generating code from a schema, like @c dl_codegen.
+	 * @return Empty if no definition was compiled successfully
+	 */
+	vector_t<SchemaGroupInfo> groups() const;
+
+private:
+	class Schema_Internal* mInternal;
+};
+} // namespace DL
@@ -0,0 +1,535 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Selector.h"
+#include "DataContainer.h"
+
+#include <cstdlib>
+
+namespace DL {
+enum SelectorStepType {
+	SST_Group, // Child groups by id
+	SST_Key,   // Named entries
+	SST_Index  // Anonymous entries
+};
+
+enum SelectorPredicateType {
+	SPT_Index, // n-th match
+	SPT_Has,   // Has named entry
+	SPT_Equal  // Named entry is equal to value
+};
+
+struct DL_INTERNAL_LIB SelectorPredicate {
+	SelectorPredicateType Type;
+	size_t Index;
+	string_t Key;
+	Data Value;
+};
+
+struct DL_INTERNAL_LIB SelectorStep {
+	SelectorStepType Type;
+	bool Deep;
+	bool Wildcard;
+	string_t Name;
+	size_t Index;
+	vector_t<SelectorPredicate> Predicates;
+};
+
+class DL_INTERNAL_LIB Selector_Internal {
+public:
+	Selector_Internal()
+		: mValid(false)
+		, mLogger(nullptr)
+		, mPos(0)
+	{
+	}
+
+	//---------------------------------------------------
+	// Compilation
+	bool compile(const string_t& path, SourceLogger* logger)
+	{
+		mPath  = path;
+		mValid = false;
+		mSteps.clear();
+		mLogger = logger;
+		mPos	= 0;
+
+		if (mPath.empty())
+			return error("Empty path");
+
+		while (mPos < mPath.size()) {
+			SelectorStep step;
+			step.Deep	  = false;
+			step.Wildcard = false;
+			step.Index	  = 0;
+
+			if (peek() == '/') {
+				++mPos;
+				if (peek() == '/') {
+					++mPos;
+					step.Deep = true;
+				}
+			} else if (!mSteps.empty()) {
+				return error("Expected '/'");
+			}
+
+			if (!parseStep(step))
+				return false;
+			mSteps.push_back(step);
+		}
+
+		mLogger = nullptr;
+		mValid	= true;
+		return true;
+	}
+
+	inline char peek() const { return mPos < mPath.size() ? mPath[mPos] : '\0'; }
+
+	bool error(const string_t& msg)
+	{
+		if (mLogger)
+			mLogger->log(1, static_cast<column_t>(mPos + 1), L_Error, msg);
+		mSteps.clear();
+		mLogger = nullptr;
+		return false;
+	}
+
+	static bool isNameChar(char c)
+	{
+		return c != '\0' && c != '/' && c != '[' && c != ']' && c != ':' && c != '=' && c != '"'
+			   && c != ' ' && c != '\t' && c != '\n' && c != '\r';
+	}
+
+	bool parseName(string_t& name, bool& wildcard)
+	{
+		if (peek() == '*') {
+			++mPos;
+			wildcard = true;
+			return true;
+		}
+
+		const size_t start = mPos;
+		while (isNameChar(peek()))
+			++mPos;
+
+		if (mPos == start)
+			return error("Expected name or '*'");
+
+		name = mPath.substr(start, mPos - start);
+		return true;
+	}
+
+	bool parseIndex(size_t& index)
+	{
+		const size_t start = mPos;
+		while (peek() >= '0' && peek() <= '9')
+			++mPos;
+
+		if (mPos == start)
+			return error("Expected index");
+
+		index = static_cast<size_t>(std::strtoull(mPath.c_str() + start, nullptr, 10));
+		return true;
+	}
+
+	bool parseStep(SelectorStep& step)
+	{
+		if (peek() == ':') {
+			++mPos;
+			step.Type = SST_Key;
+			return parseName(step.Name, step.Wildcard);
+		} else if (peek() == '[') {
+			++mPos;
+			step.Type = SST_Index;
+			if (peek() == '*') {
+				++mPos;
+				step.Wildcard = true;
+			} else if (!parseIndex(step.Index)) {
+				return false;
+			}
+			return closeBracket();
+		}
+
+		step.Type = SST_Group;
+		if (!parseName(step.Name, step.Wildcard))
+			return false;
+
+		while (peek() == '[') {
+			++mPos;
+			if (peek() == '*') {
+				++mPos;
+			} else {
+				SelectorPredicate pred;
+				pred.Index = 0;
+				if (peek() == ':') {
+					++mPos;
+					bool wildcard = false;
+					if (!parseName(pred.Key, wildcard))
+						return false;
+					if (wildcard)
+						return error("Wildcards are not allowed in predicates");
+
+					if (peek() == '=') {
+						++mPos;
+						pred.Type = SPT_Equal;
+						if (!parseLiteral(pred.Value))
+							return false;
+					} else {
+						pred.Type = SPT_Has;
+					}
+				} else {
+					pred.Type = SPT_Index;
+					if (!parseIndex(pred.Index))
+						return false;
+				}
+				step.Predicates.push_back(pred);
+			}
+
+			if (!closeBracket())
+				return false;
+		}
+
+		return true;
+	}
+
+	bool closeBracket()
+	{
+		if (peek() != ']')
+			return error("Expected ']'");
+		++mPos;
+		return true;
+	}
+
+	bool parseLiteral(Data& value)
+	{
+		if (peek() == '"') {
+			++mPos;
+			string_t str;
+			while (peek() != '"') {
+				if (peek() == '\0')
+					return error("Unterminated string");
+				if (peek() == '\\')
+					++mPos;
+				str += peek();
+				++mPos;
+			}
+			++mPos;
+			value.setString(str);
+			return true;
+		}
+
+		const size_t start = mPos;
+		while (peek() != ']' && peek() != '\0')
+			++mPos;
+		const string_t token = mPath.substr(start, mPos - start);
+
+		if (token == "true") {
+			value.setBool(true);
+			return true;
+		} else if (token == "false") {
+			value.setBool(false);
+			return true;
+		}
+
+		char* end = nullptr;
+		if (token.find_first_of(".eE") == string_t::npos) {
+			const long long i = std::strtoll(token.c_str(), &end, 10);
+			if (!token.empty() && end == token.c_str() + token.size()) {
+				value.setInt(static_cast<Integer>(i));
+				return true;
+			}
+		} else {
+			const float f = std::strtof(token.c_str(), &end);
+			if (end == token.c_str() + token.size()) {
+				value.setFloat(f);
+				return true;
+			}
+		}
+
+		mPos = start;
+		return error("Invalid value");
+	}
+
+	//---------------------------------------------------
+	// Evaluation
+	static bool equals(const Data& a, const Data& b)
+	{
+		if (a.isNumber() && b.isNumber()) {
+			if (a.type() == DT_Integer && b.type() == DT_Integer)
+				return a.getInt() == b.getInt();
+			return a.getNumber() == b.getNumber();
+		}
+
+		if (a.type() != b.type())
+			return false;
+
+		switch (a.type()) {
+		case DT_Bool:
+			return a.getBool() == b.getBool();
+		case DT_String:
+			return a.getString() == b.getString();
+		default:
+			return false;
+		}
+	}
+
+	static bool matchesName(const SelectorStep& step, const DataGroup& grp)
+	{
+		return step.Wildcard || grp.id() == step.Name;
+	}
+
+	static void applyPredicates(const SelectorStep& step, vector_t<SelectorMatch>& matches, size_t first)
+	{
+		for (const SelectorPredicate& pred : step.Predicates) {
+			size_t count = first;
+			for (size_t i = first; i < matches.size(); ++i) {
+				bool keep;
+				switch (pred.Type) {
+				case SPT_Index:
+					keep = i - first == pred.Index;
+					break;
+				case SPT_Has:
+					keep = matches[i].Group->findFromKey(pred.Key) != nullptr;
+					break;
+				default: {
+					const Data* d = matches[i].Group->findFromKey(pred.Key);
+					keep		  = d && equals(*d, pred.Value);
+				} break;
+				}
+
+				if (keep)
+					matches[count++] = matches[i];
+			}
+			matches.resize(count);
+		}
+	}
+
+	// Applies a step to the entries of a group
+	static void applyChild(const SelectorStep& step, const DataGroup& grp, vector_t<SelectorMatch>& out)
+	{
+		switch (step.Type) {
+		case SST_Group: {
+			const size_t first = out.size();
+			for (const Data& d : grp.getAnonymousEntries()) {
+				if (d.type() == DT_Group && matchesName(step, d.getGroup()))
+					out.push_back(SelectorMatch{ &d.getGroup(), &d });
+			}
+			applyPredicates(step, out, first);
+		} break;
+		case SST_Key:
+			if (step.Wildcard) {
+				for (const Data& d : grp.getNamedEntries())
+					out.push_back(SelectorMatch{ d.type() == DT_Group ? &d.getGroup() : nullptr, &d });
+			} else {
+				const Data* d = grp.findFromKey(step.Name);
+				if (d)
+					out.push_back(SelectorMatch{ d->type() == DT_Group ? &d->getGroup() : nullptr, d });
+			}
+			break;
+		case SST_Index: {
+			const vector_t<Data>& entries = grp.getAnonymousEntries();
+			if (step.Wildcard) {
+				for (const Data& d : entries)
+					out.push_back(SelectorMatch{ d.type() == DT_Group ? &d.getGroup() : nullptr, &d });
+			} else if (step.Index < entries.size()) {
+				const Data& d = entries[step.Index];
+				out.push_back(SelectorMatch{ d.type() == DT_Group ? &d.getGroup() : nullptr, &d });
+			}
+		} break;
+		}
+	}
+
+	// Applies a step to the entries of a group and all its descendants
+	static void applyDeep(const SelectorStep& step, const DataGroup& grp, vector_t<SelectorMatch>& out)
+	{
+		applyChild(step, grp, out);
+
+		for (const Data& d : grp.getAnonymousEntries()) {
+			if (d.type() == DT_Group)
+				applyDeep(step, d.getGroup(), out);
+		}
+
+		for (const Data& d : grp.getNamedEntries()) {
+			if (d.type() == DT_Group)
+				applyDeep(step, d.getGroup(), out);
+		}
+	}
+
+	static void apply(const SelectorStep& step, const DataGroup& grp, vector_t<SelectorMatch>& out)
+	{
+		if (step.Deep)
+			applyDeep(step, grp, out);
+		else
+			applyChild(step, grp, out);
+	}
+
+	// The top groups are handled like the anonymous entries of a virtual root
+	void applyTop(const SelectorStep& step, const DataContainer& container, vector_t<SelectorMatch>& out) const
+	{
+		if (step.Type == SST_Group) {
+			const size_t first = out.size();
+			if (step.Wildcard) {
+				for (const DataGroup& grp : container.getTopGroups())
+					out.push_back(SelectorMatch{ &grp, nullptr });
+			} else {
+				for (const DataGroup* grp : container.findAllTopGroups(step.Name))
+					out.push_back(SelectorMatch{ grp, nullptr });
+			}
+			applyPredicates(step, out, first);
+		}
+
+		if (step.Deep) {
+			for (const DataGroup& grp : container.getTopGroups())
+				applyDeep(step, grp, out);
+		}
+	}
+
+	void continueFrom(size_t stepIndex, vector_t<SelectorMatch>& current, vector_t<SelectorMatch>& results) const
+	{
+		vector_t<SelectorMatch> next;
+		for (size_t s = stepIndex; s < mSteps.size() && !current.empty(); ++s) {
+			next.clear();
+			for (const SelectorMatch& m : current) {
+				if (m.Group)
+					apply(mSteps[s], *m.Group, next);
+			}
+			current.swap(next);
+		}
+
+		results.insert(results.end(), current.begin(), current.end());
+	}
+
+	string_t mPath;
+	vector_t<SelectorStep> mSteps;
+	bool mValid;
+
+	// Only used while compiling
+	SourceLogger* mLogger;
+	size_t mPos;
+};
+
+//---------------------------------------------------
+Selector::Selector()
+	: mInternal(new Selector_Internal)
+{
+}
+
+Selector::Selector(const string_t& path, SourceLogger* logger)
+	: mInternal(new Selector_Internal)
+{
+	compile(path, logger);
+}
+
+Selector::~Selector()
+{
+	if (mInternal)
+		delete mInternal;
+}
+
+Selector::Selector(const Selector& other)
+	: mInternal(new Selector_Internal(*other.mInternal))
+{
+}
+
+Selector::Selector(Selector&& other) noexcept
+{
+	mInternal		= other.mInternal;
+	other.mInternal = nullptr;
+}
+
+Selector& Selector::operator=(const Selector& other)
+{
+	if (this != &other)
+		*mInternal = *other.mInternal;
+	return *this;
+}
+
+Selector& Selector::operator=(Selector&& other) noexcept
+{
+	if (mInternal != other.mInternal) {
+		delete mInternal;
+		mInternal		= other.mInternal;
+		other.mInternal = nullptr;
+	}
+
+	return *this;
+}
+
+bool Selector::compile(const string_t& path, SourceLogger* logger)
+{
+	return mInternal->compile(path, logger);
+}
+
+bool Selector::isValid() const
+{
+	return mInternal->mValid;
+}
+
+const string_t& Selector::path() const
+{
+	return mInternal->mPath;
+}
+
+void Selector::evaluate(const DataContainer& container, vector_t<SelectorMatch>& results) const
+{
+	if (!mInternal->mValid)
+		return;
+
+	vector_t<SelectorMatch> current;
+	mInternal->applyTop(mInternal->mSteps.front(), container, current);
+	mInternal->continueFrom(1, current, results);
+}
+
+void Selector::evaluate(const DataGroup& group, vector_t<SelectorMatch>& results) const
+{
+	if (!mInternal->mValid)
+		return;
+
+	vector_t<SelectorMatch> current;
+	current.push_back(SelectorMatch{ &group, nullptr });
+	mInternal->continueFrom(0, current, results);
+}
+
+vector_t<SelectorMatch> Selector::select(const DataContainer& container) const
+{
+	vector_t<SelectorMatch> results;
+	evaluate(container, results);
+	return results;
+}
+
+const Data* Selector::first(const DataContainer& container) const
+{
+	for (const SelectorMatch& m : select(container)) {
+		if (m.Entry)
+			return m.Entry;
+	}
+
+	return nullptr;
+}
+} // namespace DL
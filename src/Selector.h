@@ -0,0 +1,146 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Data.h"
+#include "SourceLogger.h"
+
+namespace DL {
+class DataContainer;
+
+/** @class SelectorMatch Selector.h DL/Selector.h
+ * @brief Single result of a Selector
+ *
+ * Points directly into the evaluated container.
+ * @attention Only valid as long as the container is not modified.
+ */
+struct DL_LIB SelectorMatch {
+	const DataGroup* Group; ///< The matched group. NULL if the match is not a group
+	const Data* Entry;		///< The matched entry. NULL for top groups
+};
+
+/** @class Selector Selector.h DL/Selector.h
+ * @brief Compiled path query over a DataContainer
+ *
+ * A path consists of steps separated by '/'. A step separated by '//' is matched at any depth.
+ * - @c name Child groups with the given id. On top level the top groups with the given id
+ * - @c * All child groups
+ * - @c :key The named entry with the given key
+ * - @c :* All named entries
+ * - @c [n] The anonymous entry at position n
+ * - @c [*] All anonymous entries
+ *
+ * Group steps can be followed by predicates:
+ * - @c [n] Only the n-th matched group per parent
+ * - @c [*] All matched groups
+ * - @c [:key] Only groups with the named entry
+ * - @c [:key=value] Only groups with the named entry equal to the value.
+ *   The value is an integer, a float, a quoted string, @c true or @c false
+ *
+ * @subsection Example
+ * @code{.cpp}
+ * DL::Selector selector;
+ * selector.compile("scene/object[:visible=true]/:material");
+ *
+ * DL::vector_t<DL::SelectorMatch> results;
+ * selector.evaluate(container, results);
+ * @endcode
+ * The selector is compiled once and can be evaluated any number of times, concurrently on frozen containers.
+ * Top groups are found with DataContainer::findAllTopGroups and named entries with DataGroup::findFromKey,
+ * therefor both use the available indices.
+ */
+class DL_LIB Selector {
+public:
+	/**
+	 * @brief Constructs an empty selector without any match
+	 */
+	Selector();
+
+	/**
+	 * @brief Constructs and compiles the given path
+	 * @see compile
+	 */
+	explicit Selector(const string_t& path, SourceLogger* logger = nullptr);
+	~Selector();
+
+	Selector(const Selector& other);
+	Selector(Selector&& other) noexcept;
+	Selector& operator=(const Selector& other);
+	Selector& operator=(Selector&& other) noexcept;
+
+	/**
+	 * @brief Compiles the given path
+	 *
+	 * @attention Syntax errors will be post to the given SourceLogger instance, if available.
+	 * The column refers to the position inside the path.
+	 * @return True if successful
+	 */
+	bool compile(const string_t& path, SourceLogger* logger = nullptr);
+
+	/**
+	 * @brief Returns true if a path was compiled successfully
+	 */
+	bool isValid() const;
+
+	/**
+	 * @brief Returns the compiled path
+	 */
+	const string_t& path() const;
+
+	/**
+	 * @brief Evaluates the selector starting from the top groups
+	 * @param container The container to query
+	 * @param results List the matches are added to. Will not be cleared!
+	 */
+	void evaluate(const DataContainer& container, vector_t<SelectorMatch>& results) const;
+
+	/**
+	 * @brief Evaluates the selector starting from the entries of the given group
+	 * @param group The group to query
+	 * @param results List the matches are added to. Will not be cleared!
+	 */
+	void evaluate(const DataGroup& group, vector_t<SelectorMatch>& results) const;
+
+	/**
+	 * @brief Returns all matches in the container
+	 * @see evaluate
+	 */
+	vector_t<SelectorMatch> select(const DataContainer& container) const;
+
+	/**
+	 * @brief Returns the first matched entry in the container
+	 * @return Pointer to the entry if available, NULL otherwise
+	 */
+	const Data* first(const DataContainer& container) const;
+
+private:
+	class Selector_Internal* mInternal;
+};
+} // namespace DL
@@ -28,6 +28,7 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
  */
 #include "SourceLogger.h"
+#include "Diagnostic.h"
 
 #include <stdarg.h>
 #include <sstream>
@@ -36,7 +37,13 @@
 namespace DL
 {
 	SourceLogger::SourceLogger() :
-		mWarningCount(0), mErrorCount(0)
+		mWarningCount(0), mErrorCount(0), mMinimumLevel(L_Debug), mRepeatLimit(0)
+	{
+	}
+
+	SourceLogger::SourceLogger(const SourceLogger& other) :
+		mWarningCount(other.mWarningCount.load()), mErrorCount(other.mErrorCount.load()),
+		mMinimumLevel(other.mMinimumLevel), mRepeatLimit(other.mRepeatLimit), mRepeated(other.mRepeated)
 	{
 	}
 
@@ -44,8 +51,22 @@ namespace DL
 	{
 	}
 
+	SourceLogger& SourceLogger::operator=(const SourceLogger& other)
+	{
+		mWarningCount = other.mWarningCount.load();
+		mErrorCount = other.mErrorCount.load();
+		mMinimumLevel = other.mMinimumLevel;
+		mRepeatLimit = other.mRepeatLimit;
+		mRepeated = other.mRepeated;
+		return *this;
+	}
+
 	void SourceLogger::log(line_t line, column_t column, Level level, const string_t& str)
 	{
+		count(level);
+		if (!enabled(level))
+			return;
+
 		std::stringstream stream;
 		stream << "[" << line << "](" << column << ") " << str;
 
@@ -73,6 +94,10 @@ namespace DL
 
 	void SourceLogger::log(Level level, const string_t& str)
 	{
+		count(level);
+		if (!enabled(level))
+			return;
+
 		string_t pre;
 		switch (level)
 		{
@@ -95,6 +120,68 @@ namespace DL
 		std::cout << pre << str << std::endl;
 	}
 
+	void SourceLogger::report(const Diagnostic& diagnostic)
+	{
+		if (!enabled(diagnostic.Severity))
+		{
+			count(diagnostic.Severity);
+			return;
+		}
+
+		const string_t str = diagnostic.message();
+		if (isRepeated(diagnostic.Severity, str))
+			return;
+
+		if (diagnostic.hasPosition())
+			log(diagnostic.Line, diagnostic.Column, diagnostic.Severity, str);
+		else
+			log(diagnostic.Severity, str);
+	}
+
+	void SourceLogger::setRepeatLimit(uint32 limit)
+	{
+		mRepeatLimit = limit;
+		mRepeated.clear();
+	}
+
+	bool SourceLogger::isRepeated(Level level, const string_t& str)
+	{
+		if (mRepeatLimit == 0 || level >= L_Error)
+			return false;
+
+		uint32& repeats = mRepeated[std::make_pair(level, str)];
+		if (++repeats <= mRepeatLimit)
+			return false;
+
+		count(level);
+		return true;
+	}
+
+	void SourceLogger::flushRepeated()
+	{
+		// Swap first, the summaries are logged through the virtual interface again
+		map_t<std::pair<Level, string_t>, uint32> repeated;
+		repeated.swap(mRepeated);
+
+		for (const auto& p : repeated)
+		{
+			if (p.second <= mRepeatLimit)
+				continue;
+
+			std::stringstream stream;
+			stream << "Suppressed " << (p.second - mRepeatLimit) << " repetitions of: " << p.first.second;
+			log(L_Info, stream.str());
+		}
+	}
+
+	void SourceLogger::count(Level level)
+	{
+		if (level == L_Warning)
+			mWarningCount.fetch_add(1, std::memory_order_relaxed);
+		else if (level == L_Error || level == L_Fatal)
+			mErrorCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
 	int SourceLogger::warningCount() const
 	{
 		return mWarningCount;
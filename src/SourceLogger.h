@@ -31,7 +31,11 @@
 
 #include "DataLispConfig.h"
 
+#include <atomic>
+
 namespace DL {
+struct Diagnostic;
+
 typedef uint32 line_t;
 typedef uint32 column_t;
 
@@ -49,12 +53,18 @@ enum Level {
  *
  * This class logs information to the standard output.<br>
  * Other output styles can be added by overriding the virtual functions.
+ *
+ * The warning and error counters can be updated concurrently.
+ * @see DiagnosticBuffer
  */
 class DL_LIB SourceLogger {
 public:
 	SourceLogger();
+	SourceLogger(const SourceLogger& other);
 	virtual ~SourceLogger();
 
+	SourceLogger& operator=(const SourceLogger& other);
+
 	/**
 	 * @brief Logs the information additionaly with line and column to standard output
 	 * @param line The line the information refers
@@ -71,6 +81,95 @@ public:
 	 */
 	virtual void log(Level level, const string_t& str);
 
+	/**
+	 * @brief Reports a structured diagnostic
+	 *
+	 * The default implementation formats the diagnostic and passes it to @link log @endlink,
+	 * if its level is enabled and it is not over the repeat limit.
+	 * @param diagnostic The diagnostic
+	 */
+	virtual void report(const Diagnostic& diagnostic);
+
+	/**
+	 * @brief Logs a message which is only formatted if its level is enabled
+	 *
+	 * Suppressed messages are counted, but cost nothing else.
+	 * Repeated messages are limited as well, see @link setRepeatLimit @endlink.
+	 * @param line The line the information refers
+	 * @param column The column the information refers
+	 * @param level Importance level
+	 * @param formatter Callable returning the message as string_t
+	 */
+	template <typename Formatter>
+	inline void logLazy(line_t line, column_t column, Level level, Formatter&& formatter)
+	{
+		if (!enabled(level)) {
+			count(level);
+			return;
+		}
+
+		const string_t str = formatter();
+		if (!isRepeated(level, str))
+			log(line, column, level, str);
+	}
+
+	/**
+	 * @brief Logs a message without position which is only formatted if its level is enabled
+	 * @see logLazy(line_t, column_t, Level, Formatter&&)
+	 */
+	template <typename Formatter>
+	inline void logLazy(Level level, Formatter&& formatter)
+	{
+		if (!enabled(level)) {
+			count(level);
+			return;
+		}
+
+		const string_t str = formatter();
+		if (!isRepeated(level, str))
+			log(level, str);
+	}
+
+	/**
+	 * @brief Sets the minimum level of messages to output
+	 *
+	 * Messages below are still counted. The default is @link L_Debug @endlink.
+	 */
+	inline void setMinimumLevel(Level level) { mMinimumLevel = level; }
+
+	/**
+	 * @brief Returns the minimum level of messages to output
+	 */
+	inline Level minimumLevel() const { return mMinimumLevel; }
+
+	/**
+	 * @brief Returns true if messages of the given level are output
+	 *
+	 * Should be checked before formatting expensive messages.
+	 */
+	inline bool enabled(Level level) const { return level >= mMinimumLevel; }
+
+	/**
+	 * @brief Limits how often an identical warning, information or debug message given by @link logLazy @endlink is output
+	 *
+	 * Further repetitions are only counted and summarized by @link flushRepeated @endlink.
+	 * Errors are never limited.
+	 * @param limit Maximum amount of identical messages. Zero disables the limit
+	 */
+	void setRepeatLimit(uint32 limit);
+
+	/**
+	 * @brief Returns the repeat limit. Zero if disabled
+	 */
+	inline uint32 repeatLimit() const { return mRepeatLimit; }
+
+	/**
+	 * @brief Outputs how often each message over the repeat limit was suppressed and starts counting again
+	 *
+	 * Called by DataLisp::build after building.
+	 */
+	void flushRepeated();
+
 	/**
 	 * @brief Amount of warnings occured
 	 */
@@ -81,8 +180,23 @@ public:
 	 */
 	int errorCount() const;
 
+protected:
+	/**
+	 * @brief Updates the warning and error counters for a message of the given level
+	 *
+	 * Called by the default log implementations.
+	 * Overriding classes should call it to keep the counters valid.
+	 */
+	void count(Level level);
+
 private:
-	int mWarningCount;
-	int mErrorCount;
+	bool isRepeated(Level level, const string_t& str);
+
+	std::atomic<int> mWarningCount;
+	std::atomic<int> mErrorCount;
+	Level mMinimumLevel;
+
+	uint32 mRepeatLimit;
+	map_t<std::pair<Level, string_t>, uint32> mRepeated;
 };
 } // namespace DL
@@ -0,0 +1,119 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Statistics.h"
+#include "internal/NumberFormat.h"
+
+namespace DL {
+static const char* TYPE_NAMES[DT_None] = { "group", "integer", "float", "bool", "string" };
+
+Statistics::Statistics()
+{
+	reset();
+}
+
+void Statistics::reset()
+{
+	LexTime		 = 0;
+	ParseTime	 = 0;
+	BuildTime	 = 0;
+	GenerateTime = 0;
+
+	ParsedBytes	   = 0;
+	GeneratedBytes = 0;
+	TokenCount	   = 0;
+
+	for (uint64& count : NodeCount)
+		count = 0;
+	NodeAllocations = 0;
+	PeakTreeMemory	= 0;
+
+	Expressions.clear();
+}
+
+static void appendField(string_t& out, const char* name, uint64 value, bool comma = true)
+{
+	out += '"';
+	out += name;
+	out += "\":";
+	appendInteger(out, static_cast<Integer>(value));
+	if (comma)
+		out += ',';
+}
+
+static void appendName(string_t& out, const string_t& name)
+{
+	out += '"';
+	for (char c : name) {
+		if (c == '"' || c == '\\')
+			out += '\\';
+		out += c;
+	}
+	out += '"';
+}
+
+string_t Statistics::toJson() const
+{
+	string_t out = "{\"time\":{";
+	appendField(out, "lex", LexTime);
+	appendField(out, "parse", ParseTime);
+	appendField(out, "build", BuildTime);
+	appendField(out, "generate", GenerateTime, false);
+	out += "},";
+
+	appendField(out, "parsed_bytes", ParsedBytes);
+	appendField(out, "generated_bytes", GeneratedBytes);
+	appendField(out, "tokens", TokenCount);
+
+	out += "\"nodes\":{";
+	for (int i = 0; i < DT_None; ++i)
+		appendField(out, TYPE_NAMES[i], NodeCount[i], i + 1 < DT_None);
+	out += "},";
+
+	appendField(out, "node_allocations", NodeAllocations);
+	appendField(out, "peak_tree_memory", PeakTreeMemory);
+
+	out += "\"expressions\":{";
+	bool first = true;
+	for (const auto& p : Expressions) {
+		if (!first)
+			out += ',';
+		first = false;
+
+		appendName(out, p.first);
+		out += ":{";
+		appendField(out, "calls", p.second.Calls);
+		appendField(out, "time", p.second.Time, false);
+		out += '}';
+	}
+	out += "}}";
+
+	return out;
+}
+} // namespace DL
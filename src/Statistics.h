@@ -0,0 +1,94 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLispConfig.h"
+#include "DataType.h"
+
+namespace DL {
+/**
+ * @brief Evaluation counters of a single expression
+ * @see Statistics
+ */
+struct DL_LIB ExpressionStatistics {
+	uint64 Calls; ///< Number of evaluations
+	uint64 Time;  ///< Cumulative time spent in the expression in nanoseconds, excluding its arguments
+};
+
+/** @class Statistics Statistics.h DL/Statistics.h
+ * @brief Per phase timings and counters of DataLisp
+ *
+ * Filled by DataLisp::parse, DataLisp::build and DataLisp::generate if given.
+ * All counters accumulate until @link reset @endlink is called.
+ * Without a statistics object nothing is measured.
+ *
+ * Lexing happens on demand while parsing.
+ * The parse time therefor excludes the lex time, which is measured per token.
+ * All times are in nanoseconds.
+ *
+ * @subsection Example
+ * @code{.cpp}
+ * DL::Statistics stats;
+ * datalisp.setStatistics(&stats);
+ * datalisp.parse(source);
+ * datalisp.build(container);
+ * std::cout << stats.toJson() << std::endl;
+ * @endcode
+ * @see DataLisp::setStatistics
+ */
+struct DL_LIB Statistics {
+	uint64 LexTime;		 ///< Time spent in the lexer
+	uint64 ParseTime;	 ///< Time spent parsing, excluding the lexer
+	uint64 BuildTime;	 ///< Time spent building, including the expressions
+	uint64 GenerateTime; ///< Time spent generating source code
+
+	uint64 ParsedBytes;	   ///< Size of all parsed sources
+	uint64 GeneratedBytes; ///< Size of all generated sources
+	uint64 TokenCount;	   ///< Number of tokens produced by the lexer
+
+	uint64 NodeCount[DT_None]; ///< Number of built entries per type, including the top groups and expression arguments
+	uint64 NodeAllocations;	///< Syntax tree nodes which had to be allocated, instead of being recycled
+	uint64 PeakTreeMemory;	///< Largest syntax tree in bytes, including its strings
+
+	map_t<string_t, ExpressionStatistics> Expressions; ///< Evaluation counters per expression name
+
+	Statistics();
+
+	/**
+	 * @brief Sets all counters to zero
+	 */
+	void reset();
+
+	/**
+	 * @brief Returns all counters as a single JSON object
+	 */
+	string_t toJson() const;
+};
+} // namespace DL
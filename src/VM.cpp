@@ -30,12 +30,15 @@
 #include "VM.h"
 #include "SourceLogger.h"
 
-#include <sstream>
-
 namespace DL {
 VM::VM(DataContainer& container, SourceLogger* logger)
 	: mContainer(container)
 	, mLogger(logger)
+	, mFileId(0)
+	, mLine(0)
+	, mColumn(0)
+	, mBegin(0)
+	, mEnd(0)
 {
 }
 
@@ -43,26 +46,6 @@ VM::~VM()
 {
 }
 
-static std::string typeToName(DataType type)
-{
-	switch (type) {
-	case DT_Bool:
-		return "Bool";
-	case DT_Integer:
-		return "Integer";
-	case DT_Float:
-		return "Float";
-	case DT_String:
-		return "String";
-	case DT_Group:
-		return "Group";
-	case DT_None:
-		return "None";
-	default:
-		return "Unknown";
-	}
-}
-
 Data VM::castTo(const Data& d, DL::DataType type, bool isExplicit)
 {
 	if (d.type() == type)
@@ -109,8 +92,9 @@ Data VM::castTo(const Data& d, DL::DataType type, bool isExplicit)
 			return r;
 		}
 		case DT_Integer: {
+			// Very frequent in numeric sources, only formatted if requested
 			if (!isExplicit)
-				mLogger->log(L_Warning, "Implicit conversion from 'Integer' to 'Float'");
+				report(Diagnostic(DC_ImplicitConversion, L_Warning, DT_Integer, DT_Float));
 
 			Data r(d.key());
 			r.setFloat(static_cast<Float>(d.getInt()));
@@ -124,9 +108,7 @@ Data VM::castTo(const Data& d, DL::DataType type, bool isExplicit)
 		break;
 	}
 
-	std::stringstream stream;
-	stream << "Can not convert '" << typeToName(d.type()) << "' to '" << typeToName(type) << "'";
-	mLogger->log(L_Error, stream.str());
+	report(Diagnostic(DC_InvalidConversion, L_Error, d.type(), type));
 	return Data();
 }
 
@@ -149,4 +131,23 @@ Data VM::doElementWise(element_expr_t expr, const vector_t<Data>& args)
 		return r;
 	}
 }
-} // namespace DL
\ No newline at end of file
+
+void VM::report(Diagnostic diagnostic)
+{
+	diagnostic.FileId = mFileId;
+	diagnostic.Line	  = mLine;
+	diagnostic.Column = mColumn;
+	diagnostic.Begin  = mBegin;
+	diagnostic.End	  = mEnd;
+	mLogger->report(diagnostic);
+}
+
+void VM::setLocation(uint32 fileId, line_t line, column_t column, uint32 begin, uint32 end)
+{
+	mFileId = fileId;
+	mLine	= line;
+	mColumn = column;
+	mBegin	= begin;
+	mEnd	= end;
+}
+} // namespace DL
@@ -30,6 +30,7 @@
 #pragma once
 
 #include "Data.h"
+#include "Diagnostic.h"
 
 namespace DL {
 class DataContainer;
@@ -82,8 +83,30 @@ public:
 	 */
 	Data doElementWise(element_expr_t expr, const vector_t<Data>& args);
 
+	/**
+	 * @brief Reports a diagnostic at the source location of the currently evaluated expression
+	 *
+	 * The position and file id of the given diagnostic are overwritten.
+	 * @param diagnostic The diagnostic to report
+	 */
+	void report(Diagnostic diagnostic);
+
+	/**
+	 * @brief Sets the source location of the currently evaluated expression
+	 *
+	 * Called by DataLisp before each expression.
+	 * @see report
+	 */
+	void setLocation(uint32 fileId, line_t line, column_t column, uint32 begin, uint32 end);
+
 private:
 	DataContainer& mContainer;
 	SourceLogger* mLogger;
+
+	uint32 mFileId;
+	line_t mLine;
+	column_t mColumn;
+	uint32 mBegin;
+	uint32 mEnd;
 };
 } // namespace DL
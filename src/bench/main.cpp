@@ -0,0 +1,389 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+#include "DataLisp.h"
+#include "internal/Lexer.h"
+#include "internal/MemoryStream.h"
+
+// The benchmark links the library statically, so all allocations pass these operators
+static std::atomic<uint64_t> sAllocations(0);
+static std::atomic<uint64_t> sAllocatedBytes(0);
+
+void* operator new(size_t size)
+{
+	sAllocations.fetch_add(1, std::memory_order_relaxed);
+	sAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+//---------------------------------------------------
+// Corpus generation
+class Random {
+public:
+	explicit Random(uint64_t seed)
+		: mState(seed)
+	{
+	}
+
+	uint64_t next()
+	{
+		uint64_t z = (mState += 0x9E3779B97F4A7C15ULL);
+		z		   = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z		   = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	int range(int max) { return static_cast<int>(next() % static_cast<uint64_t>(max)); }
+
+private:
+	uint64_t mState;
+};
+
+static void appendValue(std::string& out, Random& rnd)
+{
+	switch (rnd.range(4)) {
+	case 0:
+		out += std::to_string(rnd.range(100000));
+		break;
+	case 1:
+		out += std::to_string(rnd.range(1000)) + "." + std::to_string(rnd.range(1000));
+		break;
+	case 2:
+		out += rnd.range(2) ? "true" : "false";
+		break;
+	default:
+		out += "\"value" + std::to_string(rnd.range(1000)) + "\"";
+		break;
+	}
+}
+
+static void generateDeep(std::string& out, Random& rnd, size_t)
+{
+	const int depth = 48;
+	out += "(deep";
+	for (int i = 0; i < depth; ++i) {
+		out += " (level :index " + std::to_string(i) + " :value ";
+		appendValue(out, rnd);
+	}
+	out += std::string(depth, ')');
+	out += ")\n";
+}
+
+static void generateWide(std::string& out, Random& rnd, size_t index)
+{
+	out += "(wide" + std::to_string(index % 64);
+	for (int i = 0; i < 256; ++i) {
+		out += " :key" + std::to_string(i) + " ";
+		appendValue(out, rnd);
+	}
+	out += ")\n";
+}
+
+static void generateNumeric(std::string& out, Random& rnd, size_t)
+{
+	out += "(numbers :values [";
+	for (int i = 0; i < 1024; ++i) {
+		if (i != 0)
+			out += ' ';
+		if (rnd.range(2))
+			out += std::to_string(rnd.range(1000000));
+		else
+			out += std::to_string(rnd.range(1000)) + "." + std::to_string(rnd.range(100000)) + "e-" + std::to_string(rnd.range(10));
+	}
+	out += "])\n";
+}
+
+static void generateStrings(std::string& out, Random& rnd, size_t)
+{
+	static const char* WORDS[] = { "lorem", "ipsum", "dolor", "sit", "amet", "\\\"quoted\\\"", "new\\nline", "tab\\t", "\\u00e4" };
+	out += "(text";
+	for (int i = 0; i < 32; ++i) {
+		out += " :s" + std::to_string(i) + " \"";
+		const int words = 4 + rnd.range(32);
+		for (int w = 0; w < words; ++w) {
+			out += WORDS[rnd.range(sizeof(WORDS) / sizeof(WORDS[0]))];
+			out += ' ';
+		}
+		out += "\"";
+	}
+	out += ")\n";
+}
+
+static void generateExpressions(std::string& out, Random& rnd, size_t)
+{
+	out += "(expr";
+	for (int i = 0; i < 64; ++i) {
+		out += " :e" + std::to_string(i) + " ";
+		switch (rnd.range(4)) {
+		case 0:
+			out += "$(if $(and true $(not false)) " + std::to_string(rnd.range(100)) + " 0)";
+			break;
+		case 1:
+			out += "$(float " + std::to_string(rnd.range(1000)) + ")";
+			break;
+		case 2:
+			out += "$(named (g :a 1 :b 2))";
+			break;
+		default:
+			out += "$(or false $(bool 1))";
+			break;
+		}
+	}
+	out += ")\n";
+}
+
+typedef void (*generator_t)(std::string&, Random&, size_t);
+
+struct Shape {
+	const char* Name;
+	generator_t Generator;
+};
+
+static const Shape SHAPES[] = {
+	{ "deep", generateDeep },
+	{ "wide", generateWide },
+	{ "numeric", generateNumeric },
+	{ "strings", generateStrings },
+	{ "expressions", generateExpressions },
+};
+
+static std::string generateCorpus(const Shape& shape, size_t size)
+{
+	Random rnd(0xDA7A115Bu);
+	std::string out;
+	out.reserve(size + size / 8);
+	for (size_t i = 0; out.size() < size; ++i)
+		shape.Generator(out, rnd, i);
+	return out;
+}
+
+//---------------------------------------------------
+// Measurement
+struct Phase {
+	double Seconds			 = 0;
+	uint64_t Items			 = 0;
+	uint64_t Bytes			 = 0;
+	uint64_t Allocations	 = 0;
+	uint64_t AllocatedBytes = 0;
+};
+
+template <typename Func>
+static Phase measure(int repeat, Func func)
+{
+	Phase best;
+	for (int r = 0; r < repeat; ++r) {
+		const uint64_t allocs = sAllocations.load();
+		const uint64_t bytes  = sAllocatedBytes.load();
+		const auto start	  = std::chrono::steady_clock::now();
+
+		Phase p;
+		func(p);
+
+		p.Seconds		 = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		p.Allocations	 = sAllocations.load() - allocs;
+		p.AllocatedBytes = sAllocatedBytes.load() - bytes;
+		if (r == 0 || p.Seconds < best.Seconds)
+			best = p;
+	}
+	return best;
+}
+
+static uint64_t countEntries(const DL::DataGroup& grp)
+{
+	uint64_t count = 1;
+	for (const DL::Data& d : grp.getAnonymousEntries())
+		count += d.type() == DL::DT_Group ? countEntries(d.getGroup()) : 1;
+	for (const DL::Data& d : grp.getNamedEntries())
+		count += d.type() == DL::DT_Group ? countEntries(d.getGroup()) : 1;
+	return count;
+}
+
+static void writePhase(std::ostream& out, const char* name, const Phase& p, bool last)
+{
+	const double seconds = p.Seconds > 0 ? p.Seconds : 1e-9;
+	char buffer[512];
+	std::snprintf(buffer, sizeof(buffer),
+				  "        \"%s\": {\"seconds\": %.6f, \"mb_per_s\": %.3f, \"nodes\": %llu, \"nodes_per_s\": %.1f, "
+				  "\"allocations\": %llu, \"allocated_bytes\": %llu}%s\n",
+				  name, p.Seconds, p.Bytes / (1024.0 * 1024.0) / seconds,
+				  static_cast<unsigned long long>(p.Items), p.Items / seconds,
+				  static_cast<unsigned long long>(p.Allocations), static_cast<unsigned long long>(p.AllocatedBytes),
+				  last ? "" : ",");
+	out << buffer;
+}
+
+static bool runShape(const Shape& shape, size_t size, int repeat, std::ostream& out, bool last)
+{
+	const std::string corpus = generateCorpus(shape, size);
+
+	const Phase lex = measure(repeat, [&](Phase& p) {
+		DL::SourceLogger logger;
+		DL::MemoryStreamBuf buffer(corpus.data(), corpus.size());
+		DL::stream_t stream(&buffer);
+		DL::Lexer lexer(&stream, &logger);
+		while (lexer.next().Type != DL::T_EOF)
+			++p.Items;
+		p.Bytes = corpus.size();
+	});
+
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	const Phase parse = measure(repeat, [&](Phase& p) {
+		lisp.reset();
+		lisp.parse(corpus);
+		p.Items = lex.Items;
+		p.Bytes = corpus.size();
+	});
+
+	if (logger.errorCount() != 0) {
+		std::cerr << "Corpus '" << shape.Name << "' contains errors" << std::endl;
+		return false;
+	}
+
+	DL::DataContainer container;
+	const Phase build = measure(repeat, [&](Phase& p) {
+		DL::DataContainer tmp;
+		lisp.build(tmp);
+		for (const DL::DataGroup& grp : tmp.getTopGroups())
+			p.Items += countEntries(grp);
+		p.Bytes	  = corpus.size();
+		container = std::move(tmp);
+	});
+
+	const Phase generate = measure(repeat, [&](Phase& p) {
+		const std::string source = DL::DataLisp::generate(container);
+		p.Items					 = build.Items;
+		p.Bytes					 = source.size();
+	});
+
+	container.freeze();
+	const Phase lookup = measure(repeat, [&](Phase& p) {
+		for (const DL::DataGroup& grp : container.getTopGroups()) {
+			if (container.findTopGroup(grp.id()))
+				++p.Items;
+			for (const DL::Data& d : grp.getNamedEntries()) {
+				if (grp.findFromKey(d.key()))
+					++p.Items;
+			}
+		}
+	});
+
+	out << "    {\n      \"shape\": \"" << shape.Name << "\",\n      \"bytes\": " << corpus.size() << ",\n      \"phases\": {\n";
+	writePhase(out, "lex", lex, false);
+	writePhase(out, "parse", parse, false);
+	writePhase(out, "build", build, false);
+	writePhase(out, "generate", generate, false);
+	writePhase(out, "lookup", lookup, true);
+	out << "      }\n    }" << (last ? "" : ",") << "\n";
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	size_t size		   = 4 * 1024 * 1024;
+	int repeat		   = 3;
+	std::string only;
+	std::string output;
+	std::string corpusDir;
+
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--size" && i + 1 < argc)
+			size = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--repeat" && i + 1 < argc)
+			repeat = std::max(1, std::atoi(argv[++i]));
+		else if (arg == "--shape" && i + 1 < argc)
+			only = argv[++i];
+		else if (arg == "--output" && i + 1 < argc)
+			output = argv[++i];
+		else if (arg == "--corpus" && i + 1 < argc)
+			corpusDir = argv[++i];
+		else {
+			std::cout << "Use 'dl_bench [--size BYTES] [--repeat N] [--shape NAME] [--output FILE] [--corpus DIR]'" << std::endl;
+			std::cout << "Shapes: deep, wide, numeric, strings, expressions" << std::endl;
+			return -1;
+		}
+	}
+
+	DL::vector_t<const Shape*> shapes;
+	for (const Shape& shape : SHAPES) {
+		if (only.empty() || only == shape.Name)
+			shapes.push_back(&shape);
+	}
+
+	if (shapes.empty()) {
+		std::cout << "Unknown shape '" << only << "'" << std::endl;
+		return -1;
+	}
+
+	// Only write the corpora to inspect or reuse them
+	if (!corpusDir.empty()) {
+		for (const Shape* shape : shapes) {
+			std::ofstream file(corpusDir + "/" + shape->Name + ".dl", std::ios::out | std::ios::binary);
+			file << generateCorpus(*shape, size);
+		}
+		return 0;
+	}
+
+	std::stringstream out;
+	out << "{\n  \"version\": \"" << DL_VERSION_STRING << "\",\n  \"variant\": \"" << DL_BUILDVARIANT_NAME
+		<< "\",\n  \"size\": " << size << ",\n  \"repeat\": " << repeat << ",\n  \"results\": [\n";
+	for (size_t i = 0; i < shapes.size(); ++i) {
+		if (!runShape(*shapes[i], size, repeat, out, i + 1 == shapes.size()))
+			return -2;
+	}
+	out << "  ]\n}\n";
+
+	if (output.empty()) {
+		std::cout << out.str();
+	} else {
+		std::ofstream file(output);
+		file << out.str();
+	}
+
+	return 0;
+}
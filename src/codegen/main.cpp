@@ -0,0 +1,481 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include "Binding.h"
+#include "Schema.h"
+#include "SourceLogger.h"
+
+std::string get_file_contents(const char* filename)
+{
+	std::ifstream in(filename, std::ios::in | std::ios::binary);
+	if (in) {
+		std::string contents;
+		in.seekg(0, std::ios::end);
+		contents.resize(in.tellg());
+		in.seekg(0, std::ios::beg);
+		in.read(&contents[0], contents.size());
+		in.close();
+		return (contents);
+	}
+	throw(errno);
+}
+
+static const char* KEYWORDS[] = {
+	"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+	"char", "char16_t", "char32_t", "class", "compl", "const", "constexpr", "const_cast", "continue", "decltype",
+	"default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false",
+	"float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept",
+	"not", "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+	"reinterpret_cast", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+	"switch", "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+	"unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+};
+
+// Members every view has, keys are not allowed to hide them
+static const char* RESERVED[] = {
+	"bind", "isValid", "group", "groupId", "find", "anonymous", "anonymousCount", "entry", "element",
+	"mGroup", "mSlots", "NO_SLOT"
+};
+
+static bool is_keyword(const std::string& str)
+{
+	for (const char* keyword : KEYWORDS) {
+		if (str == keyword)
+			return true;
+	}
+	return false;
+}
+
+// Names are turned into camel case, only class names start with an upper case character
+static std::string to_identifier(const std::string& name, bool upper)
+{
+	std::string id;
+	bool next_upper = upper;
+	for (char c : name) {
+		const unsigned char u = static_cast<unsigned char>(c);
+		if (u < 128 && std::isalnum(u)) {
+			id += next_upper ? static_cast<char>(std::toupper(u)) : c;
+			next_upper = false;
+		} else {
+			next_upper = upper || !id.empty();
+		}
+	}
+
+	if (id.empty() || std::isdigit(static_cast<unsigned char>(id[0])))
+		id = (upper ? "Group" : "key") + id;
+	else if (!upper)
+		id[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(id[0])));
+
+	if (is_keyword(id))
+		id += '_';
+	return id;
+}
+
+static std::string make_unique(std::string name, std::set<std::string>& used)
+{
+	while (used.count(name))
+		name += '_';
+	used.insert(name);
+	return name;
+}
+
+static std::string to_literal(const std::string& str)
+{
+	std::ostringstream stream;
+	stream << '"';
+	for (char c : str) {
+		const unsigned char u = static_cast<unsigned char>(c);
+		if (c == '"' || c == '\\')
+			stream << '\\' << c;
+		else if (u < 32 || u >= 127)
+			stream << '\\' << static_cast<char>('0' + ((u >> 6) & 7)) << static_cast<char>('0' + ((u >> 3) & 7)) << static_cast<char>('0' + (u & 7));
+		else
+			stream << c;
+	}
+	stream << '"';
+	return stream.str();
+}
+
+// C++ representation of a value described by the schema
+struct Accessor {
+	std::string Type;
+	std::string Default; // Empty if the accessor has no default parameter
+	std::string Body;	 // Returns the value of the entry 'd', which might be NULL
+};
+
+class Generator {
+public:
+	Generator(const DL::vector_t<DL::SchemaGroupInfo>& groups, const std::string& source)
+		: mGroups(groups)
+		, mSource(source)
+	{
+		std::set<std::string> used;
+		for (const DL::SchemaGroupInfo& info : mGroups)
+			mClasses[info.ID] = make_unique(to_identifier(info.ID, true), used);
+	}
+
+	std::string run(const std::string& ns, const std::string& prefix)
+	{
+		mOut.str(std::string());
+		mOut << "// Generated by dl_codegen from '" << mSource << "'. Do not edit!\n"
+			 << "#pragma once\n\n"
+			 << "#include \"" << prefix << "Binding.h\"\n"
+			 << "#include \"" << prefix << "DataContainer.h\"\n"
+			 << "#include \"" << prefix << "DataGroup.h\"\n\n";
+
+		if (!ns.empty())
+			mOut << "namespace " << ns << " {\n";
+
+		for (const DL::SchemaGroupInfo& info : mGroups)
+			mOut << "class " << mClasses[info.ID] << ";\n";
+
+		for (const DL::SchemaGroupInfo& info : mGroups)
+			declare(info);
+		for (const DL::SchemaGroupInfo& info : mGroups)
+			define(info);
+
+		if (!ns.empty())
+			mOut << "} // namespace " << ns << "\n";
+		return mOut.str();
+	}
+
+private:
+	struct Member {
+		const DL::SchemaEntryInfo* Info;
+		std::string Name;
+		std::string Has;
+		std::string Count;
+	};
+
+	Accessor accessor(DL::SchemaType type, const std::string& groupId) const
+	{
+		switch (type) {
+		case DL::ST_Integer:
+			return Accessor{ "DL::Integer", "0", "return d && d->type() == DL::DT_Integer ? d->getInt() : def;" };
+		case DL::ST_Float:
+		case DL::ST_Number:
+			return Accessor{ "DL::Float", "0.0f", "return d && d->isNumber() ? d->getNumber() : def;" };
+		case DL::ST_Bool:
+			return Accessor{ "bool", "false", "return d && d->type() == DL::DT_Bool ? d->getBool() : def;" };
+		case DL::ST_String:
+			return Accessor{ "DL::string_t", "DL::string_t()", "return d && d->type() == DL::DT_String ? d->getString() : def;" };
+		case DL::ST_Group: {
+			// Groups without definition are given as is
+			auto it = mClasses.find(groupId);
+			if (it == mClasses.end())
+				return accessor(DL::ST_Array, groupId);
+			return Accessor{ it->second, "", "return d && d->type() == DL::DT_Group ? " + it->second + "(d->getGroup()) : " + it->second + "();" };
+		}
+		case DL::ST_Array:
+			return Accessor{ "const DL::DataGroup*", "", "return d && d->type() == DL::DT_Group ? &d->getGroup() : nullptr;" };
+		default:
+			return Accessor{ "const DL::Data*", "", "return d;" };
+		}
+	}
+
+	std::string parameters(const Accessor& acc, bool index, bool withDefault) const
+	{
+		std::string params = index ? "size_t index" : "";
+		if (!acc.Default.empty()) {
+			if (index)
+				params += ", ";
+			params += acc.Type + " def";
+			if (withDefault)
+				params += " = " + acc.Default;
+		}
+		return params;
+	}
+
+	std::vector<Member> members(const DL::SchemaGroupInfo& info) const
+	{
+		std::set<std::string> used(std::begin(RESERVED), std::end(RESERVED));
+		std::vector<Member> list;
+		for (const DL::SchemaEntryInfo& key : info.Keys) {
+			Member member;
+			member.Info = &key;
+			member.Name = make_unique(to_identifier(key.Name, false), used);
+
+			std::string upper = member.Name.substr(0, member.Name.find_last_not_of('_') + 1);
+			upper[0]		  = static_cast<char>(std::toupper(static_cast<unsigned char>(upper[0])));
+			member.Has		  = make_unique("has" + upper, used);
+			if (key.Type == DL::ST_Array)
+				member.Count = make_unique(member.Name + "Count", used);
+			list.push_back(member);
+		}
+		return list;
+	}
+
+	void declare(const DL::SchemaGroupInfo& info)
+	{
+		const std::string& name			  = mClasses[info.ID];
+		const std::vector<Member> members = this->members(info);
+
+		mOut << "\n/// View of the groups with id " << to_literal(info.ID) << "\n"
+			 << "class " << name << " {\n"
+			 << "public:\n"
+			 << "\t" << name << "();\n"
+			 << "\texplicit " << name << "(const DL::DataGroup& group);\n\n"
+			 << "\t/// Resolves the entries of all known keys in a single pass\n"
+			 << "\tvoid bind(const DL::DataGroup& group);\n"
+			 << "\t/// Returns true if bound to a group\n"
+			 << "\tbool isValid() const;\n"
+			 << "\t/// Returns the bound group or NULL\n"
+			 << "\tconst DL::DataGroup* group() const;\n"
+			 << "\t/// Returns a view of the first top group with the described id\n"
+			 << "\tstatic " << name << " find(const DL::DataContainer& container);\n"
+			 << "\tstatic const char* groupId();\n";
+
+		for (const Member& member : members) {
+			const DL::SchemaEntryInfo& key = *member.Info;
+			mOut << "\n\t/// Key " << to_literal(key.Name);
+			if (key.Multiple)
+				mOut << ", only the first entry is available";
+			mOut << "\n\tbool " << member.Has << "() const;\n";
+
+			if (key.Type == DL::ST_Array) {
+				const Accessor acc = accessor(key.Element, key.GroupID);
+				mOut << "\tsize_t " << member.Count << "() const;\n"
+					 << "\t" << acc.Type << " " << member.Name << "(" << parameters(acc, true, true) << ") const;\n";
+			} else {
+				const Accessor acc = accessor(key.Type, key.GroupID);
+				mOut << "\t" << acc.Type << " " << member.Name << "(" << parameters(acc, false, true) << ") const;\n";
+			}
+		}
+
+		if (info.HasAnonymous) {
+			const Accessor acc = accessor(info.Anonymous.Type, info.Anonymous.GroupID);
+			mOut << "\n\t/// Anonymous entries\n"
+				 << "\tsize_t anonymousCount() const;\n"
+				 << "\t" << acc.Type << " anonymous(" << parameters(acc, true, true) << ") const;\n";
+		}
+
+		mOut << "\nprivate:\n"
+			 << "\tenum : DL::uint32 { NO_SLOT = 0xFFFFFFFFu };\n\n"
+			 << "\tconst DL::Data* entry(size_t slot) const;\n"
+			 << "\tstatic const DL::Data* element(const DL::Data* array, size_t index);\n\n"
+			 << "\tconst DL::DataGroup* mGroup;\n"
+			 << "\tDL::uint32 mSlots[" << std::max<size_t>(1, members.size()) << "];\n"
+			 << "};\n";
+	}
+
+	void define(const DL::SchemaGroupInfo& info)
+	{
+		const std::string& name			  = mClasses[info.ID];
+		const std::string scope			  = name + "::";
+		const std::vector<Member> members = this->members(info);
+
+		mOut << "\n//---------------------------------------------------\n"
+			 << "inline " << scope << name << "()\n"
+			 << "\t: mGroup(nullptr)\n"
+			 << "{\n"
+			 << "\tfor (DL::uint32& slot : mSlots)\n"
+			 << "\t\tslot = NO_SLOT;\n"
+			 << "}\n\n"
+			 << "inline " << scope << name << "(const DL::DataGroup& group)\n"
+			 << "{\n"
+			 << "\tbind(group);\n"
+			 << "}\n\n";
+
+		// Keys are dispatched by their hash, colliding keys share a label
+		std::map<DL::uint64, std::vector<size_t>> labels;
+		for (size_t i = 0; i < members.size(); ++i)
+			labels[DL::bindingHash(members[i].Info->Name.data(), members[i].Info->Name.size())].push_back(i);
+
+		mOut << "inline void " << scope << "bind(const DL::DataGroup& group)\n"
+			 << "{\n"
+			 << "\tmGroup = &group;\n"
+			 << "\tfor (DL::uint32& slot : mSlots)\n"
+			 << "\t\tslot = NO_SLOT;\n";
+		if (!members.empty()) {
+			mOut << "\n\tconst DL::vector_t<DL::Data>& entries = group.getNamedEntries();\n"
+				 << "\tfor (size_t i = 0; i < entries.size(); ++i) {\n"
+				 << "\t\tconst DL::string_t key = entries[i].key();\n"
+				 << "\t\tswitch (DL::bindingHash(key.data(), key.size())) {\n";
+			for (const auto& label : labels) {
+				mOut << "\t\tcase DL::bindingHash(" << to_literal(members[label.second.front()].Info->Name) << "):\n";
+				for (size_t i : label.second) {
+					mOut << "\t\t\tif (mSlots[" << i << "] == NO_SLOT && key == " << to_literal(members[i].Info->Name) << ")\n"
+						 << "\t\t\t\tmSlots[" << i << "] = static_cast<DL::uint32>(i);\n";
+				}
+				mOut << "\t\t\tbreak;\n";
+			}
+			mOut << "\t\tdefault:\n"
+				 << "\t\t\tbreak;\n"
+				 << "\t\t}\n"
+				 << "\t}\n";
+		}
+		mOut << "}\n\n";
+
+		mOut << "inline bool " << scope << "isValid() const\n"
+			 << "{\n"
+			 << "\treturn mGroup != nullptr;\n"
+			 << "}\n\n"
+			 << "inline const DL::DataGroup* " << scope << "group() const\n"
+			 << "{\n"
+			 << "\treturn mGroup;\n"
+			 << "}\n\n"
+			 << "inline " << name << " " << scope << "find(const DL::DataContainer& container)\n"
+			 << "{\n"
+			 << "\tconst DL::DataGroup* group = container.findTopGroup(groupId());\n"
+			 << "\treturn group ? " << name << "(*group) : " << name << "();\n"
+			 << "}\n\n"
+			 << "inline const char* " << scope << "groupId()\n"
+			 << "{\n"
+			 << "\treturn " << to_literal(info.ID) << ";\n"
+			 << "}\n\n"
+			 << "inline const DL::Data* " << scope << "entry(size_t slot) const\n"
+			 << "{\n"
+			 << "\treturn mSlots[slot] != NO_SLOT ? &mGroup->getNamedEntries()[mSlots[slot]] : nullptr;\n"
+			 << "}\n\n"
+			 << "inline const DL::Data* " << scope << "element(const DL::Data* array, size_t index)\n"
+			 << "{\n"
+			 << "\tif (!array || array->type() != DL::DT_Group || index >= array->getGroup().getAnonymousEntries().size())\n"
+			 << "\t\treturn nullptr;\n"
+			 << "\treturn &array->getGroup().getAnonymousEntries()[index];\n"
+			 << "}\n";
+
+		for (size_t i = 0; i < members.size(); ++i) {
+			const Member& member		   = members[i];
+			const DL::SchemaEntryInfo& key = *member.Info;
+
+			mOut << "\ninline bool " << scope << member.Has << "() const\n"
+				 << "{\n"
+				 << "\treturn mSlots[" << i << "] != NO_SLOT;\n"
+				 << "}\n";
+
+			if (key.Type == DL::ST_Array) {
+				const Accessor acc = accessor(key.Element, key.GroupID);
+				mOut << "\ninline size_t " << scope << member.Count << "() const\n"
+					 << "{\n"
+					 << "\tconst DL::Data* d = entry(" << i << ");\n"
+					 << "\treturn d && d->type() == DL::DT_Group ? d->getGroup().getAnonymousEntries().size() : 0;\n"
+					 << "}\n\n"
+					 << "inline " << acc.Type << " " << scope << member.Name << "(" << parameters(acc, true, false) << ") const\n"
+					 << "{\n"
+					 << "\tconst DL::Data* d = element(entry(" << i << "), index);\n"
+					 << "\t" << acc.Body << "\n"
+					 << "}\n";
+			} else {
+				const Accessor acc = accessor(key.Type, key.GroupID);
+				mOut << "\ninline " << acc.Type << " " << scope << member.Name << "(" << parameters(acc, false, false) << ") const\n"
+					 << "{\n"
+					 << "\tconst DL::Data* d = entry(" << i << ");\n"
+					 << "\t" << acc.Body << "\n"
+					 << "}\n";
+			}
+		}
+
+		if (info.HasAnonymous) {
+			const Accessor acc = accessor(info.Anonymous.Type, info.Anonymous.GroupID);
+			mOut << "\ninline size_t " << scope << "anonymousCount() const\n"
+				 << "{\n"
+				 << "\treturn mGroup ? mGroup->getAnonymousEntries().size() : 0;\n"
+				 << "}\n\n"
+				 << "inline " << acc.Type << " " << scope << "anonymous(" << parameters(acc, true, false) << ") const\n"
+				 << "{\n"
+				 << "\tconst DL::Data* d = mGroup && index < mGroup->getAnonymousEntries().size() ? &mGroup->getAnonymousEntries()[index] : nullptr;\n"
+				 << "\t" << acc.Body << "\n"
+				 << "}\n";
+		}
+	}
+
+	const DL::vector_t<DL::SchemaGroupInfo>& mGroups;
+	const std::string mSource;
+	std::map<std::string, std::string> mClasses;
+	std::ostringstream mOut;
+};
+
+int main(int argc, char** argv)
+{
+	std::string ns;
+	std::string prefix;
+	std::vector<const char*> files;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--namespace") == 0 && i + 1 < argc)
+			ns = argv[++i];
+		else if (std::strcmp(argv[i], "--include-prefix") == 0 && i + 1 < argc)
+			prefix = argv[++i];
+		else
+			files.push_back(argv[i]);
+	}
+
+	if (files.size() != 2) {
+		std::cout << "Use 'dl_codegen [--namespace NAMESPACE] [--include-prefix PREFIX] [SCHEMA] [OUTPUT]'" << std::endl;
+		return -1;
+	}
+
+	std::string content;
+	try {
+		content = get_file_contents(files[0]);
+	} catch (...) {
+		std::cout << "Couldn't read file '" << files[0] << "'" << std::endl;
+		return -2;
+	}
+
+	DL::SourceLogger logger;
+	DL::Schema schema;
+	if (!schema.compile(content, &logger)) {
+		std::cout << "Compilation of schema '" << files[0] << "' failed" << std::endl;
+		return -3;
+	}
+
+	std::string source = files[0];
+	const size_t pos   = source.find_last_of("/\\");
+	if (pos != std::string::npos)
+		source = source.substr(pos + 1);
+
+	const DL::vector_t<DL::SchemaGroupInfo> groups = schema.groups();
+	const std::string code						  = Generator(groups, source).run(ns, prefix);
+
+	// Keep the file untouched if nothing changed, to prevent needless rebuilds.
+	// DL_GENERATE_VIEWS records the run in a separate stamp file
+	try {
+		if (get_file_contents(files[1]) == code)
+			return 0;
+	} catch (...) {
+	}
+
+	std::ofstream out(files[1], std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!out || !(out << code)) {
+		std::cout << "Couldn't write file '" << files[1] << "'" << std::endl;
+		return -4;
+	}
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Binary.h"
+#include "DataContainer.h"
+#include "DataLisp.h"
+#include "SourceLogger.h"
+
+std::string get_file_contents(const char* filename)
+{
+	std::ifstream in(filename, std::ios::in | std::ios::binary);
+	if (in) {
+		std::string contents;
+		in.seekg(0, std::ios::end);
+		contents.resize(in.tellg());
+		in.seekg(0, std::ios::beg);
+		in.read(&contents[0], contents.size());
+		in.close();
+		return (contents);
+	}
+	throw(errno);
+}
+
+int decompile(const char* input)
+{
+	DL::BinaryContainer binary;
+	if (!binary.open(input) || !binary.verify()) {
+		std::cout << "Couldn't load binary file '" << input << "'" << std::endl;
+		return -2;
+	}
+
+	DL::DataContainer container;
+	binary.toContainer(container);
+	std::cout << DL::DataLisp::generate(container) << std::endl;
+
+	return 0;
+}
+
+int compile(const char* input, const char* output)
+{
+	std::string content;
+	try {
+		content = get_file_contents(input);
+	} catch (...) {
+		std::cout << "Couldn't read file '" << input << "'" << std::endl;
+		return -2;
+	}
+
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+
+	lisp.parse(content);
+	if (logger.errorCount() == 0)
+		lisp.build(container);
+
+	if (logger.errorCount() != 0) {
+		std::cout << "Compilation of '" << input << "' failed" << std::endl;
+		return -3;
+	}
+
+	if (!DL::BinaryContainer::write(container, std::string(output))) {
+		std::cout << "Couldn't write file '" << output << "'" << std::endl;
+		return -4;
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 3 && std::strcmp(argv[1], "--decompile") == 0)
+		return decompile(argv[2]);
+	else if (argc == 3)
+		return compile(argv[1], argv[2]);
+
+	std::cout << "Use 'dl_compile [INPUT] [OUTPUT]' or 'dl_compile --decompile [INPUT]'" << std::endl;
+	return -1;
+}
@@ -0,0 +1,136 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Binary.h"
+#include "DataContainer.h"
+#include "DataLisp.h"
+#include "Json.h"
+#include "SourceLogger.h"
+
+enum Format {
+	F_Source,
+	F_Json,
+	F_Binary
+};
+
+Format get_format(const std::string& path)
+{
+	const size_t pos		= path.find_last_of('.');
+	const std::string ext = pos == std::string::npos ? std::string() : path.substr(pos + 1);
+	if (ext == "json")
+		return F_Json;
+	else if (ext == "dlb")
+		return F_Binary;
+	else
+		return F_Source;
+}
+
+bool read_input(const std::string& path, DL::DataContainer& container, DL::SourceLogger& logger)
+{
+	switch (get_format(path)) {
+	case F_Binary: {
+		DL::BinaryContainer binary;
+		if (!binary.open(path) || !binary.verify())
+			return false;
+		binary.toContainer(container);
+		return true;
+	}
+	case F_Json: {
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		return in && DL::Json::read(in, container, &logger);
+	}
+	default: {
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		if (!in)
+			return false;
+
+		DL::DataLisp lisp(&logger);
+		lisp.parse(&in);
+		if (logger.errorCount() == 0)
+			lisp.build(container);
+		return logger.errorCount() == 0;
+	}
+	}
+}
+
+bool write_output(const std::string& path, const DL::DataContainer& container, int mode)
+{
+	const Format format = get_format(path);
+	if (format == F_Binary)
+		return DL::BinaryContainer::write(container, path);
+
+	std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!out)
+		return false;
+
+	if (format == F_Json)
+		DL::Json::write(container, out, mode < 0 ? DL::GM_Compact : (DL::GenerateMode)mode);
+	else
+		DL::DataLisp::generate(container, out, mode < 0 ? DL::GM_Pretty : (DL::GenerateMode)mode);
+
+	out.close();
+	return !out.fail();
+}
+
+int main(int argc, char** argv)
+{
+	int mode = -1; // Default of the output format
+	int arg	 = 1;
+	if (argc == 4 && std::strcmp(argv[1], "--pretty") == 0) {
+		mode = DL::GM_Pretty;
+		++arg;
+	} else if (argc == 4 && std::strcmp(argv[1], "--compact") == 0) {
+		mode = DL::GM_Compact;
+		++arg;
+	}
+
+	if (argc - arg != 2) {
+		std::cout << "Use 'dl_convert [--pretty|--compact] [INPUT] [OUTPUT]'" << std::endl;
+		std::cout << "The format is given by the extension: .dl (default), .json or .dlb" << std::endl;
+		return -1;
+	}
+
+	DL::SourceLogger logger;
+	DL::DataContainer container;
+	if (!read_input(argv[arg], container, logger)) {
+		std::cout << "Couldn't read file '" << argv[arg] << "'" << std::endl;
+		return -2;
+	}
+
+	if (!write_output(argv[arg + 1], container, mode)) {
+		std::cout << "Couldn't write file '" << argv[arg + 1] << "'" << std::endl;
+		return -3;
+	}
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include <fstream>
+#include <iostream>
+
+#include "Binary.h"
+#include "DataContainer.h"
+#include "DataLisp.h"
+#include "Diff.h"
+#include "Json.h"
+#include "SourceLogger.h"
+
+bool read_input(const std::string& path, DL::DataContainer& container, DL::SourceLogger& logger)
+{
+	const size_t pos		= path.find_last_of('.');
+	const std::string ext = pos == std::string::npos ? std::string() : path.substr(pos + 1);
+
+	if (ext == "dlb") {
+		DL::BinaryContainer binary;
+		if (!binary.open(path) || !binary.verify())
+			return false;
+		binary.toContainer(container);
+		return true;
+	}
+
+	std::ifstream in(path, std::ios::in | std::ios::binary);
+	if (!in)
+		return false;
+
+	if (ext == "json")
+		return DL::Json::read(in, container, &logger);
+
+	DL::DataLisp lisp(&logger);
+	lisp.parse(&in);
+	if (logger.errorCount() == 0)
+		lisp.build(container);
+	return logger.errorCount() == 0;
+}
+
+std::string format(const DL::Data& d)
+{
+	if (d.type() != DL::DT_Group) {
+		DL::Data value = d;
+		value.setKey("");
+		DL::DataGroup grp;
+		grp.add(value);
+		DL::DataContainer container;
+		container.addTopGroup(grp);
+
+		// Strip the surrounding array
+		const std::string str = DL::DataLisp::generate(container, DL::GM_Compact);
+		return str.substr(1, str.size() - 3);
+	}
+
+	DL::DataContainer container;
+	container.addTopGroup(d.getGroup());
+	const std::string str = DL::DataLisp::generate(container, DL::GM_Compact);
+	return str.substr(0, str.size() - 1);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3) {
+		std::cout << "Use 'dl_diff [OLD] [NEW]'" << std::endl;
+		std::cout << "The format is given by the extension: .dl (default), .json or .dlb" << std::endl;
+		return -1;
+	}
+
+	DL::SourceLogger logger;
+	DL::DataContainer containers[2];
+	for (int i = 0; i < 2; ++i) {
+		if (!read_input(argv[i + 1], containers[i], logger)) {
+			std::cout << "Couldn't read file '" << argv[i + 1] << "'" << std::endl;
+			return -2;
+		}
+		containers[i].freeze();
+	}
+
+	const DL::vector_t<DL::DiffEntry> entries = DL::Diff::compare(containers[0], containers[1]);
+	for (const DL::DiffEntry& e : entries) {
+		switch (e.Type) {
+		case DL::DFT_Added:
+			std::cout << "+ " << e.Path << " " << format(e.New) << std::endl;
+			break;
+		case DL::DFT_Removed:
+			std::cout << "- " << e.Path << " " << format(e.Old) << std::endl;
+			break;
+		case DL::DFT_Changed:
+			std::cout << "~ " << e.Path << " " << format(e.Old) << " -> " << format(e.New) << std::endl;
+			break;
+		}
+	}
+
+	return entries.empty() ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "DataLisp.h"
+
+static bool build(const std::string& source, DL::DataContainer& container)
+{
+	DL::DiagnosticBuffer logger;
+	DL::DataLisp lisp(&logger);
+	lisp.parse(source);
+	lisp.build(container);
+	return logger.errorCount() == 0;
+}
+
+// Generated sources have to parse without errors and generate the same source again
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	DL::DataContainer container;
+	if (!build(std::string(reinterpret_cast<const char*>(data), size), container))
+		return 0;
+
+	for (DL::GenerateMode mode : { DL::GM_Pretty, DL::GM_Compact }) {
+		const std::string generated = DL::DataLisp::generate(container, mode);
+
+		DL::DataContainer reparsed;
+		if (!build(generated, reparsed) || DL::DataLisp::generate(reparsed, mode) != generated) {
+			std::cout << "Generated source does not roundtrip:" << std::endl
+					  << generated << std::endl;
+			std::abort();
+		}
+	}
+
+	return 0;
+}
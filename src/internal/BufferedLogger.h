@@ -0,0 +1,90 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Diagnostic.h"
+
+namespace DL {
+/* Collects all messages to replay them later on another logger.
+ * Used by tasks running concurrently, so the messages end up in a deterministic order.
+ * Diagnostics are kept as they are, only plain messages are prefixed when replayed.
+ */
+class DL_INTERNAL_LIB BufferedLogger : public SourceLogger {
+public:
+	void log(line_t line, column_t column, Level level, const string_t& str) override
+	{
+		count(level);
+		mEntries.push_back(Entry{ message(line, column, level, str), false, true });
+	}
+
+	void log(Level level, const string_t& str) override
+	{
+		count(level);
+		mEntries.push_back(Entry{ message(0, 0, level, str), false, false });
+	}
+
+	void report(const Diagnostic& diagnostic) override
+	{
+		count(diagnostic.Severity);
+		mEntries.push_back(Entry{ diagnostic, true, diagnostic.hasPosition() });
+	}
+
+	// Every plain message is prefixed with the given string
+	void replay(SourceLogger* target, const string_t& prefix) const
+	{
+		for (const Entry& e : mEntries) {
+			const Diagnostic& d = e.Message;
+			if (e.Structured)
+				target->report(d);
+			else if (e.HasPosition)
+				target->log(d.Line, d.Column, d.Severity, prefix + d.Text);
+			else
+				target->log(d.Severity, prefix + d.Text);
+		}
+	}
+
+private:
+	static Diagnostic message(line_t line, column_t column, Level level, const string_t& str)
+	{
+		Diagnostic d(DC_Message, level);
+		d.Line	 = line;
+		d.Column = column;
+		d.Text	 = str;
+		return d;
+	}
+
+	struct Entry {
+		Diagnostic Message;
+		bool Structured; // Given by report() instead of log()
+		bool HasPosition;
+	};
+	vector_t<Entry> mEntries;
+};
+} // namespace DL
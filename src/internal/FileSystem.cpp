@@ -0,0 +1,131 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "FileSystem.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sys/stat.h>
+
+#if defined(DL_OS_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+namespace DL {
+string_t canonicalPath(const string_t& path)
+{
+#if defined(DL_OS_WINDOWS)
+	char buffer[MAX_PATH];
+	if (!_fullpath(buffer, path.c_str(), MAX_PATH))
+		return string_t();
+
+	struct _stat st;
+	if (_stat(buffer, &st) != 0)
+		return string_t();
+
+	return string_t(buffer);
+#else
+	char* resolved = realpath(path.c_str(), nullptr);
+	if (!resolved)
+		return string_t();
+
+	string_t result(resolved);
+	std::free(resolved);
+	return result;
+#endif
+}
+
+bool modificationTime(const string_t& path, int64& time)
+{
+#if defined(DL_OS_WINDOWS)
+	struct _stat64 st;
+	if (_stat64(path.c_str(), &st) != 0)
+		return false;
+	time = static_cast<int64>(st.st_mtime) * 1000000000LL;
+#elif defined(DL_OS_LINUX)
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+		return false;
+	time = static_cast<int64>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#else
+	struct stat st;
+	if (stat(path.c_str(), &st) != 0)
+		return false;
+	time = static_cast<int64>(st.st_mtime) * 1000000000LL;
+#endif
+	return true;
+}
+
+bool readFile(const string_t& path, string_t& content)
+{
+	std::ifstream in(path, std::ios::in | std::ios::binary);
+	if (!in)
+		return false;
+
+	in.seekg(0, std::ios::end);
+	const std::streamoff size = in.tellg();
+	if (size < 0)
+		return false;
+
+	content.resize(static_cast<size_t>(size));
+	in.seekg(0, std::ios::beg);
+	in.read(&content[0], size);
+	return !in.fail();
+}
+
+static inline bool isSeparator(char c)
+{
+#if defined(DL_OS_WINDOWS)
+	return c == '/' || c == '\\';
+#else
+	return c == '/';
+#endif
+}
+
+string_t directoryOf(const string_t& path)
+{
+	for (size_t i = path.size(); i > 0; --i) {
+		if (isSeparator(path[i - 1]))
+			return path.substr(0, i);
+	}
+	return string_t();
+}
+
+string_t resolvePath(const string_t& directory, const string_t& path)
+{
+	if (path.empty() || isSeparator(path[0]))
+		return path;
+#if defined(DL_OS_WINDOWS)
+	if (path.size() > 1 && path[1] == ':')
+		return path;
+#endif
+	return directory + path;
+}
+} // namespace DL
@@ -0,0 +1,51 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLispConfig.h"
+
+namespace DL {
+/* Minimal platform dependent file system helpers */
+
+// Absolute path with all links and relative components resolved. Empty if the file does not exist
+DL_INTERNAL_LIB string_t canonicalPath(const string_t& path);
+
+// Modification time in nanoseconds. Returns false if the file does not exist
+DL_INTERNAL_LIB bool modificationTime(const string_t& path, int64& time);
+
+// Reads a whole file. Returns false if the file could not be read
+DL_INTERNAL_LIB bool readFile(const string_t& path, string_t& content);
+
+// Directory part of a path including the trailing separator. Empty if the path has no directory
+DL_INTERNAL_LIB string_t directoryOf(const string_t& path);
+
+// Resolves a path relative to the given directory. Absolute paths are returned unchanged
+DL_INTERNAL_LIB string_t resolvePath(const string_t& directory, const string_t& path);
+} // namespace DL
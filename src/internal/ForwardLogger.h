@@ -0,0 +1,91 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "Diagnostic.h"
+
+namespace DL {
+/* Forwards all messages to another logger while counting them on its own.
+ * Used to track the errors of a single operation independent of the global counters.
+ * Positions can be shifted when only a fragment of a source is parsed.
+ */
+class DL_INTERNAL_LIB ForwardLogger : public SourceLogger {
+public:
+	explicit ForwardLogger(SourceLogger* target)
+		: mTarget(target)
+		, mLineOffset(0)
+		, mColumnOffset(0)
+		, mByteOffset(0)
+	{
+		DL_ASSERT(target);
+		setMinimumLevel(target->minimumLevel());
+	}
+
+	// Positions of the first line are shifted by the column offset, all others only by the line offset
+	void setOffset(line_t line, column_t column, uint32 byteOffset = 0)
+	{
+		mLineOffset	  = line;
+		mColumnOffset = column;
+		mByteOffset	  = byteOffset;
+	}
+
+	void log(line_t line, column_t column, Level level, const string_t& str) override
+	{
+		count(level);
+		mTarget->log(line + mLineOffset, line <= 1 ? column + mColumnOffset : column, level, str);
+	}
+
+	void log(Level level, const string_t& str) override
+	{
+		count(level);
+		mTarget->log(level, str);
+	}
+
+	void report(const Diagnostic& diagnostic) override
+	{
+		count(diagnostic.Severity);
+
+		Diagnostic shifted = diagnostic;
+		shifted.Begin += mByteOffset;
+		shifted.End += mByteOffset;
+		if (shifted.hasPosition()) {
+			shifted.Column = shifted.Line <= 1 ? shifted.Column + mColumnOffset : shifted.Column;
+			shifted.Line += mLineOffset;
+		}
+		mTarget->report(shifted);
+	}
+
+private:
+	SourceLogger* mTarget;
+	line_t mLineOffset;
+	column_t mColumnOffset;
+	uint32 mByteOffset;
+};
+} // namespace DL
@@ -0,0 +1,204 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "Generator.h"
+#include "NumberFormat.h"
+
+namespace DL {
+constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+Generator::Generator(string_t& buffer, std::ostream* stream, GenerateMode mode)
+	: mBuffer(buffer)
+	, mStream(stream)
+	, mMode(mode)
+	, mFlushed(0)
+{
+	if (mStream)
+		mBuffer.reserve(FLUSH_THRESHOLD + FLUSH_THRESHOLD / 4);
+}
+
+void Generator::write(const DataContainer& container)
+{
+	for (const DataGroup& grp : container.getTopGroups()) {
+		writeGroup(grp, 0);
+		mBuffer += '\n';
+		checkFlush();
+	}
+}
+
+void Generator::flush()
+{
+	if (mStream && !mBuffer.empty()) {
+		mStream->write(mBuffer.data(), mBuffer.size());
+		mFlushed += mBuffer.size();
+		mBuffer.clear();
+	}
+}
+
+void Generator::checkFlush()
+{
+	if (mStream && mBuffer.size() >= FLUSH_THRESHOLD)
+		flush();
+}
+
+void Generator::indent(int depth)
+{
+	mBuffer.append(static_cast<size_t>(depth), ' ');
+}
+
+// Nested groups are written with an explicit stack instead of recursion
+void Generator::writeGroup(const DataGroup& grp, int depth)
+{
+	mStack.clear();
+	openGroup(grp, depth);
+
+	while (!mStack.empty()) {
+		Frame& frame					= mStack.back();
+		const vector_t<Data>& anonymous = frame.Group->getAnonymousEntries();
+		const vector_t<Data>& named		= frame.Group->getNamedEntries();
+		const size_t index				= frame.Next;
+
+		if (index == anonymous.size() + named.size()) {
+			closeGroup(*frame.Group, frame.Depth);
+			mStack.pop_back();
+			if (!mStack.empty() && mMode == GM_Pretty)
+				mBuffer += '\n';
+			continue;
+		}
+
+		++frame.Next;
+		const Data& d		 = index < anonymous.size() ? anonymous[index] : named[index - anonymous.size()];
+		const int entryDepth = frame.Depth + 1;
+
+		if (mMode == GM_Pretty)
+			indent(entryDepth);
+		else if (index != 0 || !frame.Group->isArray())
+			mBuffer += ' ';
+
+		if (!d.key().empty()) {
+			mBuffer += ':';
+			mBuffer += d.key();
+			mBuffer += mMode == GM_Pretty ? "  " : " ";
+		}
+
+		// The frame is invalidated by pushing a new one
+		if (d.type() == DT_Group) {
+			openGroup(d.getGroup(), entryDepth + 1);
+		} else {
+			writeValue(d);
+			if (mMode == GM_Pretty)
+				mBuffer += '\n';
+		}
+	}
+}
+
+void Generator::openGroup(const DataGroup& grp, int depth)
+{
+	if (mMode == GM_Pretty)
+		indent(depth);
+
+	if (grp.isArray()) {
+		mBuffer += '[';
+	} else {
+		mBuffer += '(';
+		mBuffer += grp.id();
+	}
+
+	if (mMode == GM_Pretty)
+		mBuffer += '\n';
+
+	mStack.push_back(Frame{ &grp, 0, depth });
+}
+
+void Generator::closeGroup(const DataGroup& grp, int depth)
+{
+	if (mMode == GM_Pretty)
+		indent(depth);
+
+	mBuffer += grp.isArray() ? ']' : ')';
+	checkFlush();
+}
+
+void Generator::writeValue(const Data& d)
+{
+	switch (d.type()) {
+	case DT_Bool:
+		mBuffer += d.getBool() ? "true" : "false";
+		break;
+	case DT_Float:
+		appendFloat(mBuffer, d.getFloat());
+		break;
+	case DT_Integer:
+		appendInteger(mBuffer, d.getInt());
+		break;
+	case DT_String:
+		writeString(d.getString());
+		break;
+	case DT_Group:
+	case DT_None:
+		break;
+	}
+}
+
+void Generator::writeString(const string_t& str)
+{
+	static const char* HEX = "0123456789abcdef";
+
+	mBuffer += '"';
+	for (char c : str) {
+		switch (c) {
+		case '"':
+			mBuffer += "\\\"";
+			break;
+		case '\\':
+			mBuffer += "\\\\";
+			break;
+		case '\n':
+			mBuffer += "\\n";
+			break;
+		case '\t':
+			mBuffer += "\\t";
+			break;
+		case '\r':
+			mBuffer += "\\r";
+			break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				mBuffer += "\\x";
+				mBuffer += HEX[(c >> 4) & 0xF];
+				mBuffer += HEX[c & 0xF];
+			} else {
+				mBuffer += c;
+			}
+			break;
+		}
+	}
+	mBuffer += '"';
+}
+} // namespace DL
@@ -0,0 +1,71 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLisp.h"
+
+#include <ostream>
+
+namespace DL {
+/* Writes source code of containers directly into a buffer.
+ * If a stream is given, the buffer is flushed into it in chunks.
+ */
+class DL_INTERNAL_LIB Generator {
+public:
+	Generator(string_t& buffer, std::ostream* stream, GenerateMode mode);
+
+	void write(const DataContainer& container);
+	void flush();
+
+	// Bytes written so far, including the buffered ones
+	inline uint64 writtenBytes() const { return mFlushed + mBuffer.size(); }
+
+private:
+	struct Frame {
+		const DataGroup* Group;
+		size_t Next; // Anonymous entries first, then the named ones
+		int Depth;
+	};
+
+	void writeGroup(const DataGroup& grp, int depth);
+	void openGroup(const DataGroup& grp, int depth);
+	void closeGroup(const DataGroup& grp, int depth);
+	void writeValue(const Data& d);
+	void writeString(const string_t& str);
+	void indent(int depth);
+	void checkFlush();
+
+	string_t& mBuffer;
+	std::ostream* mStream;
+	GenerateMode mMode;
+	uint64 mFlushed;
+	vector_t<Frame> mStack;
+};
+} // namespace DL
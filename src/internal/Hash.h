@@ -0,0 +1,67 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLispConfig.h"
+
+namespace DL {
+/* FNV-1a over a block of bytes.
+ * Not cryptographic, only used for tables, caches and change detection.
+ */
+inline uint64 hashBytes(const char* data, size_t size, uint64 h = 14695981039346656037ULL)
+{
+	for (size_t i = 0; i < size; ++i) {
+		h ^= static_cast<uint8>(data[i]);
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+inline uint64 hashString(const string_t& str, uint64 h = 14695981039346656037ULL)
+{
+	return hashBytes(str.data(), str.size(), h);
+}
+
+// Finalizer of splitmix64, spreads the bits of already hashed values
+inline uint64 hashMix(uint64 h)
+{
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+	return h;
+}
+
+inline uint64 hashCombine(uint64 seed, uint64 h)
+{
+	return hashMix(seed ^ (h + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2)));
+}
+} // namespace DL
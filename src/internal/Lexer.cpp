@@ -28,7 +28,10 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
  */
 #include "Lexer.h"
-#include <sstream>
+#include "Statistics.h"
+
+#include <chrono>
+#include <limits>
 
 namespace DL {
 Lexer::Lexer(stream_t* provider, SourceLogger* logger)
@@ -39,6 +42,12 @@ Lexer::Lexer(stream_t* provider, SourceLogger* logger)
 	, mNextToken{ T_EOF, "" }
 	, mNextLineNumber(0)
 	, mNextColumnNumber(0)
+	, mOffset(0)
+	, mNextOffset(0)
+	, mFileId(0)
+	, mErrorCount(0)
+	, mMaxErrors(std::numeric_limits<uint32>::max())
+	, mStatistics(nullptr)
 {
 	mCurrentChar = mProvider->get();
 }
@@ -49,349 +58,350 @@ Lexer::~Lexer()
 
 Token Lexer::getNextToken()
 {
-	if (!mProvider->good()) {
-		Token token;
-		token.Type = T_EOF;
-		return token;
-	} else if (mCurrentChar == '$') {
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
+	// Skipped characters continue the loop, therefor the stack usage does not depend on the input
+	for (;;) {
+		if (!mProvider->good()) {
+			Token token;
+			token.Type = T_EOF;
+			return token;
+		} else if (mCurrentChar == '$') {
+			mCurrentChar = readChar();
+			++mColumnNumber;
+
+			if (mProvider->good() && mCurrentChar == '(') {
+				mCurrentChar = readChar();
+				++mColumnNumber;
 
-		if (mProvider->good() && mCurrentChar == '(') {
-			mCurrentChar = mProvider->get();
+				Token token;
+				token.Type = T_ExpressionParanthese;
+				return token;
+			} else if (!mProvider->good()) {
+				report(DC_MissingExpressionParanthese, mOffset);
+
+				Token token;
+				token.Type = T_EOF;
+				return token;
+			} else {
+				report(DC_InvalidCharacter, mOffset, mCurrentChar);
+				mCurrentChar = readChar();
+				++mColumnNumber;
+				continue;
+			}
+		} else if (mCurrentChar == '(') {
+			mCurrentChar = readChar();
 			++mColumnNumber;
 
 			Token token;
-			token.Type = T_ExpressionParanthese;
+			token.Type = T_OpenParanthese;
 			return token;
-		} else if (!mProvider->good()) {
-			std::stringstream stream;
-			stream << "No '(' after '$'";
-			mLogger->log(mLineNumber, mColumnNumber, L_Error, stream.str());
+		} else if (mCurrentChar == ')') {
+			mCurrentChar = readChar();
+			++mColumnNumber;
 
 			Token token;
-			token.Type = T_EOF;
+			token.Type = T_CloseParanthese;
 			return token;
-		} else {
-			std::stringstream stream;
-			stream << "Invalid character '" << mCurrentChar << "' after '$'";
-			mLogger->log(mLineNumber, mColumnNumber, L_Error, stream.str());
-			mCurrentChar = mProvider->get();
+		} else if (mCurrentChar == '[') {
+			mCurrentChar = readChar();
 			++mColumnNumber;
-			return getNextToken();
-		}
-	} else if (mCurrentChar == '(') {
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
-
-		Token token;
-		token.Type = T_OpenParanthese;
-		return token;
-	} else if (mCurrentChar == ')') {
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
-
-		Token token;
-		token.Type = T_CloseParanthese;
-		return token;
-	} else if (mCurrentChar == '[') {
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
-
-		Token token;
-		token.Type = T_OpenSquareBracket;
-		return token;
-	} else if (mCurrentChar == ']') {
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
 
-		Token token;
-		token.Type = T_CloseSquareBracket;
-		return token;
-	} else if (mCurrentChar == ',') {
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
+			Token token;
+			token.Type = T_OpenSquareBracket;
+			return token;
+		} else if (mCurrentChar == ']') {
+			mCurrentChar = readChar();
+			++mColumnNumber;
 
-		Token token;
-		token.Type = T_Comma;
-		return token;
-	} else if (mCurrentChar == ':') {
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
+			Token token;
+			token.Type = T_CloseSquareBracket;
+			return token;
+		} else if (mCurrentChar == ',') {
+			mCurrentChar = readChar();
+			++mColumnNumber;
 
-		Token token;
-		token.Type = T_Colon;
-		return token;
-	} else if (mCurrentChar == ';') //Comment
-	{
-		while (mProvider->good() && mCurrentChar != '\n') {
-			mCurrentChar = mProvider->get();
+			Token token;
+			token.Type = T_Comma;
+			return token;
+		} else if (mCurrentChar == ':') {
+			mCurrentChar = readChar();
 			++mColumnNumber;
-		}
 
-		return getNextToken();
-	} else if (mCurrentChar == '"' || mCurrentChar == '\'') //String
-	{
-		char start = mCurrentChar;
+			Token token;
+			token.Type = T_Colon;
+			return token;
+		} else if (mCurrentChar == ';') //Comment
+		{
+			while (mProvider->good() && mCurrentChar != '\n') {
+				mCurrentChar = readChar();
+				++mColumnNumber;
+			}
 
-		string_t str;
-		while (true) {
-			mCurrentChar = mProvider->get();
-			++mColumnNumber;
+			continue;
+		} else if (mCurrentChar == '"' || mCurrentChar == '\'') //String
+		{
+			char start			= mCurrentChar;
+			const uint32 begin = mOffset;
 
-			if (!mProvider->good() || mCurrentChar == '\n') {
-				std::stringstream stream;
-				stream << "The string \"" << str << "\" is not closed";
-				mLogger->log(mLineNumber, mColumnNumber, L_Error, stream.str());
-				break;
-			} else if (mCurrentChar == '\\') {
-				mCurrentChar = mProvider->get();
+			string_t str;
+			while (true) {
+				mCurrentChar = readChar();
 				++mColumnNumber;
 
-				if (!mProvider->good()) {
-					mLogger->log(mLineNumber, mColumnNumber, L_Error, "Invalid use of the '\\' operator");
-				} else if (mCurrentChar == '\n') {
-					++mLineNumber;
-					mCurrentChar = mProvider->get();
-					mColumnNumber = 1;
-				} else {
-					switch (mCurrentChar) {
-					case 'n': // New line
-						str += '\n';
-						break;
-					case 't': // Tab
-						str += '\t';
-						break;
-					case 'r': // Carriage return
-						str += '\r';
-						break;
-					case 'a': // Audible bell
-						str += '\a';
-						break;
-					case 'b': // Backspace
-						str += '\b';
-						break;
-					case 'f': // Form feed
-						str += '\f';
-						break;
-					case 'v': // Vertical tab
-						str += '\v';
-						break;
-					case 'x': //Binary [2]
-					case 'u': //Unicode [4]
-					case 'U': //Unicode [8]
-					{
-						size_t length = mCurrentChar == 'x' ? 2 : (mCurrentChar == 'u' ? 4 : 8);
-						string_t uni_val;
-						for (size_t i = 0; i < length; ++i) {
-							mCurrentChar = mProvider->get();
-							++mColumnNumber;
-							if (!mProvider->good() || mCurrentChar == '\n') {
-								mLogger->log(mLineNumber, mColumnNumber, L_Error, "Invalid use of Unicode escape sequence.");
-								break;
-							}
+				if (!mProvider->good() || mCurrentChar == '\n') {
+					report(DC_UnclosedString, begin, 0, str);
+					break;
+				} else if (mCurrentChar == '\\') {
+					mCurrentChar = readChar();
+					++mColumnNumber;
 
-							uni_val += mCurrentChar;
-						}
+					if (!mProvider->good()) {
+						report(DC_InvalidEscapeOperator, mOffset);
+					} else if (mCurrentChar == '\n') {
+						++mLineNumber;
+						mCurrentChar = readChar();
+						mColumnNumber = 1;
+					} else {
+						switch (mCurrentChar) {
+						case 'n': // New line
+							str += '\n';
+							break;
+						case 't': // Tab
+							str += '\t';
+							break;
+						case 'r': // Carriage return
+							str += '\r';
+							break;
+						case 'a': // Audible bell
+							str += '\a';
+							break;
+						case 'b': // Backspace
+							str += '\b';
+							break;
+						case 'f': // Form feed
+							str += '\f';
+							break;
+						case 'v': // Vertical tab
+							str += '\v';
+							break;
+						case 'x': //Binary [2]
+						case 'u': //Unicode [4]
+						case 'U': //Unicode [8]
+						{
+							size_t length = mCurrentChar == 'x' ? 2 : (mCurrentChar == 'u' ? 4 : 8);
+							string_t uni_val;
+							for (size_t i = 0; i < length; ++i) {
+								mCurrentChar = readChar();
+								++mColumnNumber;
+								if (!mProvider->good() || mCurrentChar == '\n') {
+									report(DC_InvalidUnicodeEscape, mOffset);
+									break;
+								}
 
-						if (uni_val.length() == length) {
-							size_t r = 0;
-							unsigned long uni;
-							try {
-								uni = std::stoul(uni_val, &r, 16);
-							} catch (const std::exception&) {
-								mLogger->log(mLineNumber, mColumnNumber, L_Error, "Given escape sequence is invalid.");
-								break;
+								uni_val += mCurrentChar;
 							}
 
-							if (r != length) {
-								mLogger->log(mLineNumber, mColumnNumber, L_Error, "Given Unicode sequence is invalid.");
-							} else if (length != 2) {
-								if (uni <= 0x7F) {
+							if (uni_val.length() == length) {
+								size_t r = 0;
+								unsigned long uni;
+								try {
+									uni = std::stoul(uni_val, &r, 16);
+								} catch (const std::exception&) {
+									report(DC_InvalidEscapeSequence, mOffset - static_cast<uint32>(length));
+									break;
+								}
+
+								if (r != length) {
+									report(DC_InvalidUnicodeSequence, mOffset - static_cast<uint32>(length));
+								} else if (length != 2) {
+									if (uni <= 0x7F) {
+										str += (char)uni;
+									} else if (uni <= 0x7FF) {
+										unsigned long d = uni & 0x7FF;
+										str += char(0xC0 | ((d & 0x7C0) >> 6));
+										str += char(0x80 | (d & 0x3F));
+									} else if (uni <= 0xFFFF) {
+										unsigned long d = uni & 0xFFFF;
+										str += char(0xE0 | ((d & 0xF000) >> 12));
+										str += char(0x80 | ((d & 0xFC0) >> 6));
+										str += char(0x80 | (d & 0x3F));
+									} else if (uni <= 0x10FFFF) {
+										unsigned long d = uni & 0x10FFFF;
+										str += char(0xF0 | ((d & 0x1C0000) >> 18));
+										str += char(0x80 | ((d & 0x3F000) >> 12));
+										str += char(0x80 | ((d & 0xFC0) >> 6));
+										str += char(0x80 | (d & 0x3F));
+									} else {
+										report(DC_InvalidUnicodeRange, mOffset - static_cast<uint32>(length));
+									}
+								} else //Binary
+								{
 									str += (char)uni;
-								} else if (uni <= 0x7FF) {
-									unsigned long d = uni & 0x7FF;
-									str += char(0xC0 | ((d & 0x7C0) >> 6));
-									str += char(0x80 | (d & 0x3F));
-								} else if (uni <= 0xFFFF) {
-									unsigned long d = uni & 0xFFFF;
-									str += char(0xE0 | ((d & 0xF000) >> 12));
-									str += char(0x80 | ((d & 0xFC0) >> 6));
-									str += char(0x80 | (d & 0x3F));
-								} else if (uni <= 0x10FFFF) {
-									unsigned long d = uni & 0x10FFFF;
-									str += char(0xF0 | ((d & 0x1C0000) >> 18));
-									str += char(0x80 | ((d & 0x3F000) >> 12));
-									str += char(0x80 | ((d & 0xFC0) >> 6));
-									str += char(0x80 | (d & 0x3F));
-								} else {
-									mLogger->log(mLineNumber, mColumnNumber, L_Error, "Invalid Unicode range.");
 								}
-							} else //Binary
-							{
-								str += (char)uni;
 							}
+						} break;
+						default:
+							str += mCurrentChar;
+							break;
 						}
-					} break;
-					default:
-						str += mCurrentChar;
-						break;
 					}
+				} else if (mCurrentChar == start) {
+					mCurrentChar = readChar();
+					++mColumnNumber;
+					break;
+				} else {
+					str += mCurrentChar;
 				}
-			} else if (mCurrentChar == start) {
-				mCurrentChar = mProvider->get();
-				++mColumnNumber;
-				break;
-			} else {
-				str += mCurrentChar;
 			}
-		}
 
-		Token token;
-		token.Type  = T_String;
-		token.Value = str;
-		return token;
-	} else if (isdigit(mCurrentChar) || mCurrentChar == '-' || mCurrentChar == '+' || mCurrentChar == '.') {
-		string_t identifier;
+			Token token;
+			token.Type  = T_String;
+			token.Value = str;
+			return token;
+		} else if (isdigit(mCurrentChar) || mCurrentChar == '-' || mCurrentChar == '+' || mCurrentChar == '.') {
+			string_t identifier;
 
-		//bool hasSign = false;
-		bool hasData = false;
-		bool hasDot  = false;
+			const uint32 begin = mOffset;
 
-		bool hasExp		= false;
-		bool hasExpSign = false;
-		bool hasExpData = false;
+			//bool hasSign = false;
+			bool hasData = false;
+			bool hasDot  = false;
 
-		if (mCurrentChar == '-' || mCurrentChar == '+') {
-			//hasSign = true;
-		} else if (mCurrentChar == '.') {
-			hasDot = true;
-		} else {
-			hasData = true;
-		}
+			bool hasExp		= false;
+			bool hasExpSign = false;
+			bool hasExpData = false;
 
-		// Skip first character
-		identifier += mCurrentChar;
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
+			if (mCurrentChar == '-' || mCurrentChar == '+') {
+				//hasSign = true;
+			} else if (mCurrentChar == '.') {
+				hasDot = true;
+			} else {
+				hasData = true;
+			}
 
-		// Consume digits
-		if (!hasDot) {
+			// Skip first character
+			identifier += mCurrentChar;
+			mCurrentChar = readChar();
+			++mColumnNumber;
+
+			// Consume digits
+			if (!hasDot) {
+				while (mProvider->good()) {
+					if (isdigit(mCurrentChar)) {
+						hasData = true;
+						identifier += mCurrentChar;
+						mCurrentChar = readChar();
+						++mColumnNumber;
+					} else {
+						break;
+					}
+				}
+
+				// Floating point
+				if (mProvider->good() && mCurrentChar == '.') {
+					hasDot = true;
+					identifier += mCurrentChar;
+					mCurrentChar = readChar();
+					++mColumnNumber;
+				}
+			}
+
+			// Consume digits
 			while (mProvider->good()) {
 				if (isdigit(mCurrentChar)) {
 					hasData = true;
 					identifier += mCurrentChar;
-					mCurrentChar = mProvider->get();
+					mCurrentChar = readChar();
 					++mColumnNumber;
 				} else {
 					break;
 				}
 			}
 
-			// Floating point
-			if (mProvider->good() && mCurrentChar == '.') {
-				hasDot = true;
+			// Exponent
+			if (mProvider->good() && (mCurrentChar == 'e' || mCurrentChar == 'E')) {
+				hasExp = true;
 				identifier += mCurrentChar;
-				mCurrentChar = mProvider->get();
+				mCurrentChar = readChar();
 				++mColumnNumber;
 			}
-		}
 
-		// Consume digits
-		while (mProvider->good()) {
-			if (isdigit(mCurrentChar)) {
-				hasData = true;
-				identifier += mCurrentChar;
-				mCurrentChar = mProvider->get();
-				++mColumnNumber;
+			// Exponent signs
+			if (hasExp) {
+				if (mProvider->good() && (mCurrentChar == '+' || mCurrentChar == '-')) {
+					hasExpSign = true;
+					identifier += mCurrentChar;
+					mCurrentChar = readChar();
+					++mColumnNumber;
+				}
+
+				// Consume digits
+				while (mProvider->good()) {
+					if (isdigit(mCurrentChar)) {
+						hasExpData = true;
+						identifier += mCurrentChar;
+						mCurrentChar = readChar();
+						++mColumnNumber;
+					} else {
+						break;
+					}
+				}
+			}
+
+			Token token;
+			if (hasData && (hasDot || (hasExp && hasExpData))) {
+				token.Type  = T_Float;
+				token.Value = identifier;
+			} else if (hasData && !hasDot && !hasExp && !hasExpData && !hasExpSign) {
+				token.Type  = T_Integer;
+				token.Value = identifier;
 			} else {
-				break;
+				report(DC_InvalidNumber, begin, 0, identifier);
+				continue;
 			}
-		}
 
-		// Exponent
-		if (mProvider->good() && (mCurrentChar == 'e' || mCurrentChar == 'E')) {
-			hasExp = true;
+			return token;
+		} else if (isAlpha(mCurrentChar)) //Identifier
+		{
+			string_t identifier;
 			identifier += mCurrentChar;
-			mCurrentChar = mProvider->get();
-			++mColumnNumber;
-		}
-
-		// Exponent signs
-		if (hasExp) {
-			if (mProvider->good() && (mCurrentChar == '+' || mCurrentChar == '-')) {
-				hasExpSign = true;
-				identifier += mCurrentChar;
-				mCurrentChar = mProvider->get();
-				++mColumnNumber;
-			}
 
-			// Consume digits
+			mCurrentChar = readChar();
+			++mColumnNumber;
 			while (mProvider->good()) {
-				if (isdigit(mCurrentChar)) {
-					hasExpData = true;
+				if (isAscii(mCurrentChar)) {
 					identifier += mCurrentChar;
-					mCurrentChar = mProvider->get();
+					mCurrentChar = readChar();
 					++mColumnNumber;
 				} else {
 					break;
 				}
 			}
-		}
 
-		Token token;
-		if (hasData && (hasDot || (hasExp && hasExpData))) {
-			token.Type  = T_Float;
-			token.Value = identifier;
-		} else if (hasData && !hasDot && !hasExp && !hasExpData && !hasExpSign) {
-			token.Type  = T_Integer;
-			token.Value = identifier;
-		}
-
-		return token;
-	} else if (isAlpha(mCurrentChar)) //Identifier
-	{
-		string_t identifier;
-		identifier += mCurrentChar;
-
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
-		while (mProvider->good()) {
-			if (isAscii(mCurrentChar)) {
-				identifier += mCurrentChar;
-				mCurrentChar = mProvider->get();
-				++mColumnNumber;
+			Token token;
+			if (identifier == "true") {
+				token.Type = T_True;
+			} else if (identifier == "false") {
+				token.Type = T_False;
 			} else {
-				break;
+				token.Type  = T_Identifier;
+				token.Value = identifier;
+			}
+			return token;
+		} else if (isWhitespace(mCurrentChar)) {
+			if (mCurrentChar == '\n') {
+				++mLineNumber;
+				mColumnNumber = 0;
 			}
-		}
 
-		Token token;
-		if (identifier == "true") {
-			token.Type = T_True;
-		} else if (identifier == "false") {
-			token.Type = T_False;
+			mCurrentChar = readChar();
+			++mColumnNumber;
+			continue;
 		} else {
-			token.Type  = T_Identifier;
-			token.Value = identifier;
-		}
-		return token;
-	} else if (isWhitespace(mCurrentChar)) {
-		if (mCurrentChar == '\n') {
-			++mLineNumber;
-			mColumnNumber = 0;
+			report(DC_InvalidCharacter, mOffset, mCurrentChar);
+			mCurrentChar = readChar();
+			++mColumnNumber;
+			continue;
 		}
-
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
-		return getNextToken();
-	} else {
-		std::stringstream stream;
-		stream << "Invalid character '" << mCurrentChar << "'";
-		mLogger->log(mLineNumber, mColumnNumber, L_Error, stream.str());
-		mCurrentChar = mProvider->get();
-		++mColumnNumber;
-		return getNextToken();
 	}
 }
 
@@ -399,30 +409,87 @@ Token Lexer::next()
 {
 	// Restore from look()
 	if (mNextToken.Type != T_EOF) {
-		Token token		= mNextToken;
+		Token token		= std::move(mNextToken);
 		mColumnNumber   = mNextColumnNumber;
 		mLineNumber		= mNextLineNumber;
+		mOffset			= mNextOffset;
 		mNextToken.Type = T_EOF;
 		return token;
-	} else {
+	} else if (!mStatistics) {
 		return getNextToken();
+	} else {
+		const auto start = std::chrono::steady_clock::now();
+		Token token		 = getNextToken();
+		mStatistics->LexTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		++mStatistics->TokenCount;
+		return token;
 	}
 }
 
 Token Lexer::look()
+{
+	fetch();
+	return mNextToken;
+}
+
+TokenType Lexer::lookType()
+{
+	if (mNextToken.Type == T_EOF)
+		fetch();
+	return mNextToken.Type;
+}
+
+void Lexer::fetch()
 {
 	line_t l   = mLineNumber;
 	column_t c = mColumnNumber;
+	uint32 o   = mOffset;
 
-	Token t = next();
 	// Save for next() call
-	mNextToken		  = t;
+	mNextToken		  = next();
 	mNextColumnNumber = mColumnNumber;
 	mNextLineNumber   = mLineNumber;
+	mNextOffset		  = mOffset;
 
 	mColumnNumber = c;
 	mLineNumber   = l;
-	return t;
+	mOffset		  = o;
+}
+
+void Lexer::report(DiagnosticCode code, uint32 begin, int32 arg, const string_t& text)
+{
+	Diagnostic diagnostic(code, L_Error, arg);
+	diagnostic.FileId = mFileId;
+	diagnostic.Begin  = begin;
+	diagnostic.End	  = mProvider->good() ? mOffset + 1 : mOffset;
+	diagnostic.Line	  = mLineNumber;
+	diagnostic.Column = mColumnNumber;
+	diagnostic.Text	  = text;
+	report(diagnostic);
+}
+
+void Lexer::report(const Diagnostic& diagnostic)
+{
+	if (diagnostic.Severity < L_Error) {
+		mLogger->report(diagnostic);
+		return;
+	}
+
+	if (tooManyErrors())
+		return;
+
+	++mErrorCount;
+	mLogger->report(diagnostic);
+
+	if (tooManyErrors()) {
+		Diagnostic limit(DC_TooManyErrors, L_Fatal, static_cast<int32>(mMaxErrors));
+		limit.FileId = diagnostic.FileId;
+		limit.Begin	 = diagnostic.Begin;
+		limit.End	 = diagnostic.End;
+		limit.Line	 = diagnostic.Line;
+		limit.Column = diagnostic.Column;
+		mLogger->report(limit);
+	}
 }
 
 line_t Lexer::currentLine() const
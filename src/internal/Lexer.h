@@ -30,10 +30,11 @@
 #pragma once
 
 #include "DataLispConfig.h"
-#include "SourceLogger.h"
+#include "Diagnostic.h"
 #include "Token.h"
 
 namespace DL {
+struct Statistics;
 class DL_INTERNAL_LIB Lexer {
 public:
 	Lexer(stream_t* provider, SourceLogger* logger);
@@ -41,12 +42,37 @@ public:
 
 	Token next();
 	Token look();
+	TokenType lookType(); // Same as look().Type without copying the token
+
+	// Measures the time and count of the produced tokens. Can be NULL
+	inline void setStatistics(Statistics* stats) { mStatistics = stats; }
 
 	line_t currentLine() const;
 	column_t currentColumn() const;
 
+	// Byte offset of the current character
+	inline uint32 currentOffset() const { return mOffset; }
+
+	// Id given to all reported diagnostics
+	inline void setFileId(uint32 id) { mFileId = id; }
+	inline uint32 fileId() const { return mFileId; }
+
+	// Errors beyond the maximum are not reported, a single fatal error is reported instead
+	inline void setMaxErrors(uint32 count) { mMaxErrors = count; }
+	inline bool tooManyErrors() const { return mErrorCount >= mMaxErrors; }
+
+	// Reports the diagnostic with respect to the maximum count of errors
+	void report(const Diagnostic& diagnostic);
+
 private:
 	Token getNextToken();
+	void fetch();
+	inline char readChar()
+	{
+		++mOffset;
+		return static_cast<char>(mProvider->get());
+	}
+	void report(DiagnosticCode code, uint32 begin, int32 arg = 0, const string_t& text = string_t());
 	static bool isWhitespace(char c); /* UNICODE? */
 	static bool isAscii(char c);
 	static bool isAlpha(char c);
@@ -61,5 +87,13 @@ private:
 	Token mNextToken;
 	line_t mNextLineNumber;
 	column_t mNextColumnNumber;
+
+	uint32 mOffset;
+	uint32 mNextOffset;
+	uint32 mFileId;
+	uint32 mErrorCount;
+	uint32 mMaxErrors;
+
+	Statistics* mStatistics;
 };
 } // namespace DL
@@ -0,0 +1,208 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "NodePool.h"
+
+namespace DL {
+template <typename T>
+static inline T* acquire(vector_t<T*>& list, uint64& allocations)
+{
+	if (list.empty()) {
+		++allocations;
+		return new T;
+	}
+
+	T* ptr = list.back();
+	list.pop_back();
+	return ptr;
+}
+
+template <typename T>
+static inline void freeAll(vector_t<T*>& list)
+{
+	for (T* ptr : list)
+		delete ptr;
+	vector_t<T*>().swap(list);
+}
+
+NodePool::NodePool()
+	: mAllocationCount(0)
+{
+}
+
+NodePool::~NodePool()
+{
+	clear();
+}
+
+SyntaxTree* NodePool::newTree()
+{
+	return acquire(mTrees, mAllocationCount);
+}
+
+StatementNode* NodePool::newStatement()
+{
+	return acquire(mStatements, mAllocationCount);
+}
+
+ExpressionNode* NodePool::newExpression()
+{
+	return acquire(mExpressions, mAllocationCount);
+}
+
+DataNode* NodePool::newData()
+{
+	DataNode* node = acquire(mDatas, mAllocationCount);
+	node->Value	   = nullptr;
+	return node;
+}
+
+ValueNode* NodePool::newValue()
+{
+	ValueNode* node = acquire(mValues, mAllocationCount);
+	node->Type		= VNT_Unknown;
+	return node;
+}
+
+// Nodes are released with an explicit worklist, deeply nested trees do not recurse
+void NodePool::release(SyntaxTree* tree)
+{
+	if (!tree)
+		return;
+
+	for (StatementNode* ptr : tree->Nodes)
+		release(ptr);
+
+	while (!mPending.empty()) {
+		DataNode* n = mPending.back();
+		mPending.pop_back();
+		release(n);
+	}
+
+	tree->Nodes.clear();
+	mTrees.push_back(tree);
+}
+
+void NodePool::release(StatementNode* n)
+{
+	if (!n)
+		return;
+
+	mPending.insert(mPending.end(), n->Nodes.begin(), n->Nodes.end());
+	n->Nodes.clear();
+	mStatements.push_back(n);
+}
+
+void NodePool::release(ExpressionNode* n)
+{
+	if (!n)
+		return;
+
+	mPending.insert(mPending.end(), n->Nodes.begin(), n->Nodes.end());
+	n->Nodes.clear();
+	mExpressions.push_back(n);
+}
+
+void NodePool::release(DataNode* n)
+{
+	if (!n)
+		return;
+
+	release(n->Value);
+	n->Value = nullptr;
+
+	mDatas.push_back(n);
+}
+
+void NodePool::release(ValueNode* n)
+{
+	if (!n)
+		return;
+
+	if (n->Type == VNT_Statement)
+		release(n->_Statement);
+	else if (n->Type == VNT_Expression)
+		release(n->_Expression);
+
+	n->Type = VNT_Unknown;
+	mValues.push_back(n);
+}
+
+template <typename T>
+static inline size_t listUsage(const vector_t<T>& list)
+{
+	return list.capacity() * sizeof(T);
+}
+
+size_t NodePool::memoryUsage(const SyntaxTree* tree)
+{
+	if (!tree)
+		return 0;
+
+	size_t size = sizeof(SyntaxTree) + listUsage(tree->Nodes);
+
+	vector_t<const DataNode*> pending;
+	for (const StatementNode* ptr : tree->Nodes) {
+		size += sizeof(StatementNode) + ptr->Name.capacity() + listUsage(ptr->Nodes);
+		pending.insert(pending.end(), ptr->Nodes.begin(), ptr->Nodes.end());
+	}
+
+	while (!pending.empty()) {
+		const DataNode* n = pending.back();
+		pending.pop_back();
+
+		size += sizeof(DataNode) + n->Key.capacity();
+
+		const ValueNode* v = n->Value;
+		if (!v)
+			continue;
+
+		size += sizeof(ValueNode) + v->_String.capacity();
+		if (v->Type == VNT_Statement) {
+			size += sizeof(StatementNode) + v->_Statement->Name.capacity() + listUsage(v->_Statement->Nodes);
+			pending.insert(pending.end(), v->_Statement->Nodes.begin(), v->_Statement->Nodes.end());
+		} else if (v->Type == VNT_Expression) {
+			size += sizeof(ExpressionNode) + v->_Expression->Name.capacity() + listUsage(v->_Expression->Nodes);
+			pending.insert(pending.end(), v->_Expression->Nodes.begin(), v->_Expression->Nodes.end());
+		}
+	}
+
+	return size;
+}
+
+void NodePool::clear()
+{
+	freeAll(mTrees);
+	freeAll(mStatements);
+	freeAll(mExpressions);
+	freeAll(mDatas);
+	freeAll(mValues);
+	vector_t<DataNode*>().swap(mPending);
+}
+} // namespace DL
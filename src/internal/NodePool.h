@@ -0,0 +1,81 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLispConfig.h"
+#include "SyntaxTree.h"
+
+namespace DL {
+/* Recycles syntax tree nodes between parses.
+ * Released nodes keep their string and vector capacity,
+ * so parsing documents of similar shape does not hit the allocator again.
+ */
+class DL_INTERNAL_LIB NodePool {
+public:
+	NodePool();
+	~NodePool();
+
+	NodePool(const NodePool& other) = delete;
+	NodePool& operator=(const NodePool& other) = delete;
+
+	SyntaxTree* newTree();
+	StatementNode* newStatement();
+	ExpressionNode* newExpression();
+	DataNode* newData();
+	ValueNode* newValue();
+
+	// Returns the tree and all its nodes back to the pool
+	void release(SyntaxTree* tree);
+
+	// Frees all pooled nodes
+	void clear();
+
+	// Number of nodes which could not be recycled
+	inline uint64 allocationCount() const { return mAllocationCount; }
+
+	// Memory used by the given tree including the capacity of its strings and lists
+	static size_t memoryUsage(const SyntaxTree* tree);
+
+private:
+	void release(StatementNode* n);
+	void release(ExpressionNode* n);
+	void release(DataNode* n);
+	void release(ValueNode* n);
+
+	vector_t<SyntaxTree*> mTrees;
+	vector_t<StatementNode*> mStatements;
+	vector_t<ExpressionNode*> mExpressions;
+	vector_t<DataNode*> mDatas;
+	vector_t<ValueNode*> mValues;
+	vector_t<DataNode*> mPending; // Worklist of release
+
+	uint64 mAllocationCount;
+};
+} // namespace DL
@@ -0,0 +1,75 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#pragma once
+
+#include "DataLispConfig.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace DL {
+/* Number formatting without streams, shared by all writers */
+inline void appendInteger(string_t& out, Integer v)
+{
+	char tmp[24];
+	char* end = tmp + sizeof(tmp);
+	char* ptr = end;
+
+	// Work on the unsigned value to handle the smallest integer as well
+	uint64 u = v < 0 ? ~static_cast<uint64>(v) + 1 : static_cast<uint64>(v);
+	do {
+		*--ptr = static_cast<char>('0' + u % 10);
+		u /= 10;
+	} while (u != 0);
+
+	if (v < 0)
+		*--ptr = '-';
+
+	out.append(ptr, end);
+}
+
+/* Shortest representation reading back to the same value.
+ * A fractional part is always added to keep the type when parsed again.
+ */
+inline void appendFloat(string_t& out, Float v)
+{
+	char tmp[32];
+	for (int precision = 6; precision <= 9; ++precision) {
+		std::snprintf(tmp, sizeof(tmp), "%.*g", precision, static_cast<double>(v));
+		if (std::strtof(tmp, nullptr) == v)
+			break;
+	}
+
+	out += tmp;
+	if (std::strpbrk(tmp, ".eEn") == nullptr)
+		out += ".0";
+}
+} // namespace DL
@@ -28,13 +28,40 @@
  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
  */
 #include "Parser.h"
-#include <sstream>
+#include "NodePool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
 
 namespace DL {
-Parser::Parser(stream_t* provider, SourceLogger* logger)
+// Same semantics as std::istream >> value, without constructing a stream per number
+static Integer toInteger(const string_t& str)
+{
+	return static_cast<Integer>(std::strtoll(str.c_str(), nullptr, 10));
+}
+
+static Float toFloat(const string_t& str)
+{
+	Float f = std::strtof(str.c_str(), nullptr);
+	if (f == std::numeric_limits<Float>::infinity())
+		return std::numeric_limits<Float>::max();
+	else if (f == -std::numeric_limits<Float>::infinity())
+		return -std::numeric_limits<Float>::max();
+	else
+		return f;
+}
+
+Parser::Parser(stream_t* provider, SourceLogger* logger, NodePool* pool)
 	: mLexer(provider, logger)
 	, mLogger(logger)
+	, mPool(pool)
+	, mMaxDepth(DEFAULT_MAX_DEPTH)
+	, mAborted(false)
 {
+	DL_ASSERT(pool);
+	mLexer.setMaxErrors(DEFAULT_MAX_ERRORS);
 }
 
 Parser::~Parser()
@@ -51,17 +78,25 @@ Token Parser::match(TokenType type)
 	Token token = mLexer.next();
 
 	if (token.Type != type) {
-		std::stringstream stream;
-		stream << "Expected '" << tokenToString(type) << "' but got '" << tokenToString(token.Type) << "'";
-		mLogger->log(mLexer.currentLine(), mLexer.currentColumn(), L_Error, stream.str());
+		report(DC_UnexpectedToken, type, token.Type);
 	}
 	return token;
 }
 
+void Parser::report(DiagnosticCode code, int32 arg0, int32 arg1, Level level)
+{
+	Diagnostic diagnostic(code, level, arg0, arg1);
+	diagnostic.FileId = mLexer.fileId();
+	diagnostic.Begin  = mLexer.currentOffset();
+	diagnostic.End	  = mLexer.currentOffset();
+	diagnostic.Line	  = mLexer.currentLine();
+	diagnostic.Column = mLexer.currentColumn();
+	mLexer.report(diagnostic);
+}
+
 bool Parser::lookahead(TokenType type)
 {
-	Token token = mLexer.look();
-	return token.Type == type;
+	return mLexer.lookType() == type;
 }
 
 const char* Parser::tokenToString(TokenType type)
@@ -102,142 +137,279 @@ const char* Parser::tokenToString(TokenType type)
 
 SyntaxTree* Parser::gr_tr_unit()
 {
-	SyntaxTree* unit = new SyntaxTree;
-	while (lookahead(T_OpenParanthese)) {
+	SyntaxTree* unit = mPool->newTree();
+	for (;;) {
+		if (mLexer.tooManyErrors())
+			mAborted = true;
+
+		const TokenType type = mLexer.lookType();
+		if (mAborted || type == T_EOF)
+			break;
+
+		if (type != T_OpenParanthese) {
+			report(DC_UnexpectedToken, T_OpenParanthese, type);
+			skipToStatement();
+			continue;
+		}
+
 		match(T_OpenParanthese);
-		unit->Nodes.push_back(gr_statement());
-		match(T_CloseParanthese);
-	};
+
+		StatementNode* node = gr_statement();
+		unit->Nodes.push_back(node);
+		gr_data_list(node->Nodes);
+	}
 	return unit;
 }
 
 StatementNode* Parser::gr_statement()
 {
-	StatementNode* node = new StatementNode;
+	StatementNode* node = mPool->newStatement();
 
-	node->Name = match(T_Identifier).Value;
+	// A missing name is reported only, the content is parsed as usual
+	if (lookahead(T_Identifier)) {
+		node->Name = mLexer.next().Value;
+	} else {
+		node->Name.clear();
+		report(DC_UnexpectedToken, T_Identifier, mLexer.lookType());
+	}
 
 	if (lookahead(T_Comma))
 		match(T_Comma);
 
-	node->Nodes = gr_data_list();
 	return node;
 }
 
-ExpressionNode* Parser::gr_expression()
+static inline bool isDataStart(TokenType type)
 {
-	ExpressionNode* node = new ExpressionNode;
+	switch (type) {
+	case T_Colon:
+	case T_OpenParanthese:
+	case T_OpenSquareBracket:
+	case T_ExpressionParanthese:
+	case T_Integer:
+	case T_Float:
+	case T_String:
+	case T_True:
+	case T_False:
+		return true;
+	default:
+		return false;
+	}
+}
 
-	node->Name  = match(T_Identifier).Value;
-	node->Nodes = gr_data_list();
-	return node;
+static inline bool isOpening(TokenType type)
+{
+	return type == T_OpenParanthese || type == T_OpenSquareBracket || type == T_ExpressionParanthese;
+}
+
+static inline bool isClosing(TokenType type)
+{
+	return type == T_CloseParanthese || type == T_CloseSquareBracket;
 }
 
-vector_t<DataNode*> Parser::gr_data_list()
+void Parser::gr_data_list(vector_t<DataNode*>& list)
 {
-	vector_t<DataNode*> list;
-	while (lookahead(T_Colon) || lookahead(T_OpenParanthese) || lookahead(T_OpenSquareBracket) || lookahead(T_ExpressionParanthese) || lookahead(T_Integer) || lookahead(T_Float) || lookahead(T_String) || lookahead(T_True) || lookahead(T_False)) {
-		list.push_back(gr_data());
+	mStack.clear();
+	mStack.push_back(Frame{ &list, T_CloseParanthese, nullptr });
 
-		if (lookahead(T_Comma))
-			match(T_Comma);
+	while (!mStack.empty()) {
+		if (mLexer.tooManyErrors()) {
+			mAborted = true;
+			break;
+		}
+
+		const TokenType type = mLexer.lookType();
+		if (type == mStack.back().Closing) {
+			mLexer.next();
+			closeFrame();
+			continue;
+		}
+
+		if (!isDataStart(type)) {
+			report(DC_UnexpectedToken, mStack.back().Closing, type);
+			if (type == T_EOF) {
+				mStack.clear();
+			} else if (!isClosing(type)) {
+				recover();
+			} else if (std::any_of(mStack.begin(), mStack.end() - 1, [=](const Frame& f) { return f.Closing == type; })) {
+				mStack.pop_back(); // Unclosed list, the token belongs to an outer one
+			} else {
+				mLexer.next(); // Mismatched closing token
+				closeFrame();
+			}
+			continue;
+		}
+
+		DataNode* node = gr_data();
+		if (!node) {
+			recover();
+			continue;
+		}
+		mStack.back().List->push_back(node);
+
+		Frame nested;
+		if (!gr_value(node->Value, nested)) {
+			if (node->Value->Type == VNT_Unknown)
+				recover();
+			else if (lookahead(T_Comma))
+				match(T_Comma);
+		} else if (mStack.size() >= mMaxDepth) {
+			report(DC_MaxDepthExceeded, static_cast<int32>(mMaxDepth), 0, L_Fatal);
+			mAborted = true;
+			mStack.clear();
+		} else {
+			mStack.push_back(nested);
+		}
 	}
+}
 
-	return list;
+void Parser::closeFrame()
+{
+	const Frame& frame = mStack.back();
+	if (frame.Expression)
+		frame.Expression->End = mLexer.currentOffset();
+	mStack.pop_back();
+
+	if (!mStack.empty() && lookahead(T_Comma))
+		match(T_Comma);
 }
 
-DataNode* Parser::gr_data()
+/* Panic mode recovery: Skips all tokens up to the closing token balancing the innermost open list.
+ * The list is closed by it, regardless of its type. Every token is skipped at most once,
+ * therefor malformed sources are still parsed in linear time.
+ */
+void Parser::recover()
+{
+	uint32 depth = 0;
+	for (;;) {
+		const TokenType type = mLexer.lookType();
+		if (type == T_EOF || mLexer.tooManyErrors()) {
+			mStack.clear();
+			return;
+		}
+
+		mLexer.next();
+		if (isOpening(type)) {
+			++depth;
+		} else if (isClosing(type)) {
+			if (depth == 0) {
+				closeFrame();
+				return;
+			}
+			--depth;
+		}
+	}
+}
+
+// Skips all tokens up to the next statement on top level
+void Parser::skipToStatement()
 {
-	DataNode* node = new DataNode;
+	uint32 depth = 0;
+	for (;;) {
+		const TokenType type = mLexer.lookType();
+		if (type == T_EOF || (depth == 0 && type == T_OpenParanthese))
+			return;
+
+		mLexer.next();
+		if (isOpening(type))
+			++depth;
+		else if (isClosing(type) && depth > 0)
+			--depth;
+	}
+}
 
+DataNode* Parser::gr_data()
+{
+	string_t key;
 	if (lookahead(T_Colon)) {
 		match(T_Colon);
 
-		Token str;
-		if (lookahead(T_Integer)) {
-			str = match(T_Integer);
-		} else {
-			str = match(T_Identifier);
+		const TokenType type = mLexer.lookType();
+		if (type != T_Integer && type != T_Identifier) {
+			report(DC_UnexpectedToken, T_Identifier, type);
+			return nullptr;
 		}
 
-		node->Key = str.Value;
-	} else {
-		node->Key = "";
+		key = std::move(mLexer.next().Value);
 	}
 
-	node->Value = gr_value();
+	DataNode* node = mPool->newData();
+	node->Key	   = std::move(key);
+	node->Value	   = mPool->newValue();
 	return node;
 }
 
-ValueNode* Parser::gr_value()
+bool Parser::gr_value(ValueNode* node, Frame& frame)
 {
-	ValueNode* node = new ValueNode;
-
-	if (lookahead(T_OpenParanthese)) {
+	switch (mLexer.lookType()) {
+	case T_OpenParanthese: {
 		match(T_OpenParanthese);
 
 		node->Type		 = VNT_Statement;
 		node->_Statement = gr_statement();
 
-		match(T_CloseParanthese);
-	} else if (lookahead(T_OpenSquareBracket)) // Anonymous group
-	{
+		frame = Frame{ &node->_Statement->Nodes, T_CloseParanthese, nullptr };
+		return true;
+	}
+	case T_OpenSquareBracket: { // Anonymous group
 		match(T_OpenSquareBracket);
 
 		node->Type		 = VNT_Statement;
-		node->_Statement = gr_array();
+		node->_Statement = mPool->newStatement();
+		node->_Statement->Name.clear();
 
-		match(T_CloseSquareBracket);
-	} else if (lookahead(T_ExpressionParanthese)) {
+		frame = Frame{ &node->_Statement->Nodes, T_CloseSquareBracket, nullptr };
+		return true;
+	}
+	case T_ExpressionParanthese: {
 		match(T_ExpressionParanthese);
 
-		node->Type		  = VNT_Expression;
-		node->_Expression = gr_expression();
-
-		match(T_CloseParanthese);
-	} else if (lookahead(T_Integer)) {
-		Token str = match(T_Integer);
-
-		node->Type = VNT_Integer;
-		std::istringstream(str.Value) >> node->_Integer;
-	} else if (lookahead(T_Float)) {
-		Token str = match(T_Float);
+		ExpressionNode* expr = mPool->newExpression();
+		expr->Line			 = mLexer.currentLine();
+		expr->Column		 = mLexer.currentColumn() - 2;
+		expr->Begin			 = mLexer.currentOffset() - 2;
+		expr->End			 = expr->Begin;
+		if (lookahead(T_Identifier)) {
+			expr->Name = mLexer.next().Value;
+		} else {
+			expr->Name.clear();
+			report(DC_UnexpectedToken, T_Identifier, mLexer.lookType());
+		}
 
-		node->Type = VNT_Float;
-		std::istringstream(str.Value) >> node->_Float;
-	} else if (lookahead(T_String)) {
-		Token str = match(T_String);
+		node->Type		  = VNT_Expression;
+		node->_Expression = expr;
 
-		node->Type	= VNT_String;
-		node->_String = str.Value;
-	} else if (lookahead(T_True)) {
+		frame = Frame{ &expr->Nodes, T_CloseParanthese, expr };
+		return true;
+	}
+	case T_Integer:
+		node->Type	   = VNT_Integer;
+		node->_Integer = toInteger(match(T_Integer).Value);
+		break;
+	case T_Float:
+		node->Type	 = VNT_Float;
+		node->_Float = toFloat(match(T_Float).Value);
+		break;
+	case T_String:
+		node->Type	  = VNT_String;
+		node->_String = match(T_String).Value;
+		break;
+	case T_True:
 		match(T_True);
-
-		node->Type	 = VNT_Boolean;
+		node->Type	   = VNT_Boolean;
 		node->_Boolean = true;
-	} else if (lookahead(T_False)) {
+		break;
+	case T_False:
 		match(T_False);
-
-		node->Type	 = VNT_Boolean;
+		node->Type	   = VNT_Boolean;
 		node->_Boolean = false;
-	} else {
+		break;
+	default:
 		node->Type = VNT_Unknown;
-
-		std::stringstream stream;
-		stream << "INTERNAL: Unknown lookahead '" << tokenToString(mLexer.look().Type) << "' for values.";
-		mLogger->log(mLexer.currentLine(), mLexer.currentColumn(), L_Fatal, stream.str());
+		report(DC_UnknownLookahead, mLexer.lookType());
+		break;
 	}
 
-	return node;
-}
-
-StatementNode* Parser::gr_array()
-{
-	StatementNode* node = new StatementNode;
-
-	node->Name  = "";
-	node->Nodes = gr_data_list();
-
-	return node;
+	return false;
 }
-} // namespace DL
\ No newline at end of file
+} // namespace DL
@@ -34,29 +34,62 @@
 #include "SyntaxTree.h"
 
 namespace DL {
+class NodePool;
+/* Recursive descent parser using an explicit stack for nested values.
+ * The nesting depth is therefor only limited by the given maximum, not by the call stack.
+ * Syntax errors are recovered from by skipping to the end of the innermost list (panic mode).
+ */
 class DL_INTERNAL_LIB Parser {
 public:
-	Parser(stream_t* provider, SourceLogger* logger);
+	static constexpr uint32 DEFAULT_MAX_DEPTH  = 1024;
+	static constexpr uint32 DEFAULT_MAX_ERRORS = 100;
+
+	Parser(stream_t* provider, SourceLogger* logger, NodePool* pool);
 	virtual ~Parser();
 
 	SyntaxTree* parse();
 
+	static const char* tokenToString(TokenType type);
+
+	inline void setStatistics(Statistics* stats) { mLexer.setStatistics(stats); }
+	inline void setFileId(uint32 id) { mLexer.setFileId(id); }
+
+	// Maximum nesting of statements, arrays and expressions. Parsing stops with an error if exceeded
+	inline void setMaxDepth(uint32 depth) { mMaxDepth = depth; }
+
+	// Maximum count of reported errors. Parsing stops with an error if exceeded
+	inline void setMaxErrors(uint32 count) { mLexer.setMaxErrors(count); }
+
 private:
+	struct Frame {
+		vector_t<DataNode*>* List;
+		TokenType Closing;
+		ExpressionNode* Expression; // Receives the end offset when closed
+	};
+
 	Token match(TokenType type);
 	bool lookahead(TokenType type);
-	static const char* tokenToString(TokenType type);
+	void report(DiagnosticCode code, int32 arg0, int32 arg1 = 0, Level level = L_Error);
 
 	SyntaxTree* gr_tr_unit();
 	StatementNode* gr_statement();
-	StatementNode* gr_array();
-	ExpressionNode* gr_expression();
 
-	vector_t<DataNode*> gr_data_list();
+	void gr_data_list(vector_t<DataNode*>& list);
 	DataNode* gr_data();
 
-	ValueNode* gr_value();
+	// Returns true if the value opens a nested list, described by the frame
+	bool gr_value(ValueNode* node, Frame& frame);
+
+	void closeFrame();
+	void recover();
+	void skipToStatement();
 
 	Lexer mLexer;
 	SourceLogger* mLogger;
+	NodePool* mPool;
+
+	uint32 mMaxDepth;
+	bool mAborted;
+	vector_t<Frame> mStack;
 };
 } // namespace DL
@@ -0,0 +1,105 @@
+/*
+ Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+
+ 1. Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+
+ 2. Redistributions in binary form must reproduce the above copyright
+ notice, this list of conditions and the following disclaimer in the
+ documentation and/or other materials provided with the distribution.
+
+ 3. Neither the name of the copyright owner may be used
+ to endorse or promote products derived from this software without
+ specific prior written permission.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+ */
+#include "StatementScanner.h"
+
+namespace DL {
+bool scanStatements(const char* data, size_t size, vector_t<StatementRange>& ranges)
+{
+	ranges.clear();
+
+	line_t line		 = 1;
+	size_t lineStart = 0;
+	size_t depth	 = 0;
+
+	for (size_t i = 0; i < size; ++i) {
+		const char c = data[i];
+		switch (c) {
+		case '\n':
+			++line;
+			lineStart = i + 1;
+			break;
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\v':
+		case '\f':
+			break;
+		case ';': // Comment
+			while (i + 1 < size && data[i + 1] != '\n')
+				++i;
+			break;
+		case '"':
+		case '\'': // String, same rules as the lexer
+			if (depth == 0)
+				return false;
+
+			for (++i; i < size && data[i] != c && data[i] != '\n'; ++i) {
+				if (data[i] == '\\' && i + 1 < size) {
+					++i;
+					if (data[i] == '\n') {
+						++line;
+						lineStart = i + 1;
+					}
+				}
+			}
+
+			if (i < size && data[i] == '\n') {
+				++line;
+				lineStart = i + 1;
+			}
+			break;
+		case '(':
+		case '[':
+			if (depth == 0) {
+				if (c != '(')
+					return false;
+				ranges.push_back(StatementRange{ i, 0, line, static_cast<column_t>(i - lineStart + 1) });
+			}
+			++depth;
+			break;
+		case ')':
+		case ']':
+			if (depth == 0)
+				return false;
+
+			--depth;
+			if (depth == 0)
+				ranges.back().End = i + 1;
+			break;
+		default:
+			if (depth == 0)
+				return false;
+			break;
+		}
+	}
+
+	return depth == 0;
+}
+} // namespace DL
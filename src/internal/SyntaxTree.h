@@ -30,6 +30,7 @@
 #pragma once
 
 #include "DataLispConfig.h"
+#include "SourceLogger.h"
 
 namespace DL {
 struct DataNode;
@@ -72,6 +73,10 @@ struct DL_INTERNAL_LIB StatementNode {
 struct DL_INTERNAL_LIB ExpressionNode {
 	string_t Name;
 	vector_t<DataNode*> Nodes;
+	line_t Line; // Position of the '$'
+	column_t Column;
+	uint32 Begin; // Byte offset of the '$'
+	uint32 End;	  // Byte offset after the closing ')'
 };
 
 struct DL_INTERNAL_LIB SyntaxTree {
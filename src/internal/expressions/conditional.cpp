@@ -40,7 +40,9 @@ namespace Expressions {
 Data if_func(const vector_t<Data>& args, VM& vm)
 {
 	if (args.size() != 3 && args.size() != 2) {
-		vm.logger()->log(L_Error, "Invalid arguments given for $(if ...)");
+		Diagnostic diagnostic(DC_InvalidArguments, L_Error);
+		diagnostic.Text = "if";
+		vm.report(diagnostic);
 		return Data();
 	}
 
@@ -59,7 +61,9 @@ Data if_func(const vector_t<Data>& args, VM& vm)
 	if (conv.type() == DT_Bool) {
 		c = conv.getBool();
 	} else {
-		vm.logger()->log(L_Error, "Non boolean condition given for $(if ...)");
+		Diagnostic diagnostic(DC_InvalidCondition, L_Error);
+		diagnostic.Text = "if";
+		vm.report(diagnostic);
 		return Data();
 	}
 
@@ -68,7 +72,11 @@ Data if_func(const vector_t<Data>& args, VM& vm)
 
 static Data not_func_e(const Data& d, VM& vm)
 {
+	// Invalid conversions are already reported
 	Data r = vm.castTo(d, DT_Bool);
+	if (r.type() != DT_Bool)
+		return Data();
+
 	r.setBool(!r.getBool());
 	return r;
 }
@@ -89,7 +97,7 @@ Data and_func(const vector_t<Data>& args, VM& vm)
 
 		for (const Data& d : args) {
 			Data e = vm.castTo(d, DT_Bool);
-			if (!e.isValid() || !e.getBool()) {
+			if (e.type() != DT_Bool || !e.getBool()) {
 				b = false;
 				break;
 			}
@@ -112,7 +120,7 @@ Data or_func(const vector_t<Data>& args, VM& vm)
 
 		for (const Data& d : args) {
 			Data e = vm.castTo(d, DT_Bool);
-			if (e.isValid() && e.getBool()) {
+			if (e.type() == DT_Bool && e.getBool()) {
 				b = true;
 				break;
 			}
@@ -93,12 +93,15 @@ static void print_val(const Data& d, std::stringstream& stream)
 
 Data print_func(const vector_t<Data>& args, VM& vm)
 {
-	std::stringstream stream;
-
-	for (const Data& d : args)
-		print_val(d, stream);
-
-	vm.logger()->log(L_Info, stream.str());
+	if (vm.logger()->enabled(L_Info)) {
+		std::stringstream stream;
+		for (const Data& d : args)
+			print_val(d, stream);
+
+		Diagnostic diagnostic(DC_Message, L_Info);
+		diagnostic.Text = stream.str();
+		vm.report(diagnostic);
+	}
 	return Data();
 }
 } // namespace Expressions
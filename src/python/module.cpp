@@ -166,6 +166,12 @@ public:
 	void addTopGroup_PY(const DataGroup_PY& group) { addTopGroup(group); }
 };
 
+//--
+static string_t generate_PY(const DataContainer& container, GenerateMode mode)
+{
+	return DataLisp::generate(container, mode);
+}
+
 //----------
 BOOST_PYTHON_MODULE(pydatalisp)
 {
@@ -180,8 +186,9 @@ BOOST_PYTHON_MODULE(pydatalisp)
 	bpy::class_<DataLisp, boost::noncopyable>("DataLisp",
 											  bpy::init<SourceLogger*>(bpy::args("source_logger")))
 		.def("parse", (void (DataLisp::*)(const string_t&)) & DataLisp::parse)
-		.def("build", &DataLisp::build)
-		.def("generate", &DataLisp::generate)
+		.def("build", (void (DataLisp::*)(DataContainer&)) & DataLisp::build)
+		.def("generate", &generate_PY,
+			 (bpy::arg("container"), bpy::arg("mode") = GM_Pretty))
 		.staticmethod("generate")
 		.def("dump", &DataLisp::dump);
 
@@ -232,4 +239,8 @@ BOOST_PYTHON_MODULE(pydatalisp)
 		.value("Bool", DT_Bool)
 		.value("String", DT_String)
 		.value("None", DT_None);
+
+	bpy::enum_<GenerateMode>("GenerateMode")
+		.value("Pretty", GM_Pretty)
+		.value("Compact", GM_Compact);
 }
\ No newline at end of file
@@ -0,0 +1,203 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "Binary.h"
+#include "DataContainer.h"
+#include "DataLisp.h"
+
+const char* TEST_FILE = "(scene :name \"Test\"\n"
+						"  (object :id 1 :scale 2.5 :visible true :material \"glass\")\n"
+						"  (object :id 2 :scale 0.5 :visible false)\n"
+						"  :tags [\"a\" \"b\" \"a\"])\n"
+						"(settings :steps 128 :samples 64 :steps 256)\n";
+
+// Header layout of the binary format
+struct Header {
+	char Magic[4];
+	DL::uint32 Version;
+	DL::uint32 Endian;
+	DL::uint32 TopGroupCount;
+	DL::uint64 StringTableOffset;
+	DL::uint64 StringTableSize;
+	DL::uint64 TopGroupsOffset;
+	DL::uint64 FileSize;
+};
+
+/* Writes a chain of array groups by hand. Every group has a single anonymous entry, which is the previous group.
+ * With shared, the last group has a second entry referring to the same child.
+ * The string table only contains the empty string.
+ */
+static std::vector<DL::uint64> makeChain(size_t count, bool shared, size_t& size)
+{
+	const size_t groupsBegin = sizeof(Header) + 8;
+	const size_t last		 = groupsBegin + (count - 1) * 32;
+	size					 = last + (shared ? 48 : 32) + sizeof(DL::uint64);
+
+	std::vector<DL::uint64> buffer(size / sizeof(DL::uint64), 0);
+	char* data = reinterpret_cast<char*>(buffer.data());
+
+	const Header hdr = { { 'D', 'L', 'B', '\0' }, 1, 0x01020304, 1, sizeof(Header), 8, size - sizeof(DL::uint64), size };
+	std::memcpy(data, &hdr, sizeof(hdr));
+
+	for (size_t i = 0; i < count; ++i) {
+		DL::uint32* grp = reinterpret_cast<DL::uint32*>(data + groupsBegin + i * 32);
+		grp[1]			= (shared && i == count - 1) ? 2 : 1; // Anonymous count
+
+		for (DL::uint32 j = 0; j < grp[1]; ++j) {
+			DL::uint8* value = reinterpret_cast<DL::uint8*>(grp + 4 + j * 4);
+			value[0]		 = i == 0 ? DL::DT_Integer : DL::DT_Group;
+			if (i != 0) {
+				const DL::uint64 child = groupsBegin + (i - 1) * 32;
+				std::memcpy(value + 8, &child, sizeof(child));
+			}
+		}
+	}
+
+	const DL::uint64 top = last;
+	std::memcpy(data + size - sizeof(DL::uint64), &top, sizeof(top));
+	return buffer;
+}
+
+static bool check(const DL::BinaryContainer& binary)
+{
+	if (binary.topGroupCount() != 2)
+		return false;
+
+	DL::BinaryGroup scene	 = binary.topGroup(0);
+	DL::BinaryGroup settings = binary.topGroup(1);
+	if (scene.id() != "scene" || settings.id() != "settings")
+		return false;
+
+	// First occurrence wins, like DataGroup::getFromKey
+	if (settings.getFromKey("steps").getInt() != 128 || settings.getFromKey("samples").getNumber() != 64)
+		return false;
+	if (settings.getFromKey("unknown").isValid())
+		return false;
+
+	if (scene.getFromKey("name").getString() != "Test" || scene.anonymousCount() != 2)
+		return false;
+
+	DL::BinaryGroup obj = scene.at(0).getGroup();
+	if (obj.getFromKey("scale").getFloat() != 2.5f || !obj.getFromKey("visible").getBool()
+		|| obj.getFromKey("material").getString() != "glass")
+		return false;
+
+	DL::BinaryGroup tags = scene.getFromKey("tags").getGroup();
+	return tags.isArray() && tags.anonymousCount() == 3 && tags.at(2).getString() == "a";
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+
+	lisp.parse(TEST_FILE);
+	lisp.build(container);
+
+	// In memory
+	std::stringstream stream;
+	if (!DL::BinaryContainer::write(container, stream))
+		return -1;
+
+	const std::string content = stream.str();
+	std::vector<DL::uint64> buffer(content.size() / sizeof(DL::uint64) + 1);
+	std::memcpy(buffer.data(), content.data(), content.size());
+
+	DL::BinaryContainer binary;
+	if (!binary.load(reinterpret_cast<const char*>(buffer.data()), content.size()) || !binary.verify() || !check(binary)) {
+		std::cout << "Memory roundtrip failed" << std::endl;
+		return -1;
+	}
+
+	DL::DataContainer copy;
+	binary.toContainer(copy);
+	if (DL::DataLisp::generate(copy) != DL::DataLisp::generate(container)) {
+		std::cout << "Copy differs from original" << std::endl;
+		return -1;
+	}
+
+	// Corrupted content is rejected
+	reinterpret_cast<char*>(buffer.data())[content.size() - 1] ^= 0x7F;
+	if (binary.load(reinterpret_cast<const char*>(buffer.data()), content.size()) && binary.verify()) {
+		std::cout << "Corruption not detected" << std::endl;
+		return -1;
+	}
+
+	// Offsets wrapping around are rejected
+	{
+		std::vector<DL::uint64> crafted(8, 0);
+		const Header hdr = { { 'D', 'L', 'B', '\0' }, 1, 0x01020304, 2, sizeof(Header), 8, 0xFFFFFFFFFFFFFFF0ULL, 64 };
+		std::memcpy(crafted.data(), &hdr, sizeof(hdr));
+		if (binary.load(reinterpret_cast<const char*>(crafted.data()), 64) && binary.verify()) {
+			std::cout << "Wrapping offset not detected" << std::endl;
+			return -1;
+		}
+	}
+
+	// Deep hierarchies are copied without recursion, shared children are rejected
+	{
+		size_t size;
+		std::vector<DL::uint64> chain = makeChain(100000, false, size);
+		if (!binary.load(reinterpret_cast<const char*>(chain.data()), size) || !binary.verify()) {
+			std::cout << "Deep chain rejected" << std::endl;
+			return -1;
+		}
+
+		DL::DataContainer deep;
+		binary.toContainer(deep);
+		if (deep.getTopGroups().size() != 1 || deep.getTopGroups()[0].getAnonymousEntries().size() != 1) {
+			std::cout << "Deep chain not copied" << std::endl;
+			return -1;
+		}
+
+		chain = makeChain(16, true, size);
+		if (!binary.load(reinterpret_cast<const char*>(chain.data()), size) || binary.verify()) {
+			std::cout << "Shared child not detected" << std::endl;
+			return -1;
+		}
+	}
+
+	// Memory mapped file
+	const std::string path = "binary_test.dlb";
+	if (!DL::BinaryContainer::write(container, path) || !binary.open(path) || !binary.verify() || !check(binary)) {
+		std::cout << "File roundtrip failed" << std::endl;
+		return -1;
+	}
+	binary.close();
+	std::remove(path.c_str());
+
+	return logger.errorCount();
+}
@@ -0,0 +1,153 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "Binding.h"
+#include "DataLisp.h"
+
+namespace Test {
+struct Camera {
+	float FOV = 0;
+	std::vector<float> Position;
+};
+DL_BINDING(Camera, DL_FIELD("fov", &Camera::FOV), DL_FIELD("position", &Camera::Position))
+
+struct Object {
+	std::string Name;
+	int Count	 = 0;
+	bool Visible = false;
+	std::vector<std::string> Tags;
+};
+DL_BINDING(Object, DL_FIELD("name", &Object::Name), DL_FIELD("count", &Object::Count),
+		   DL_FIELD("visible", &Object::Visible), DL_FIELD("tags", &Object::Tags))
+
+struct Scene {
+	int Version = 0;
+	Camera View;
+	std::vector<Object> Objects;
+};
+DL_BINDING(Scene, DL_FIELD("version", &Scene::Version), DL_FIELD("camera", &Scene::View),
+		   DL_FIELD("objects", &Scene::Objects))
+} // namespace Test
+
+static_assert(DL::bindingHash("fov") == DL::bindingHash("fov", 3), "Hash not constant");
+
+static const char* SOURCE = "(scene :version 2 :unknown 1\n"
+							"  :camera (camera :fov 60 :position [0.0 1.5 2.0])\n"
+							"  :objects [(object :name \"box\" :count 3 :visible true :tags [\"a\" \"b\"])\n"
+							"            (object :name $(if true \"sphere\" \"cube\"))])\n"
+							"(other :version 3)";
+
+static bool check(const Test::Scene& scene)
+{
+	return scene.Version == 2 && scene.View.FOV == 60 && scene.View.Position.size() == 3
+		   && scene.View.Position[1] == 1.5f && scene.Objects.size() == 2
+		   && scene.Objects[0].Name == "box" && scene.Objects[0].Count == 3 && scene.Objects[0].Visible
+		   && scene.Objects[0].Tags.size() == 2 && scene.Objects[0].Tags[1] == "b"
+		   && scene.Objects[1].Name == "sphere" && !scene.Objects[1].Visible;
+}
+
+int main()
+{
+	// Bound directly from the parsed source
+	{
+		DL::SourceLogger logger;
+		DL::DataLisp lisp(&logger);
+		lisp.parse(SOURCE);
+
+		Test::Scene scene;
+		DL::Binder<Test::Scene> binder(scene, "scene");
+		lisp.build(binder);
+
+		if (binder.errorCount() != 0 || binder.boundCount() != 1 || !check(scene)) {
+			std::cout << "Binding from events failed" << std::endl;
+			return -1;
+		}
+	}
+
+	// Bound from a built container
+	{
+		DL::SourceLogger logger;
+		DL::DataLisp lisp(&logger);
+		lisp.parse(SOURCE);
+
+		DL::DataContainer container;
+		lisp.build(container);
+
+		Test::Scene scene;
+		if (!DL::bind(*container.findTopGroup("scene"), scene) || !check(scene)) {
+			std::cout << "Binding from group failed" << std::endl;
+			return -1;
+		}
+
+		std::vector<Test::Scene> all;
+		DL::bind(container, "other", all);
+		if (all.size() != 1 || all[0].Version != 3) {
+			std::cout << "Binding of top groups failed" << std::endl;
+			return -1;
+		}
+	}
+
+	// Entries with wrong types are counted
+	{
+		DL::SourceLogger logger;
+		DL::DataLisp lisp(&logger);
+		lisp.parse("(camera :fov \"wide\" :position [1.0 true 2.0])");
+
+		std::vector<Test::Camera> cameras;
+		DL::Binder<std::vector<Test::Camera>> binder(cameras, "camera");
+		lisp.build(binder);
+
+		if (binder.errorCount() != 2 || cameras.size() != 1 || cameras[0].Position.size() != 2) {
+			std::cout << "Type errors not detected" << std::endl;
+			return -1;
+		}
+	}
+
+	// The schema is applied to the events too
+	{
+		DL::DiagnosticBuffer logger;
+		DL::DataLisp lisp(&logger);
+		const DL::Schema schema("(group :id \"camera\" (key :name \"fov\" :type \"number\"))");
+		lisp.setSchema(&schema);
+		lisp.parse("(camera :fov 60) (camera :fov \"wide\") (camera :fov 90)");
+
+		std::vector<Test::Camera> cameras;
+		DL::Binder<std::vector<Test::Camera>> binder(cameras, "camera");
+		lisp.build(binder);
+
+		if (logger.errorCount() != 1 || cameras.size() != 1 || cameras[0].FOV != 60) {
+			std::cout << "Schema not applied to events" << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <cstdio>
+#include <iostream>
+
+#include "DataLisp.h"
+
+const char* TEST_FILE = "(settings :steps $(if true 128 0) :name \"cache\" (child :value 2.5))\n";
+
+static bool load(const std::string& source, bool expectCached, std::string& output)
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+	lisp.setCacheDirectory(".");
+
+	lisp.parse(source);
+	if (lisp.isCached() != expectCached) {
+		std::cout << "Expected cache " << (expectCached ? "hit" : "miss") << std::endl;
+		return false;
+	}
+
+	lisp.build(container);
+	output = DL::DataLisp::generate(container);
+	return true;
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	lisp.setCacheDirectory(".");
+
+	const std::string entry = lisp.cacheEntry(TEST_FILE);
+	std::remove(entry.c_str());
+
+	std::string original, cached;
+	if (!load(TEST_FILE, false, original) || !load(TEST_FILE, true, cached))
+		return -1;
+
+	if (original != cached) {
+		std::cout << "Cached content differs" << std::endl;
+		return -1;
+	}
+
+	// Different expressions produce a different entry
+	lisp.addExpression("custom", nullptr);
+	if (lisp.cacheEntry(TEST_FILE) == entry) {
+		std::cout << "Expressions are not part of the key" << std::endl;
+		return -1;
+	}
+
+	// As does a different cache version
+	const std::string custom = lisp.cacheEntry(TEST_FILE);
+	lisp.setCacheVersion("2");
+	if (lisp.cacheEntry(TEST_FILE) == custom) {
+		std::cout << "Cache version is not part of the key" << std::endl;
+		return -1;
+	}
+	std::remove(entry.c_str());
+
+	// Sources with errors are never cached
+	const std::string broken = "(broken :value $(unknown_expression 1))";
+	std::remove(lisp.cacheEntry(broken).c_str());
+	if (!load(broken, false, original) || !load(broken, false, original))
+		return -1;
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <cmath>
+#include <iostream>
+
+#include "DataLisp.h"
+#include "codegen_test.h"
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+	lisp.parse("(scene :camera (camera :fov 60 :position [0.0 1.0 2.0] :max_depth 8)"
+			   "       :objects [(object :name \"a\" :tag \"x\" :tag \"y\" 1 2) (object)]"
+			   "       :settings (any :a 1) :default true :extra 1)");
+	lisp.build(container);
+
+	if (logger.errorCount() != 0) {
+		std::cout << "Couldn't build container" << std::endl;
+		return -1;
+	}
+
+	const Views::Scene scene = Views::Scene::find(container);
+	if (!scene.isValid() || !scene.hasCamera() || !scene.default_()) {
+		std::cout << "Scene not bound" << std::endl;
+		return -1;
+	}
+
+	const Views::Camera camera = scene.camera();
+	if (std::abs(camera.fov() - 60.0f) > 1e-5f || camera.maxDepth() != 8
+		|| camera.positionCount() != 3 || std::abs(camera.position(2) - 2.0f) > 1e-5f) {
+		std::cout << "Invalid camera" << std::endl;
+		return -1;
+	}
+
+	// Entries out of range or of wrong type give the default value
+	if (camera.position(3, -1.0f) != -1.0f || scene.objects(2).isValid()) {
+		std::cout << "Out of range entries not handled" << std::endl;
+		return -1;
+	}
+
+	if (scene.objectsCount() != 2 || scene.objects(0).name() != "a" || scene.objects(0).tag() != "x"
+		|| scene.objects(0).anonymousCount() != 2 || scene.objects(0).anonymous(1) != 2) {
+		std::cout << "Invalid objects" << std::endl;
+		return -1;
+	}
+
+	const Views::Object empty = scene.objects(1);
+	if (!empty.isValid() || empty.hasName() || empty.name("none") != "none" || empty.anonymousCount() != 0) {
+		std::cout << "Invalid empty object" << std::endl;
+		return -1;
+	}
+
+	// Groups without definition are given as is
+	if (!scene.settings() || scene.settings()->getFromKey("a").getInt() != 1) {
+		std::cout << "Invalid settings" << std::endl;
+		return -1;
+	}
+
+	// Unbound views are empty
+	const Views::Camera unbound;
+	if (unbound.isValid() || unbound.hasFov() || unbound.fov(1.0f) != 1.0f || unbound.positionCount() != 0) {
+		std::cout << "Unbound view not empty" << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
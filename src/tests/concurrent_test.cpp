@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "DataLisp.h"
+
+constexpr int THREADS	 = 8;
+constexpr int ITERATIONS = 200;
+
+static DL::Integer sumGroup(const DL::DataGroup& grp)
+{
+	DL::Integer sum = 0;
+	for (const DL::Data& d : grp.getAnonymousEntries()) {
+		if (d.type() == DL::DT_Integer)
+			sum += d.getInt();
+		else if (d.type() == DL::DT_Group)
+			sum += sumGroup(d.getGroup());
+	}
+
+	for (const DL::Data& d : grp.getNamedEntries()) {
+		if (d.type() == DL::DT_Integer)
+			sum += d.getInt();
+		else if (d.type() == DL::DT_Group)
+			sum += sumGroup(d.getGroup());
+	}
+
+	const DL::Data* value = grp.findFromKey("value");
+	if (value && value->type() == DL::DT_Integer)
+		sum += value->getInt();
+
+	return sum;
+}
+
+static DL::Integer sumContainer(const DL::DataContainer& container)
+{
+	DL::Integer sum = 0;
+	for (const DL::DataGroup& grp : container.getTopGroups())
+		sum += sumGroup(grp);
+	return sum;
+}
+
+int main()
+{
+	std::stringstream source;
+	for (int i = 0; i < 100; ++i)
+		source << "(entry :value " << i << " [1 2 3 (inner :value " << i << ")] :sub (sub 4 5))\n";
+
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+
+	lisp.parse(source.str());
+	lisp.build(container);
+	container.freeze();
+
+	const DL::Integer expected = sumContainer(container);
+	std::atomic<int> failures(0);
+
+	std::thread threads[THREADS];
+	for (int t = 0; t < THREADS; ++t) {
+		threads[t] = std::thread([&]() {
+			for (int i = 0; i < ITERATIONS; ++i) {
+				if (sumContainer(container) != expected)
+					++failures;
+			}
+		});
+	}
+
+	for (int t = 0; t < THREADS; ++t)
+		threads[t].join();
+
+	// Copy on write of frozen groups must not affect the shared content
+	DL::DataGroup copy = container.getTopGroups().front();
+	copy.add(DL::Data("extra", DL::Integer(1000)));
+	if (!container.getTopGroups().front().isFrozen()
+		|| container.getTopGroups().front().hasKey("extra")
+		|| !copy.hasKey("extra")) {
+		std::cout << "Frozen group was modified" << std::endl;
+		return -1;
+	}
+
+	if (failures > 0) {
+		std::cout << failures << " concurrent traversals failed" << std::endl;
+		return -1;
+	}
+
+	return logger.errorCount();
+}
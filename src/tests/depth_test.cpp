@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+
+static std::string nested(int depth)
+{
+	std::string source;
+	source.reserve(depth * 8);
+	for (int i = 0; i < depth; ++i)
+		source += "(g :v ";
+	source += "1";
+	source.append(depth, ')');
+	return source;
+}
+
+int main()
+{
+	// Deep inputs are handled without recursion
+	{
+		constexpr int DEPTH = 100000;
+
+		DL::SourceLogger logger;
+		DL::DataLisp lisp(&logger);
+		lisp.setMaxDepth(DEPTH + 1);
+
+		DL::DataContainer container;
+		lisp.parse(nested(DEPTH));
+		lisp.build(container);
+
+		if (logger.errorCount() != 0 || container.getTopGroups().size() != 1) {
+			std::cout << "Deep input was not parsed" << std::endl;
+			return -1;
+		}
+
+		const std::string generated = DL::DataLisp::generate(container, DL::GM_Compact);
+		if (generated.size() < DEPTH * 2) {
+			std::cout << "Deep input was not generated" << std::endl;
+			return -1;
+		}
+	}
+
+	// The default limit stops the parser with a clean error
+	{
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+
+		DL::DataContainer container;
+		lisp.parse(nested(5000));
+		lisp.build(container);
+
+		const DL::vector_t<DL::Diagnostic> diagnostics = buffer.diagnostics();
+		if (diagnostics.empty() || diagnostics.front().Code != DL::DC_MaxDepthExceeded
+			|| diagnostics.front().message() != "Maximum nesting depth of 1024 exceeded") {
+			std::cout << "Missing depth error: " << buffer.toString() << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,114 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+#include <thread>
+
+#include "DataLisp.h"
+
+static const DL::Diagnostic* find(const DL::vector_t<DL::Diagnostic>& diagnostics, DL::DiagnosticCode code)
+{
+	for (const DL::Diagnostic& d : diagnostics) {
+		if (d.Code == code)
+			return &d;
+	}
+	return nullptr;
+}
+
+int main()
+{
+	// Build diagnostics refer to the expression
+	{
+		const std::string source = "(a :x 1\n   :y $(unknown 1 2))";
+
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+		lisp.setFileId(7);
+
+		DL::DataContainer container;
+		lisp.parse(source);
+		lisp.build(container);
+
+		const DL::vector_t<DL::Diagnostic> diagnostics = buffer.diagnostics();
+		const DL::Diagnostic* d						   = find(diagnostics, DL::DC_UnknownExpression);
+		if (!d || d->FileId != 7 || d->Line != 2 || d->Column != 7 || d->Text != "unknown"
+			|| source.substr(d->Begin, d->End - d->Begin) != "$(unknown 1 2)") {
+			std::cout << "Wrong expression diagnostic: " << buffer.toString() << std::endl;
+			return -1;
+		}
+
+		if (buffer.errorCount() != 1 || d->toString() != "7:2:7: Error: Couldn't find expression 'unknown'") {
+			std::cout << "Wrong formatting: " << d->toString() << std::endl;
+			return -1;
+		}
+	}
+
+	// Lexer and parser diagnostics carry spans
+	{
+		const std::string source = "(a :x \"open\n)";
+
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+		lisp.parse(source);
+
+		const DL::vector_t<DL::Diagnostic> diagnostics = buffer.diagnostics();
+		const DL::Diagnostic* d						   = find(diagnostics, DL::DC_UnclosedString);
+		if (!d || d->Begin != 6 || d->Text != "open" || d->message() != "The string \"open\" is not closed") {
+			std::cout << "Wrong lexer diagnostic: " << buffer.toString() << std::endl;
+			return -1;
+		}
+	}
+
+	// A single buffer can be shared by concurrent parses
+	{
+		DL::DiagnosticBuffer buffer;
+		DL::vector_t<std::thread> threads;
+		for (DL::uint32 i = 1; i <= 4; ++i) {
+			threads.emplace_back([&buffer, i]() {
+				for (int k = 0; k < 50; ++k) {
+					DL::DataLisp lisp(&buffer);
+					lisp.setFileId(i);
+
+					DL::DataContainer container;
+					lisp.parse("(a :x $(missing))");
+					lisp.build(container);
+				}
+			});
+		}
+		for (std::thread& t : threads)
+			t.join();
+
+		if (buffer.size() != 200 || buffer.errorCount() != 200) {
+			std::cout << "Diagnostics lost: " << buffer.size() << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+#include "Diff.h"
+#include "Selector.h"
+
+const char* OLD_FILE = "(renderer :steps 64 (film :width 1920 :height 1080))\n"
+					   "(scene (object :id 1) :tags [1 2])\n"
+					   "(host :name \"a\")\n"
+					   "(mixed (b) 5 (c) 6)\n";
+const char* NEW_FILE = "(renderer :steps 128 (film :width 1920 :height 720) :denoise true)\n"
+					   "(scene (object :id 1) (object :id 2) :tags [1 2])\n"
+					   "(mixed (b) 7 (c) 6 8)\n";
+
+static DL::DataContainer parse(const char* source, DL::SourceLogger& logger)
+{
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+	lisp.parse(source);
+	lisp.build(container);
+	container.freeze();
+	return container;
+}
+
+static bool has(const DL::vector_t<DL::DiffEntry>& entries, DL::DiffType type, const char* path)
+{
+	for (const DL::DiffEntry& e : entries) {
+		if (e.Type == type && e.Path == path)
+			return true;
+	}
+
+	std::cout << "Missing difference at '" << path << "'" << std::endl;
+	return false;
+}
+
+static bool same(const DL::Data& a, const DL::Data& b)
+{
+	if (a.type() != b.type())
+		return false;
+	switch (a.type()) {
+	case DL::DT_Group:
+		return a.getGroup().shares(b.getGroup());
+	case DL::DT_Integer:
+		return a.getInt() == b.getInt();
+	case DL::DT_Float:
+		return a.getFloat() == b.getFloat();
+	case DL::DT_Bool:
+		return a.getBool() == b.getBool();
+	case DL::DT_String:
+		return a.getString() == b.getString();
+	default:
+		return true;
+	}
+}
+
+// Every path has to resolve to the reported entry, in the old container if it is available there
+static bool resolves(const DL::DiffEntry& e, const DL::DataContainer& oldContainer, const DL::DataContainer& newContainer)
+{
+	DL::Selector selector;
+	if (!selector.compile(e.Path))
+		return false;
+
+	const bool removed								   = e.Type != DL::DFT_Added;
+	const DL::vector_t<DL::SelectorMatch> matches = selector.select(removed ? oldContainer : newContainer);
+	if (matches.empty())
+		return false;
+
+	// Top groups are matched without an entry
+	const DL::Data data = matches[0].Entry ? *matches[0].Entry : DL::Data(std::string(), *matches[0].Group);
+	return same(data, removed ? e.Old : e.New);
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	const DL::DataContainer oldContainer = parse(OLD_FILE, logger);
+	const DL::DataContainer newContainer = parse(NEW_FILE, logger);
+
+	const DL::vector_t<DL::DiffEntry> entries = DL::Diff::compare(oldContainer, newContainer);
+	if (entries.size() != 7
+		|| !has(entries, DL::DFT_Changed, "renderer/:steps")
+		|| !has(entries, DL::DFT_Changed, "renderer/film/:height")
+		|| !has(entries, DL::DFT_Added, "renderer/:denoise")
+		|| !has(entries, DL::DFT_Added, "scene/object[1]")
+		|| !has(entries, DL::DFT_Removed, "host")
+		|| !has(entries, DL::DFT_Changed, "mixed/[1]")
+		|| !has(entries, DL::DFT_Added, "mixed/[4]")) {
+		std::cout << "Unexpected amount of differences: " << entries.size() << std::endl;
+		return -1;
+	}
+
+	for (const DL::DiffEntry& e : entries) {
+		if (e.Path == "renderer/:steps" && (e.Old.getInt() != 64 || e.New.getInt() != 128))
+			return -1;
+
+		if (!resolves(e, oldContainer, newContainer)) {
+			std::cout << "Path '" << e.Path << "' does not resolve to the entry" << std::endl;
+			return -1;
+		}
+	}
+
+	// Identical content parsed twice is skipped by hash
+	const DL::DataContainer copy = parse(OLD_FILE, logger);
+	if (!DL::Diff::compare(oldContainer, copy).empty()
+		|| oldContainer.getTopGroups()[0].hash() != copy.getTopGroups()[0].hash())
+		return -1;
+
+	return logger.errorCount();
+}
@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include "DataLisp.h"
+
+static DL::DataContainer parse(const std::string& source, DL::SourceLogger& logger)
+{
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+
+	lisp.parse(source);
+	lisp.build(container);
+	return container;
+}
+
+static bool roundtrip(const DL::DataContainer& container, DL::GenerateMode mode)
+{
+	DL::SourceLogger logger;
+
+	const std::string source = DL::DataLisp::generate(container, mode);
+	std::stringstream stream;
+	DL::DataLisp::generate(container, stream, mode);
+	if (stream.str() != source) {
+		std::cout << "Stream output differs" << std::endl;
+		return false;
+	}
+
+	DL::DataContainer copy = parse(source, logger);
+	if (logger.errorCount() != 0 || DL::DataLisp::generate(copy, mode) != source) {
+		std::cout << "Roundtrip failed:" << std::endl
+				  << source << std::endl;
+		return false;
+	}
+
+	const DL::DataGroup& values = copy.getTopGroups()[0];
+	if (values.getFromKey("one").type() != DL::DT_Float
+		|| values.getFromKey("tenth").getFloat() != 0.1f
+		|| values.getFromKey("large").getFloat() != 1.0e20f
+		|| values.getFromKey("min").getInt() != std::numeric_limits<DL::Integer>::min()
+		|| values.getFromKey("text").getString() != "quote \" backslash \\ newline \n tab \t") {
+		std::cout << "Values changed:" << std::endl
+				  << source << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+int main()
+{
+	DL::DataGroup values("values");
+	values.add(DL::Data("one", 1.0f));
+	values.add(DL::Data("tenth", 0.1f));
+	values.add(DL::Data("large", 1.0e20f));
+	values.add(DL::Data("min", std::numeric_limits<DL::Integer>::min()));
+	values.add(DL::Data("text", std::string("quote \" backslash \\ newline \n tab \t")));
+
+	DL::DataGroup array;
+	array.add(DL::Data("", DL::Integer(1)));
+	array.add(DL::Data("", true));
+	values.add(DL::Data("array", array));
+
+	DL::DataContainer container;
+	container.addTopGroup(values);
+
+	if (!roundtrip(container, DL::GM_Pretty) || !roundtrip(container, DL::GM_Compact))
+		return -1;
+
+	const std::string compact = DL::DataLisp::generate(container, DL::GM_Compact);
+	if (compact.find('\n') != compact.size() - 1) {
+		std::cout << "Compact output spans multiple lines" << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
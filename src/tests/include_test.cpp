@@ -0,0 +1,142 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "Data.h"
+#include "DiagnosticBuffer.h"
+#include "FileLoader.h"
+
+class CaptureLogger : public DL::SourceLogger {
+public:
+	void log(DL::line_t line, DL::column_t column, DL::Level level, const DL::string_t& str) override
+	{
+		DL::SourceLogger::log(line, column, level, str);
+		Messages += str + "\n";
+	}
+
+	DL::string_t Messages;
+};
+
+static void write(const char* path, const char* content)
+{
+	std::ofstream out(path);
+	out << content;
+}
+
+static bool check(const DL::DataContainer& container, const char* ids)
+{
+	std::string actual;
+	for (const DL::DataGroup& grp : container.getTopGroups())
+		actual += grp.id() + " ";
+
+	if (actual != ids) {
+		std::cout << "Expected '" << ids << "' but got '" << actual << "'" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main()
+{
+	write("inc_root.dl", "(first :v 1)\n(include \"inc_a.dl\" \"inc_b.dl\")\n(last :v 4)\n");
+	write("inc_a.dl", "(a :v 2)\n");
+	write("inc_b.dl", "(b :v 3)\n(include \"inc_a.dl\")\n");
+	write("inc_cycle1.dl", "(include \"inc_cycle2.dl\")\n");
+	write("inc_cycle2.dl", "(x)\n(include \"inc_cycle1.dl\")\n");
+	write("inc_broken.dl", "(include \"inc_a.dl\")\n(y :v $)\n");
+
+	int result = 0;
+	{
+		CaptureLogger logger;
+		DL::FileLoader loader(&logger);
+		loader.setThreadCount(4);
+
+		DL::DataContainer container;
+		if (!loader.load("inc_root.dl", container) || !check(container, "first a b last ") || loader.parsedFileCount() != 3)
+			result = -1;
+
+		// Unchanged files are not parsed again
+		DL::DataContainer cached;
+		if (!loader.load("inc_root.dl", cached) || !check(cached, "first a b last ") || loader.parsedFileCount() != 0)
+			result = -1;
+
+		DL::DataContainer cycle;
+		if (loader.load("inc_cycle1.dl", cycle) || !check(cycle, "x ")
+			|| logger.Messages.find("inc_cycle2.dl:2 -> ") == std::string::npos) {
+			std::cout << "Cycle not reported: " << logger.Messages << std::endl;
+			result = -1;
+		}
+
+		DL::DataContainer missing;
+		if (loader.load("inc_missing.dl", missing))
+			result = -1;
+	}
+
+	// Repeated includes are expanded once, otherwise this chain of diamonds would produce 2^24 groups
+	{
+		for (int i = 0; i <= 24; ++i) {
+			const std::string next = "inc_d" + std::to_string(i + 1) + ".dl";
+			const std::string body = i < 24 ? "(d)\n(include \"" + next + "\" \"" + next + "\")\n" : "(d)\n";
+			write(("inc_d" + std::to_string(i) + ".dl").c_str(), body.c_str());
+		}
+
+		DL::SourceLogger logger;
+		DL::FileLoader loader(&logger);
+		DL::DataContainer diamonds;
+		if (!loader.load("inc_d0.dl", diamonds) || diamonds.getTopGroups().size() != 25) {
+			std::cout << "Repeated includes expanded multiple times" << std::endl;
+			result = -1;
+		}
+
+		for (int i = 0; i <= 24; ++i)
+			std::remove(("inc_d" + std::to_string(i) + ".dl").c_str());
+	}
+
+	// Diagnostics keep their code and refer to the file by id
+	{
+		DL::DiagnosticBuffer logger;
+		DL::FileLoader loader(&logger);
+
+		DL::DataContainer broken;
+		const DL::vector_t<DL::Diagnostic> diagnostics = (loader.load("inc_broken.dl", broken), logger.diagnostics());
+		if (diagnostics.empty() || diagnostics[0].Code == DL::DC_Message
+			|| diagnostics[0].Line != 2 || loader.filePath(diagnostics[0].FileId).find("inc_broken.dl") == std::string::npos) {
+			std::cout << "Diagnostic of included file lost: " << logger.toString() << std::endl;
+			result = -1;
+		}
+	}
+
+	for (const char* path : { "inc_root.dl", "inc_a.dl", "inc_b.dl", "inc_cycle1.dl", "inc_cycle2.dl", "inc_broken.dl" })
+		std::remove(path);
+
+	return result;
+}
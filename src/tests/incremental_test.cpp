@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+#include "IncrementalDocument.h"
+
+const char* TEST_FILE = "(first :value 1)\n"
+						"; Comment with (unbalanced parentheses\n"
+						"(second :value \"text with ) inside\")\n"
+						"(third :value [1 2 3])\n";
+
+static bool check(const DL::IncrementalDocument& doc, size_t reparsed, DL::Integer firstValue)
+{
+	const auto& groups = doc.container().getTopGroups();
+	if (doc.reparsedCount() != reparsed) {
+		std::cout << "Expected " << reparsed << " reparsed statements but got " << doc.reparsedCount() << std::endl;
+		return false;
+	}
+
+	if (groups.size() != 3 || groups[0].id() != "first" || groups[1].id() != "second" || groups[2].id() != "third") {
+		std::cout << "Unexpected groups" << std::endl;
+		return false;
+	}
+
+	if (groups[0].getFromKey("value").getInt() != firstValue) {
+		std::cout << "Unexpected value" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::IncrementalDocument doc(&logger);
+
+	doc.setSource(TEST_FILE);
+	if (doc.statementCount() != 3 || !check(doc, 3, 1))
+		return -1;
+
+	// Same source, nothing to do
+	doc.setSource(TEST_FILE);
+	if (!check(doc, 0, 1))
+		return -1;
+
+	// Change first statement only
+	doc.applyEdit(14, 1, "42");
+	if (!check(doc, 1, 42))
+		return -1;
+
+	// Insert whitespace, all statements move but none changes
+	doc.applyEdit(0, 0, "\n\n");
+	if (!check(doc, 0, 42))
+		return -1;
+
+	return logger.errorCount();
+}
@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+
+const char* TEST_FILE = "(camera :fov 45)\n"
+						"(environment :steps 64)\n"
+						"(camera :fov 60)\n";
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+
+	lisp.parse(TEST_FILE);
+	lisp.build(container);
+
+	const DL::DataGroup* env = container.findTopGroup("environment");
+	if (!env || env->getFromKey("steps").getInt() != 64 || container.findTopGroup("unknown"))
+		return -1;
+
+	// Groups added after a lookup are indexed on the next one
+	DL::DataGroup camera("camera");
+	camera.add(DL::Data("fov", DL::Integer(90)));
+	container.addTopGroup(camera);
+
+	DL::vector_t<const DL::DataGroup*> cameras = container.findAllTopGroups("camera");
+	if (cameras.size() != 3 || cameras[0]->getFromKey("fov").getInt() != 45
+		|| cameras[2]->getFromKey("fov").getInt() != 90) {
+		std::cout << "Unexpected cameras" << std::endl;
+		return -1;
+	}
+
+	container.freeze();
+	if (container.findTopGroup("camera") != &container.getTopGroups()[0])
+		return -1;
+
+	return logger.errorCount();
+}
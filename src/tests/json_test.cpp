@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+#include <sstream>
+
+#include "DataLisp.h"
+#include "Json.h"
+
+const char* TEST_FILE = "(scene :name \"Test \\\"quoted\\\"\"\n"
+						"  (object :id 1 :scale 2.5 :visible true)\n"
+						"  (object :id 2 :scale 1.0 :visible false)\n"
+						"  :tags [\"a\" \"b\"] :empty [])\n"
+						"(settings :steps 128 :steps 256)\n";
+
+static bool roundtrip(const DL::DataContainer& container, DL::GenerateMode mode)
+{
+	DL::SourceLogger logger;
+
+	std::stringstream stream;
+	DL::Json::write(container, stream, mode);
+	if (stream.str() != DL::Json::write(container, mode)) {
+		std::cout << "Stream output differs" << std::endl;
+		return false;
+	}
+
+	DL::DataContainer copy;
+	if (!DL::Json::read(stream, copy, &logger)
+		|| DL::DataLisp::generate(copy) != DL::DataLisp::generate(container)) {
+		std::cout << "Roundtrip failed:" << std::endl
+				  << stream.str() << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+
+	lisp.parse(TEST_FILE);
+	lisp.build(container);
+
+	if (!roundtrip(container, DL::GM_Compact) || !roundtrip(container, DL::GM_Pretty))
+		return -1;
+
+	// Plain JSON keyed by group id
+	DL::DataContainer plain;
+	if (!DL::Json::read("{\"config\": {\"path\": \"a\\u00e4\\ud83d\\ude00\", \"big\": 1e3, \"list\": [1, null, 2]}}", plain, &logger))
+		return -1;
+
+	const DL::DataGroup& config = plain.getTopGroups()[0];
+	if (config.id() != "config" || config.getFromKey("path").getString() != "a\xC3\xA4\xF0\x9F\x98\x80"
+		|| config.getFromKey("big").type() != DL::DT_Float
+		|| config.getFromKey("list").getGroup().anonymousCount() != 2) {
+		std::cout << "Unexpected plain JSON content" << std::endl;
+		return -1;
+	}
+
+	// Output of datalisp2json with anonymous entries keyed by index
+	DL::DataContainer python;
+	if (!DL::Json::read("{\"scene\": {\"name\": \"a\", \"0\": 1, \"1\": {\"0\": true, \"1\": 2.5}, \"2\": \"x\", \"__id__\": \"scene\"}}", python, &logger))
+		return -1;
+
+	const DL::DataGroup& scene = python.getTopGroups()[0];
+	if (scene.id() != "scene" || scene.getFromKey("name").getString() != "a"
+		|| scene.anonymousCount() != 3 || scene.at(0).getInt() != 1
+		|| !scene.at(1).getGroup().isArray() || scene.at(1).getGroup().anonymousCount() != 2
+		|| scene.at(2).getString() != "x") {
+		std::cout << "Unexpected datalisp2json content" << std::endl;
+		return -1;
+	}
+
+	// Integer keys stay named entries
+	{
+		DL::DataContainer source;
+		lisp.reset();
+		lisp.parse("(g :0 \"a\" :1 \"b\" :2 [:0 1])");
+		lisp.build(source);
+
+		DL::DataContainer copy;
+		if (!DL::Json::read(DL::Json::write(source), copy, &logger))
+			return -1;
+
+		const DL::DataGroup& g = copy.getTopGroups()[0];
+		if (g.anonymousCount() != 0 || g.getFromKey("0").getString() != "a" || g.getFromKey("1").getString() != "b"
+			|| g.getFromKey("2").getGroup().getFromKey("0").getInt() != 1) {
+			std::cout << "Integer keys not kept" << std::endl;
+			return -1;
+		}
+	}
+
+	// Malformed input is rejected
+	DL::SourceLogger errorLogger;
+	DL::DataContainer broken;
+	if (DL::Json::read("[{\"__id__\": \"a\", \"x\": [1, 2}]", broken, &errorLogger) || errorLogger.errorCount() != 1) {
+		std::cout << "Malformed input accepted" << std::endl;
+		return -1;
+	}
+
+	return logger.errorCount();
+}
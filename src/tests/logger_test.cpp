@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+#include "VM.h"
+
+class CountingLogger : public DL::SourceLogger {
+public:
+	int Output = 0;
+	DL::string_t Last;
+
+	void log(DL::line_t, DL::column_t, DL::Level level, const DL::string_t& str) override
+	{
+		log(level, str);
+	}
+
+	void log(DL::Level level, const DL::string_t& str) override
+	{
+		count(level);
+		if (enabled(level)) {
+			++Output;
+			Last = str;
+		}
+	}
+};
+
+int main()
+{
+	// Suppressed messages are counted, but never formatted
+	{
+		CountingLogger logger;
+		logger.setMinimumLevel(DL::L_Error);
+
+		bool formatted = false;
+		logger.logLazy(DL::L_Warning, [&]() {
+			formatted = true;
+			return DL::string_t("warning");
+		});
+
+		if (formatted || logger.Output != 0 || logger.warningCount() != 1) {
+			std::cout << "Suppressed warning was formatted or not counted" << std::endl;
+			return -1;
+		}
+
+		logger.logLazy(1, 2, DL::L_Error, []() { return DL::string_t("error"); });
+		if (logger.Output != 1 || logger.errorCount() != 1)
+			return -1;
+	}
+
+	std::string source = "(values";
+	for (int i = 0; i < 100; ++i)
+		source += " $(tofloat " + std::to_string(i) + ")";
+	source += ")";
+
+	{
+		CountingLogger logger;
+		logger.setRepeatLimit(3);
+
+		DL::DataLisp lisp(&logger);
+		lisp.addExpression("tofloat", [](const DL::vector_t<DL::Data>& args, DL::VM& vm) {
+			return vm.castTo(args.front(), DL::DT_Float);
+		});
+
+		DL::DataContainer container;
+		lisp.parse(source);
+		lisp.build(container);
+
+		// Three warnings and the summary after building
+		if (logger.warningCount() != 100 || logger.Output != 4
+			|| logger.Last != "Suppressed 97 repetitions of: Implicit conversion from 'Integer' to 'Float'") {
+			std::cout << "Repeated warnings not aggregated: " << logger.Output << " " << logger.Last << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+
+const char* DEFAULTS = "(renderer :steps 64 :samples 16 (film :width 1920 :height 1080) (pass :name \"beauty\"))\n"
+					   "(scene (object :id 1))\n";
+const char* OVERRIDES = "(renderer :steps 128 (film :width 3840) :denoise true (pass :name \"depth\"))\n"
+						"(host :name \"render01\")\n";
+
+static DL::DataContainer parse(const char* source, DL::SourceLogger& logger)
+{
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+	lisp.parse(source);
+	lisp.build(container);
+	container.freeze();
+	return container;
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	const DL::DataContainer base	  = parse(DEFAULTS, logger);
+	const DL::DataContainer overrides = parse(OVERRIDES, logger);
+
+	const DL::DataContainer result = DL::DataContainer::overlay(base, overrides);
+	const auto& groups			   = result.getTopGroups();
+	if (groups.size() != 3 || groups[0].id() != "renderer" || groups[1].id() != "scene" || groups[2].id() != "host") {
+		std::cout << "Unexpected top groups" << std::endl;
+		return -1;
+	}
+
+	const DL::DataGroup& renderer = groups[0];
+	if (renderer.getFromKey("steps").getInt() != 128 || renderer.getFromKey("samples").getInt() != 16
+		|| !renderer.getFromKey("denoise").getBool() || renderer.anonymousCount() != 2
+		|| renderer.at(0).getGroup().getFromKey("width").getInt() != 3840
+		|| renderer.at(0).getGroup().getFromKey("height").getInt() != 1080) {
+		std::cout << "Unexpected renderer" << std::endl;
+		return -1;
+	}
+
+	// Unchanged groups are shared, not copied
+	if (groups[1].referenceCount() < 2 || base.getTopGroups()[1].at(0).getGroup().referenceCount() < 2) {
+		std::cout << "Unchanged groups were copied" << std::endl;
+		return -1;
+	}
+
+	// The inputs stay untouched
+	if (base.getTopGroups()[0].getFromKey("steps").getInt() != 64 || base.getTopGroups()[0].anonymousCount() != 2)
+		return -1;
+
+	// Repeated keys and ids in the overrides are applied in order, also without frozen inputs
+	{
+		DL::DataLisp lisp(&logger);
+		DL::DataContainer mutableBase;
+		lisp.parse("(a :x 1 (p :v 1))");
+		lisp.build(mutableBase);
+
+		DL::DataLisp lisp2(&logger);
+		DL::DataContainer repeated;
+		lisp2.parse("(a :x 2 :x 3 (p :w 2) (p :u 3) (q :v 1) (q :v 2)) (b :y 1) (b :y 2)");
+		lisp2.build(repeated);
+
+		const DL::DataContainer merged = DL::DataContainer::overlay(mutableBase, repeated);
+		const auto& top				   = merged.getTopGroups();
+		if (top.size() != 2 || top[0].getFromKey("x").getInt() != 3 || top[0].anonymousCount() != 2
+			|| top[0].at(0).getGroup().getFromKey("v").getInt() != 1 || top[0].at(0).getGroup().getFromKey("u").getInt() != 3
+			|| top[0].at(1).getGroup().getFromKey("v").getInt() != 2 || top[1].getFromKey("y").getInt() != 2) {
+			std::cout << "Repeated overrides not merged" << std::endl;
+			return -1;
+		}
+	}
+
+	return logger.errorCount();
+}
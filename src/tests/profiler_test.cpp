@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+
+int main()
+{
+	const std::string source = "(a :x $(if $(not false) 1 0)\n"
+							   "   :y $(if true 2 0))";
+
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::ExpressionProfiler profiler;
+	lisp.setProfiler(&profiler);
+
+	DL::DataContainer container;
+	lisp.parse(source);
+	lisp.build(container);
+
+	if (logger.errorCount() != 0)
+		return -1;
+
+	// Each call site is recorded separately
+	const DL::vector_t<DL::ProfileEntry>& entries = profiler.entries();
+	if (entries.size() != 3) {
+		std::cout << "Expected 3 call sites but got " << entries.size() << std::endl;
+		return -1;
+	}
+
+	const DL::ProfileEntry& outer = entries[0];
+	const DL::ProfileEntry& inner = entries[1];
+	const DL::ProfileEntry& other = entries[2];
+	if (outer.Name != "if" || outer.Line != 1 || outer.Column != 7
+		|| inner.Name != "not" || inner.Line != 1 || inner.Column != 12
+		|| other.Name != "if" || other.Line != 2 || other.Column != 7) {
+		std::cout << "Wrong call sites" << std::endl
+				  << profiler.flatProfile();
+		return -1;
+	}
+
+	if (outer.Calls != 1 || outer.TotalTime < inner.TotalTime || outer.TotalTime < outer.SelfTime) {
+		std::cout << "Wrong times" << std::endl
+				  << profiler.flatProfile();
+		return -1;
+	}
+
+	const std::string stacks = profiler.collapsedStacks();
+	if (stacks.find("if@1:7;not@1:12 ") == std::string::npos || stacks.find("\nif@2:7 ") == std::string::npos) {
+		std::cout << "Wrong stacks" << std::endl
+				  << stacks;
+		return -1;
+	}
+
+	// Calls are accumulated per call site
+	lisp.build(container);
+	if (profiler.entries().size() != 3 || profiler.entries()[0].Calls != 2)
+		return -1;
+
+	return 0;
+}
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+
+int main()
+{
+	// Every broken statement reports a single error, the others are kept
+	{
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+
+		DL::DataContainer container;
+		lisp.parse("(a :x 1 foo :y 2)\n"
+				   "(b [1 2)\n"
+				   "(c :z)\n"
+				   "junk\n"
+				   "(d :ok true)");
+		lisp.build(container);
+
+		const DL::vector_t<DL::Diagnostic> diagnostics = buffer.diagnostics();
+		if (diagnostics.size() != 4 || diagnostics[1].Line != 2 || diagnostics[2].Line != 3) {
+			std::cout << "Wrong diagnostics: " << buffer.toString() << std::endl;
+			return -1;
+		}
+
+		const DL::DataGroup* d = container.findTopGroup("d");
+		if (container.getTopGroups().size() != 4 || !d || !d->getFromKey("ok").getBool()
+			|| container.findTopGroup("a")->getFromKey("x").getInt() != 1) {
+			std::cout << "Statements after errors are missing" << std::endl;
+			return -1;
+		}
+	}
+
+	// A missing name does not keep the name of a reused node
+	{
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+
+		DL::DataContainer first;
+		lisp.parse("(stale :x 1) (c :e $(not false))");
+		lisp.build(first);
+
+		lisp.reset();
+		buffer.clear();
+
+		DL::DataContainer second;
+		lisp.parse("(:x 2) (c :e $( false))");
+		lisp.build(second);
+
+		for (const DL::DataGroup& grp : second.getTopGroups()) {
+			if (grp.id() == "stale") {
+				std::cout << "Name of a previous document was kept" << std::endl;
+				return -1;
+			}
+		}
+
+		const DL::DataGroup* c = second.findTopGroup("c");
+		if (c && c->getFromKey("e").type() == DL::DT_Bool) {
+			std::cout << "Expression of a previous document was kept" << std::endl;
+			return -1;
+		}
+	}
+
+	// The count of reported errors is limited
+	{
+		std::string source;
+		for (int i = 0; i < 1000; ++i)
+			source += "(a foo)";
+
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+		lisp.setMaxErrors(10);
+		lisp.parse(source);
+
+		const DL::vector_t<DL::Diagnostic> diagnostics = buffer.diagnostics();
+		if (diagnostics.size() != 11 || diagnostics.back().Code != DL::DC_TooManyErrors) {
+			std::cout << "Error limit not applied: " << diagnostics.size() << std::endl;
+			return -1;
+		}
+	}
+
+	// Large malformed sources are skipped in a single pass
+	{
+		std::string source;
+		for (int i = 0; i < 200000; ++i)
+			source += "(a [( ] $(f ) :";
+
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+		lisp.setMaxErrors(1000000);
+		lisp.parse(source);
+
+		if (buffer.errorCount() == 0) {
+			std::cout << "Malformed source was accepted" << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+#include <sstream>
+
+#include "DataLisp.h"
+
+static DL::Data one_func(const DL::vector_t<DL::Data>&, DL::VM&)
+{
+	return DL::Data("", DL::Integer(1));
+}
+
+static DL::Data two_func(const DL::vector_t<DL::Data>&, DL::VM&)
+{
+	return DL::Data("", DL::Integer(2));
+}
+
+int main()
+{
+	// Large registry to exercise the perfect hash table
+	auto registry = std::make_shared<DL::ExpressionRegistry>();
+	registry->addStandardLibrary();
+	for (int i = 0; i < 1000; ++i) {
+		std::stringstream stream;
+		stream << "func" << i;
+		registry->add(stream.str(), (i % 2) ? one_func : two_func);
+	}
+	registry->freeze();
+
+	for (int i = 0; i < 1000; ++i) {
+		std::stringstream stream;
+		stream << "func" << i;
+		if (registry->find(stream.str()) != ((i % 2) ? one_func : two_func)) {
+			std::cout << "Lookup of " << stream.str() << " failed" << std::endl;
+			return -1;
+		}
+	}
+
+	if (registry->find("func1000") || registry->find("") || !registry->find("if")) {
+		std::cout << "Invalid lookup result" << std::endl;
+		return -1;
+	}
+
+	// Instance overlay takes precedence over the shared registry
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger, registry);
+	lisp.addExpression("func1", two_func);
+
+	DL::DataContainer container;
+	lisp.parse("(test :a $(func1) :b $(func3) :c $(if true 3))");
+	lisp.build(container);
+
+	const DL::DataGroup& grp = container.getTopGroups().front();
+	if (grp.getFromKey("a").getInt() != 2
+		|| grp.getFromKey("b").getInt() != 1
+		|| grp.getFromKey("c").getInt() != 3) {
+		std::cout << "Invalid build result" << std::endl;
+		return -1;
+	}
+
+	return logger.errorCount();
+}
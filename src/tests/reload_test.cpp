@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "ConfigHandle.h"
+#include "DataLisp.h"
+
+constexpr int READERS = 4;
+constexpr int RELOADS = 50;
+
+static void reloaded(const DL::ReloadInfo& info, void* userData)
+{
+	if (info.Success)
+		++*reinterpret_cast<std::atomic<int>*>(userData);
+}
+
+static std::string makeSource(int version)
+{
+	std::stringstream stream;
+	stream << "(config :version " << version << " :copy " << version << ")";
+	return stream.str();
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::ConfigHandle handle(&logger);
+
+	std::atomic<int> published(0);
+	handle.setReloadCallback(reloaded, &published);
+
+	std::atomic<bool> done(false);
+	std::atomic<int> failures(0);
+
+	std::thread readers[READERS];
+	for (int t = 0; t < READERS; ++t) {
+		readers[t] = std::thread([&]() {
+			DL::ConfigHandle::Reader reader(handle);
+			DL::Integer last = 0;
+			while (!done) {
+				const DL::DataContainer& config = reader.get();
+				if (config.getTopGroups().empty())
+					continue;
+
+				const DL::DataGroup& grp = config.getTopGroups().front();
+				const DL::Data* version	 = grp.findFromKey("version");
+				const DL::Data* copy	 = grp.findFromKey("copy");
+
+				// Versions have to be consistent and monotonic
+				if (!version || !copy || version->getInt() != copy->getInt() || version->getInt() < last)
+					++failures;
+				else
+					last = version->getInt();
+			}
+		});
+	}
+
+	for (int i = 1; i <= RELOADS; ++i) {
+		if (!handle.reloadAsync(makeSource(i)).get())
+			++failures;
+	}
+
+	// Invalid sources must not replace the current snapshot
+	if (handle.reload("(config :version $(unknown))"))
+		++failures;
+
+	done = true;
+	for (int t = 0; t < READERS; ++t)
+		readers[t].join();
+
+	if (handle.version() != RELOADS || published != RELOADS
+		|| handle.snapshot()->getTopGroups().front().getFromKey("version").getInt() != RELOADS) {
+		std::cout << "Unexpected final state" << std::endl;
+		return -1;
+	}
+
+	if (failures > 0) {
+		std::cout << failures << " failures" << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+
+const char* TEST_FILE_1 = "(first :value 1 (inner 2 3))";
+const char* TEST_FILE_2 = "(second :value 2.0 [4 5 6])";
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::Statistics stats;
+	lisp.setStatistics(&stats);
+
+	for (int i = 0; i < 4; ++i) {
+		const bool even = (i % 2) == 0;
+		DL::DataContainer container;
+
+		const DL::uint64 allocations = stats.NodeAllocations;
+		lisp.reset();
+		lisp.parse(even ? TEST_FILE_1 : TEST_FILE_2);
+		lisp.build(container);
+
+		// Once both shapes were parsed, all nodes are recycled
+		if (i == 0 && stats.NodeAllocations == 0) {
+			std::cout << "No nodes allocated in the first run" << std::endl;
+			return -1;
+		} else if (i >= 2 && stats.NodeAllocations != allocations) {
+			std::cout << "Nodes were allocated in run " << i << std::endl;
+			return -1;
+		}
+
+		if (container.getTopGroups().size() != 1) {
+			std::cout << "Unexpected amount of groups in run " << i << std::endl;
+			return -1;
+		}
+
+		const DL::DataGroup& grp = container.getTopGroups().front();
+		if (grp.id() != (even ? "first" : "second")
+			|| grp.getFromKey("value").type() != (even ? DL::DT_Integer : DL::DT_Float)
+			|| grp.anonymousCount() != 1) {
+			std::cout << "Unexpected content in run " << i << std::endl;
+			return -1;
+		}
+	}
+
+	lisp.releaseMemory();
+	return logger.errorCount();
+}
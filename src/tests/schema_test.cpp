@@ -0,0 +1,148 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+
+static const char* SCHEMA = "(schema :strict true :required [\"scene\"])"
+							"(group :id \"scene\""
+							" (key :name \"camera\" :type \"group\" :group \"camera\" :required true)"
+							" (key :name \"objects\" :type \"array\" :element \"group\" :group \"object\"))"
+							"(group :id \"camera\""
+							" (key :name \"fov\" :type \"number\" :required true)"
+							" (key :name \"position\" :type \"array\" :element \"float\"))"
+							"(group :id \"object\""
+							" (key :name \"name\" :type \"string\")"
+							" (anonymous :type \"integer\"))";
+
+static bool hasViolation(const DL::vector_t<DL::Diagnostic>& diagnostics, DL::DiagnosticCode code, const std::string& path)
+{
+	for (const DL::Diagnostic& d : diagnostics) {
+		if (d.Code == code && d.Path == path)
+			return true;
+	}
+	return false;
+}
+
+int main()
+{
+	DL::DiagnosticBuffer schemaLog;
+	const DL::Schema schema(SCHEMA, &schemaLog);
+	if (!schema.isValid()) {
+		std::cout << "Schema not compiled: " << schemaLog.toString() << std::endl;
+		return -1;
+	}
+
+	// A valid container
+	{
+		DL::SourceLogger logger;
+		DL::DataLisp lisp(&logger);
+		lisp.setSchema(&schema);
+
+		DL::DataContainer container;
+		lisp.parse("(scene :camera (camera :fov 60 :position [0.0 1.0 2.0])"
+				   "       :objects [(object :name \"a\" 1 2) (object)])");
+		lisp.build(container);
+
+		if (logger.errorCount() != 0 || container.getTopGroups().size() != 1) {
+			std::cout << "Valid container rejected" << std::endl;
+			return -1;
+		}
+	}
+
+	// All violations are reported with their path
+	{
+		DL::SourceLogger logger;
+		DL::DataLisp lisp(&logger);
+
+		DL::DataContainer container;
+		lisp.parse("(scene :camera (camera :position [0.0 1])"
+				   "       :objects [(object :name 1 :color \"red\" 1.5) (camera :fov 1)])"
+				   "(unknown)");
+		lisp.build(container);
+
+		DL::DiagnosticBuffer buffer;
+		if (schema.validate(container, &buffer)) {
+			std::cout << "Invalid container accepted" << std::endl;
+			return -1;
+		}
+
+		const DL::vector_t<DL::Diagnostic> violations = buffer.diagnostics();
+		if (violations.size() != 7
+			|| !hasViolation(violations, DL::DC_SchemaMissingKey, "scene/:camera")
+			|| !hasViolation(violations, DL::DC_SchemaInvalidType, "scene/:camera/:position/[1]")
+			|| !hasViolation(violations, DL::DC_SchemaInvalidType, "scene/:objects/[0]/:name")
+			|| !hasViolation(violations, DL::DC_SchemaUnknownKey, "scene/:objects/[0]")
+			|| !hasViolation(violations, DL::DC_SchemaInvalidType, "scene/:objects/[0]/[0]")
+			|| !hasViolation(violations, DL::DC_SchemaInvalidGroup, "scene/:objects/[1]")
+			|| !hasViolation(violations, DL::DC_SchemaUnknownGroup, "unknown")) {
+			std::cout << "Wrong violations:" << std::endl
+					  << buffer.toString() << std::endl;
+			return -1;
+		}
+	}
+
+	// Streaming validation stops the build at the first invalid top group
+	{
+		DL::DiagnosticBuffer buffer;
+		DL::DataLisp lisp(&buffer);
+		lisp.setSchema(&schema);
+
+		DL::DataContainer container;
+		lisp.parse("(scene :camera (camera :fov \"wide\")) (scene :camera (camera :fov 1))");
+		lisp.build(container);
+
+		if (!container.getTopGroups().empty() || buffer.size() != 1
+			|| buffer.diagnostics().front().message() != "'scene/:camera/:fov': Expected 'Number' but got 'String'") {
+			std::cout << "Build not stopped: " << buffer.toString() << std::endl;
+			return -1;
+		}
+	}
+
+	// Moved-from schemas stay usable
+	{
+		DL::Schema source(schema);
+		DL::Schema moved(std::move(source));
+		if (!moved.isValid() || source.isValid() || !source.groups().empty()) {
+			std::cout << "Unexpected state after move" << std::endl;
+			return -1;
+		}
+
+		DL::Schema assigned;
+		assigned = std::move(moved);
+		moved	 = schema;
+		if (!assigned.isValid() || !moved.isValid() || !source.compile(SCHEMA, &schemaLog) || !source.isValid()) {
+			std::cout << "Moved-from schema not reusable" << std::endl;
+			return -1;
+		}
+	}
+
+	return 0;
+}
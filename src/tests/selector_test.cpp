@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+
+#include "DataLisp.h"
+#include "Selector.h"
+
+const char* TEST_FILE = "(environment :steps 64)\n"
+						"(scene\n"
+						"  (object :id 1 :visible true :material \"glass\")\n"
+						"  (object :id 2 :visible false :material \"wood\")\n"
+						"  (light (camera :fov 45))\n"
+						"  :tags [\"a\" \"b\"])\n"
+						"(camera :fov 60)\n"
+						"(big :k0 0 :k1 1 :k2 2 :k3 3 :k4 4 :k5 5 :k6 6 :k7 7 :k8 8 :k3 33)\n";
+
+static bool expect(const DL::DataContainer& container, const char* path, size_t count)
+{
+	DL::Selector selector(path);
+	const DL::vector_t<DL::SelectorMatch> results = selector.select(container);
+	if (!selector.isValid() || results.size() != count) {
+		std::cout << "Path '" << path << "' returned " << results.size() << " instead of " << count << " matches" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+int main()
+{
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::DataContainer container;
+
+	lisp.parse(TEST_FILE);
+	lisp.build(container);
+	container.freeze();
+
+	if (!expect(container, "environment/:steps", 1)
+		|| !expect(container, "scene/object[*]/:material", 2)
+		|| !expect(container, "scene/object[1]/:material", 1)
+		|| !expect(container, "scene/object[:visible=true]", 1)
+		|| !expect(container, "scene/object[:id=2.0]/:material", 1)
+		|| !expect(container, "scene/*", 3)
+		|| !expect(container, "scene/:tags/[*]", 2)
+		|| !expect(container, "//camera", 2)
+		|| !expect(container, "//:fov", 2)
+		|| !expect(container, "scene//camera/:fov", 1)
+		|| !expect(container, "unknown/:steps", 0))
+		return -1;
+
+	// Results point directly into the container
+	DL::Selector material("scene/object[:id=2]/:material");
+	const DL::Data* d = material.first(container);
+	if (!d || d->getString() != "wood" || d != container.getTopGroups()[1].getAnonymousEntries()[1].getGroup().findFromKey("material")) {
+		std::cout << "Unexpected result" << std::endl;
+		return -1;
+	}
+
+	// Large frozen groups use the key index, the first occurrence wins
+	const DL::Data* k3 = DL::Selector("big/:k3").first(container);
+	if (!k3 || k3->getInt() != 3 || DL::Selector("big/:k9").first(container)) {
+		std::cout << "Key index lookup failed" << std::endl;
+		return -1;
+	}
+
+	// Relative to a group
+	DL::vector_t<DL::SelectorMatch> results;
+	DL::Selector("object/:id").evaluate(container.getTopGroups()[1], results);
+	if (results.size() != 2 || results[1].Entry->getInt() != 2)
+		return -1;
+
+	// Syntax errors
+	DL::SourceLogger errorLogger;
+	if (DL::Selector("scene/object[", &errorLogger).isValid() || DL::Selector("", &errorLogger).isValid()
+		|| DL::Selector("scene/[:a=]", &errorLogger).isValid() || errorLogger.errorCount() != 3)
+		return -1;
+
+	return logger.errorCount();
+}
@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2014-2020, OEmercan Yazici <omercan AT pearcoding.eu>
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright owner may be used
+to endorse or promote products derived from this software without
+specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE
+*/
+#include <iostream>
+#include <sstream>
+
+#include "DataLisp.h"
+
+int main()
+{
+	const std::string source = "(scene :name \"test\" :count 3 :scale 1.5 :visible true\n"
+							   "  (object :id $(if true 1 0)) (object :id $(if false 1 0)) [1 2 3])";
+
+	DL::SourceLogger logger;
+	DL::DataLisp lisp(&logger);
+	DL::Statistics stats;
+	lisp.setStatistics(&stats);
+
+	DL::DataContainer container;
+	lisp.parse(source);
+	lisp.build(container);
+
+	if (logger.errorCount() != 0)
+		return -1;
+
+	if (stats.ParsedBytes != source.size()) {
+		std::cout << "Wrong parsed bytes " << stats.ParsedBytes << std::endl;
+		return -1;
+	}
+
+	if (stats.TokenCount == 0 || stats.NodeAllocations == 0 || stats.PeakTreeMemory == 0) {
+		std::cout << "Parse counters not filled" << std::endl;
+		return -1;
+	}
+
+	// scene, two objects and the array. Expression arguments are built as well
+	if (stats.NodeCount[DL::DT_Group] != 4 || stats.NodeCount[DL::DT_String] != 1
+		|| stats.NodeCount[DL::DT_Float] != 1 || stats.NodeCount[DL::DT_Bool] != 3) {
+		std::cout << "Wrong node counts " << stats.toJson() << std::endl;
+		return -1;
+	}
+
+	auto it = stats.Expressions.find("if");
+	if (it == stats.Expressions.end() || it->second.Calls != 2) {
+		std::cout << "Expression not counted " << stats.toJson() << std::endl;
+		return -1;
+	}
+
+	std::stringstream stream;
+	DL::DataLisp::generate(container, stream, DL::GM_Compact, &stats);
+	if (stats.GeneratedBytes != stream.str().size()) {
+		std::cout << "Wrong generated bytes " << stats.GeneratedBytes << std::endl;
+		return -1;
+	}
+
+	// Recycled nodes are not allocated again
+	const DL::uint64 allocations = stats.NodeAllocations;
+	lisp.reset();
+	lisp.parse(source);
+	if (stats.NodeAllocations != allocations || stats.ParsedBytes != 2 * source.size()) {
+		std::cout << "Counters not accumulated " << stats.toJson() << std::endl;
+		return -1;
+	}
+
+	const std::string json = stats.toJson();
+	if (json.find("\"expressions\":{\"if\":{\"calls\":2,") == std::string::npos) {
+		std::cout << "Unexpected json " << json << std::endl;
+		return -1;
+	}
+
+	// Disabled statistics are left untouched
+	lisp.setStatistics(nullptr);
+	stats.reset();
+	lisp.reset();
+	lisp.parse(source);
+	lisp.build(container);
+	if (stats.TokenCount != 0 || stats.BuildTime != 0 || !stats.Expressions.empty())
+		return -1;
+
+	return 0;
+}